@@ -65,3 +65,12 @@ void get_battery_status_HAL(int *battery_voltage, int *battery_percentage, bool
     //*battery_ischarging = !digitalRead(CRG_STAT_GPIO);
   #endif
 }
+
+float get_battery_chargeRate_HAL(void) {
+  #if (OMOTE_HARDWARE_REV >= 4)
+    // the MAX17048 measures this itself, resolution is 0.208 %/h
+    return fuelGauge.getChangeRate();
+  #else
+    return NAN;
+  #endif
+}
@@ -2,3 +2,5 @@
 
 void init_battery_HAL(void);
 void get_battery_status_HAL(int *battery_voltage, int *battery_percentage, bool *battery_ischarging);
+// in % per hour, negative while discharging. NAN without fuel gauge (OMOTE_HARDWARE_REV <= 3).
+float get_battery_chargeRate_HAL(void);
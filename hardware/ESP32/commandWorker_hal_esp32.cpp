@@ -0,0 +1,42 @@
+#include <Arduino.h>
+#include "commandWorker_hal_esp32.h"
+
+// Enough for sending IR and BLE keyboard commands, including logging with printf
+const uint32_t COMMAND_WORKER_STACK_SIZE = 6144;
+// The Arduino loop() runs on core 1 with priority 1. The worker runs on the same core, but with a higher priority: when it is notified, it preempts
+// the loop and sends the IR code in one go. On core 0, the WiFi and BLE stacks could interrupt the sending and distort the timing of the IR code.
+// The loop keeps rendering and scanning keys while the worker waits, e.g. between two BLE keyboard reports.
+const BaseType_t COMMAND_WORKER_CORE = 1;
+const UBaseType_t COMMAND_WORKER_PRIORITY = 3;
+
+TaskHandle_t commandWorkerTaskHandle = NULL;
+tCommandWorker_cb thisCommandWorker_cb = NULL;
+tCommandWorkerHasCommands_cb thisCommandWorkerHasCommands_cb = NULL;
+
+void commandWorkerTask(void *parameter) {
+  while (true) {
+    // sleep until notified. Several notifications are merged into one, the callback executes all queued commands anyway.
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    thisCommandWorker_cb();
+  }
+}
+
+void start_commandWorker_HAL(tCommandWorker_cb pCommandWorker_cb, tCommandWorkerHasCommands_cb pCommandWorkerHasCommands_cb) {
+  if (commandWorkerTaskHandle != NULL) {
+    return;
+  }
+  thisCommandWorker_cb = pCommandWorker_cb;
+  thisCommandWorkerHasCommands_cb = pCommandWorkerHasCommands_cb;
+  xTaskCreatePinnedToCore(commandWorkerTask, "commandWorker", COMMAND_WORKER_STACK_SIZE, NULL, COMMAND_WORKER_PRIORITY, &commandWorkerTaskHandle, COMMAND_WORKER_CORE);
+}
+
+void notify_commandWorker_HAL(void) {
+  if (commandWorkerTaskHandle != NULL) {
+    xTaskNotifyGive(commandWorkerTaskHandle);
+  }
+}
+
+// A command is removed from the queue only after it was executed. So this is true while the worker sends, and while a command waits for the main loop.
+bool commandWorker_isBusy_HAL(void) {
+  return (thisCommandWorkerHasCommands_cb != NULL) && thisCommandWorkerHasCommands_cb();
+}
@@ -6,3 +6,15 @@ void get_heapUsage_HAL(unsigned long *heapSize, unsigned long *freeHeap, unsigne
   *maxAllocHeap = ESP.getMaxAllocHeap();
   *minFreeHeap = ESP.getMinFreeHeap();
 }
+
+// Large buffers (e.g. images of whole tabs) are put into PSRAM if the board has one, otherwise into the normal heap
+void* malloc_largeBuffer_HAL(size_t size) {
+  if (psramFound()) {
+    return ps_malloc(size);
+  }
+  return malloc(size);
+}
+
+void free_largeBuffer_HAL(void* buffer) {
+  free(buffer);
+}
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <string>
-#include <list>
+#include <stdint.h>
 
 // infrared
 void init_infraredSender_HAL(void);
-void sendIRcode_HAL(int protocol, std::list<std::string> commandPayloads, std::string additionalPayload);
\ No newline at end of file
+// IR codes are already parsed by the application, so the HAL only gets binary values
+void sendIRcode_HAL(int protocol, uint64_t data, uint16_t nbits, uint16_t repeat);
+void sendIRcodeGC_HAL(const uint16_t *timings, uint16_t timingsLength);
\ No newline at end of file
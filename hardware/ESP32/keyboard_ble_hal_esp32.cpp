@@ -2,50 +2,109 @@
 
 #include <nvs.h>
 #include <nvs_flash.h>
+#include <mutex>
+#include <atomic>
 
 #include "lib/ESP32-BLE-Keyboard/BleKeyboard.h"
 #include "battery_hal_esp32.h"
 #include "keyboard_ble_hal_esp32.h"
 
 BleKeyboard bleKeyboard("OMOTE Keyboard", "CoretechR");
+// Keyboard commands are sent by the command worker, pairing and advertising are done by the GUI, and the initialization by the deferredInit task.
+// With ENABLE_TASK_SPLIT=1 all of them are done by the connectivity task. BleKeyboard is not thread safe, so every call is done with this mutex.
+// isAdvertising() and isConnected() only read a flag and don't need it.
+std::mutex bleKeyboardMutex;
+// Set when bleKeyboard.begin() has returned, cleared by the shutdown. Before, NimBLE is not initialized and must not be called.
+// This can happen after a wakeup: the key that woke up the remote is executed as soon as the keys are initialized, which is before the deferred BLE init.
+// Such commands are dropped, like when no peer is connected.
+std::atomic<bool> bleKeyboardInitialized(false);
+
+// call with bleKeyboardMutex locked
+static bool bleKeyboardReady(const char *what) {
+  if (!bleKeyboardInitialized) {
+    Serial.printf("BLE keyboard not initialized yet, %s dropped\r\n", what);
+    return false;
+  }
+  return true;
+}
 
 void keyboardBLE_startAdvertisingForAll_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("startAdvertisingForAll")) {
+    return;
+  }
   bleKeyboard.startAdvertisingForAll();
 }
 
 void keyboardBLE_startAdvertisingWithWhitelist_HAL(std::string peersAllowed) {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("startAdvertisingWithWhitelist")) {
+    return;
+  }
   bleKeyboard.startAdvertisingWithWhitelist(peersAllowed);
 }
 
 void keyboardBLE_startAdvertisingDirected_HAL(std::string peerAddress, bool isRandomAddress) {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("startAdvertisingDirected")) {
+    return;
+  }
   bleKeyboard.startAdvertisingDirected(peerAddress, isRandomAddress);
 }
 
 void keyboardBLE_stopAdvertising_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("stopAdvertising")) {
+    return;
+  }
   bleKeyboard.stopAdvertising();
 }
 
 void keyboardBLE_printConnectedClients_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("printConnectedClients")) {
+    return;
+  }
   bleKeyboard.printConnectedClients();
 }
 
 void keyboardBLE_disconnectAllClients_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("disconnectAllClients")) {
+    return;
+  }
   bleKeyboard.disconnectAllClients();
 }
 
 void keyboardBLE_printBonds_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("printBonds")) {
+    return;
+  }
   bleKeyboard.printBonds();
 }
 
 std::string keyboardBLE_getBonds_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("getBonds")) {
+    return "";
+  }
   return bleKeyboard.getBonds();
 }
 
 void keyboardBLE_deleteBonds_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("deleteBonds")) {
+    return;
+  }
   bleKeyboard.deleteBonds();
 }
 
-bool keyboardBLE_forceConnectionToAddress_HAL(std::string peerAddress) {
+bool keyboardBLE_forceConnectionToAddress_HAL(const std::string &peerAddress) {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("forceConnectionToAddress")) {
+    return false;
+  }
   return bleKeyboard.forceConnectionToAddress(peerAddress);
 }
 
@@ -151,6 +210,7 @@ void delete_bonds_if_NimBLE_version_changed() {
 }
 
 void init_keyboardBLE_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
   delete_bonds_if_NimBLE_version_changed();
 
   int battery_voltage;
@@ -161,50 +221,94 @@ void init_keyboardBLE_HAL() {
   bleKeyboard.set_BLEKeyboardMessage_cb(&keyboardBLE_BLEkeyboardMessage_cb);
   bleKeyboard.setBatteryLevel(battery_percentage);
   bleKeyboard.begin();
+  bleKeyboardInitialized = true;
   // In case only one peer is bonded, startAdvertisingForAll() is called on initialisation
   bleKeyboard.startAdvertisingIfExactlyOneBondExists();
 }
 
 bool keyboardBLE_isAdvertising_HAL() {
-  return bleKeyboard.isAdvertising();
+  return bleKeyboardInitialized && bleKeyboard.isAdvertising();
 }
 
 bool keyboardBLE_isConnected_HAL() {
-  return bleKeyboard.isConnected();
+  return bleKeyboardInitialized && bleKeyboard.isConnected();
 }
 
 void keyboardBLE_shutdown_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardInitialized) {
+    return;
+  }
+  bleKeyboardInitialized = false;
   bleKeyboard.end();
 }
     
 void keyboardBLE_write_HAL(uint8_t c) {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("write")) {
+    return;
+  }
   bleKeyboard.write(c);
 }
 
 void keyboardBLE_longpress_HAL(uint8_t c) {
-  bleKeyboard.press(c);
+  {
+    std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+    if (!bleKeyboardReady("longpress")) {
+      return;
+    }
+    bleKeyboard.press(c);
+  }
+  // without the mutex, so that the GUI can still use the keyboard
   delay(1000);
-  bleKeyboard.release(c);
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  // the keyboard could have been shut down in the meantime
+  if (bleKeyboardInitialized) {
+    bleKeyboard.release(c);
+  }
 }
 
 void keyboardBLE_home_HAL() {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("home")) {
+    return;
+  }
   bleKeyboard.press(KEY_LEFT_ALT);
   bleKeyboard.press(KEY_ESC);
   bleKeyboard.releaseAll();
 }
 
 void keyboardBLE_sendString_HAL(const std::string &s) {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("sendString")) {
+    return;
+  }
   bleKeyboard.print(s.c_str());
 }
 
 void consumerControlBLE_write_HAL(const MediaKeyReport value) {
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  if (!bleKeyboardReady("consumer control write")) {
+    return;
+  }
   bleKeyboard.write(value);
 }
 
 void consumerControlBLE_longpress_HAL(const MediaKeyReport value) {
-  bleKeyboard.press(value);
+  {
+    std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+    if (!bleKeyboardReady("consumer control longpress")) {
+      return;
+    }
+    bleKeyboard.press(value);
+  }
+  // without the mutex, so that the GUI can still use the keyboard
   delay(1000);
-  bleKeyboard.release(value);
+  std::lock_guard<std::mutex> lock(bleKeyboardMutex);
+  // the keyboard could have been shut down in the meantime
+  if (bleKeyboardInitialized) {
+    bleKeyboard.release(value);
+  }
 }
 
 #endif
@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include "driver/ledc.h"
+#include "driver/gpio.h"
 #include "keypad_keys_hal_esp32.h"
 #if(OMOTE_HARDWARE_REV >= 5)
   #include <Adafruit_TCA8418.h>
@@ -7,16 +8,15 @@
   #include "lib/Keypad/src/Keypad.h" // modified for inverted logic
 #endif
 #include "sleep_hal_esp32.h"
+#include "ledFade_hal_esp32.h"
 
-// has to be exactly the same structure as in hardwarePresenter.h
 const uint8_t keypadROWS = 5; //five rows
 const uint8_t keypadCOLS = 5; //five columns
-enum keypad_rawKeyStates {IDLE_RAW, PRESSED_RAW,       RELEASED_RAW};
-struct rawKey {
-  unsigned long timestampReceived;
-  char keyChar;
-  keypad_rawKeyStates rawKeyState;
-};
+
+tAnnounceKeypadEvent_cb thisAnnounceKeypadEvent_cb = NULL;
+void set_announceKeypadEvent_cb_HAL(tAnnounceKeypadEvent_cb pAnnounceKeypadEvent_cb) {
+  thisAnnounceKeypadEvent_cb = pAnnounceKeypadEvent_cb;
+}
 
 #if(OMOTE_HARDWARE_REV >= 5)
 const uint8_t TCA_INT_GPIO = 8;
@@ -25,6 +25,26 @@ const uint64_t BUTTON_PIN_BITMASK = 0b0000000000000000000000000000000100000100;
 
 Adafruit_TCA8418 keypad;
 byte keyboardBrightness = 255;
+// fade time when the brightness changes. After boot or wakeup, fade in lasts for <keyboardBrightness> ms.
+#define KEYBOARD_FADE_TIME_MS 200
+
+// The TCA8418 pulls its INT line low as soon as it has captured an event in its FIFO.
+// The ISR only takes the time of the first event, the events themselves are read over I2C in keys_getEvents_HAL(), because I2C cannot be used in an ISR.
+// INT stays low until all events are read, so there is no interrupt for the events after the first one. They get the time they are read instead,
+// which is later than the time they were captured by at most the time between two calls of keys_getEvents_HAL().
+volatile bool keypadInterruptPending = false;
+volatile unsigned long keypadInterruptTimestamp = 0;
+void IRAM_ATTR keypad_ISR() {
+  if (!keypadInterruptPending) {
+    keypadInterruptTimestamp = millis();
+    keypadInterruptPending = true;
+  }
+  // the keypad task has no deadline while all keys are idle, loop() may be blocking in idle_HAL()
+  wakeIdleFromISR_HAL();
+}
+
+// The TCA8418 keeps scanning in deep sleep. After a wakeup by the keypad, the events of the key that woke up the remote are still in its FIFO.
+bool wakeupKeyInFIFO = false;
 
 char keypadChars[keypadROWS][keypadCOLS] = {
   {'?','p','c','<','='},  //       ?,     play,  config, rewind,   stop
@@ -60,6 +80,15 @@ char hexaKeys[keypadROWS][keypadCOLS] = {
 byte rowPins[keypadROWS] = {SW_A_GPIO, SW_B_GPIO, SW_C_GPIO, SW_D_GPIO, SW_E_GPIO}; //connect to the row pinouts of the keypad
 byte colPins[keypadCOLS] = {SW_1_GPIO, SW_2_GPIO, SW_3_GPIO, SW_4_GPIO, SW_5_GPIO}; //connect to the column pinouts of the keypad
 Keypad customKeypad = Keypad( makeKeymap(hexaKeys), rowPins, colPins, keypadROWS, keypadCOLS); 
+
+// The key matrix only keeps a key as long as it is pressed. The key that woke up the remote is scanned in keys_captureWakeupKey_HAL() and announced later.
+struct wakeupKey {
+  uint8_t row;
+  uint8_t col;
+  char keyChar;
+};
+wakeupKey wakeupKeys[LIST_MAX];
+uint8_t wakeupKeyCount = 0;
 #endif
 
 /*
@@ -91,14 +120,19 @@ void init_keys_HAL(void) {
   keypad.pinMode(13, INPUT); // USB_3V3
 
   pinMode(TCA_INT_GPIO, INPUT);
-  keypad.flush();
+  // Keep the key that woke up the remote, keys_getEvents_HAL() reads it as soon as the main loop runs
+  if (!wakeupKeyInFIFO) {
+    keypad.flush();
+  }
   keypad.writeRegister(TCA8418_REG_CFG, 0b00000001);
   keypad.writeRegister(TCA8418_REG_GPI_EM_1, 0b00111111);
   keypad.writeRegister(TCA8418_REG_GPI_EM_2, 0b00011111); // disable interrupt for COL5 (USB_3V3)
+  attachInterrupt(digitalPinToInterrupt(TCA_INT_GPIO), keypad_ISR, FALLING);
   
   ledcSetup(LEDC_CHANNEL_6, 5000, 8);
   ledcAttachPin(KBD_BL_GPIO, LEDC_CHANNEL_6);
   ledcWrite(LEDC_CHANNEL_6, 0);
+  init_ledFade_HAL();
 
   #else
   // Button Pin Definition
@@ -115,49 +149,56 @@ void init_keys_HAL(void) {
   #endif
 }
 
-void keys_getKeys_HAL(void* ptr, unsigned long currentMillis) {
-
-  rawKey (*rawKeys)[keypadCOLS] = static_cast<rawKey (*)[keypadCOLS]>(ptr);
+void keys_getEvents_HAL(unsigned long currentMillis) {
 
   #if(OMOTE_HARDWARE_REV >= 5)
-    byte row = 0;
-    byte col = 0;
-    int keyCode = 0;
-    keypad_rawKeyStates rawKeyState = IDLE_RAW;
+    // Nothing happened since the last call, so don't touch the I2C bus at all.
+    // INT stays low as long as the TCA8418 has pending events. Checking it too catches an edge that was missed, e.g. one from before the wakeup.
+    if (!keypadInterruptPending && (digitalRead(TCA_INT_GPIO) == HIGH)) {return;}
+
+    // only the first event was captured at the time of the interrupt, see keypad_ISR()
+    unsigned long timestamp = keypadInterruptPending ? keypadInterruptTimestamp : currentMillis;
+    // reset before reading the events, so that an interrupt while reading is not lost
+    keypadInterruptPending = false;
 
     // https://github.com/adafruit/Adafruit_TCA8418/blob/main/examples/tca8418_keypad_gpio_interrupt/tca8418_keypad_gpio_interrupt.ino
     int intStat = keypad.readRegister(TCA8418_REG_INT_STAT);
     if (intStat & 0x01) // Byte 0: K_INT (keyboard interrupt)
     {
-      // datasheet page 16 - Table 2
-      keyCode = keypad.getEvent();
-      if (keyCode & 0x80) rawKeyState = PRESSED_RAW;
-      else rawKeyState = RELEASED_RAW;
-      // if (keyCode & 0x80) Serial.print("PRESS\t ");
-      // else Serial.print("RELEASE\t ");
-      //  map keyCode to GPIO nr.
-      keyCode &= 0x7F;
-
-      if (keyCode > 96)  //  GPIO
-      {
-        // process gpio
-        keyCode -= 97;
-        // this only happens for key 'o' (off). Map this to 1/1
-        row = 1;
-        col = 1;
-        // Serial.print(keyCode);
-        // Serial.println();
-      }
-      else
-      {
-        // process matrix
-        keyCode--;
-        row = keyCode / 10;
-        col = keyCode % 10;
-        //Serial.print(keyCode / 10);
-        //Serial.print("\t ");
-        //Serial.print(keyCode % 10);
-        //Serial.println();
+      // read all events from the FIFO of the TCA8418 (up to 10) at once
+      uint8_t eventCount = keypad.available();
+      for (uint8_t i = 0; i < eventCount; i++) {
+        byte row = 0;
+        byte col = 0;
+        // datasheet page 16 - Table 2
+        int keyCode = keypad.getEvent();
+        if (keyCode == 0) break;
+        bool pressed = (keyCode & 0x80);
+        //  map keyCode to GPIO nr.
+        keyCode &= 0x7F;
+
+        if (keyCode > 96)  //  GPIO
+        {
+          // process gpio
+          keyCode -= 97;
+          // this only happens for key 'o' (off). Map this to 1/1
+          row = 1;
+          col = 1;
+        }
+        else
+        {
+          // process matrix
+          keyCode--;
+          row = keyCode / 10;
+          col = keyCode % 10;
+        }
+
+        setLastActivityTimestamp_HAL();
+        // Serial.printf("esp32 TCA8418 event: %c, %d %d, %d\r\n", keypadChars[row][col], row, col, pressed);
+        if (thisAnnounceKeypadEvent_cb != NULL) {
+          thisAnnounceKeypadEvent_cb(timestamp, row, col, keypadChars[row][col], pressed);
+        }
+        timestamp = millis();
       }
 
       //  clear the EVENT IRQ flag
@@ -175,26 +216,16 @@ void keys_getKeys_HAL(void* ptr, unsigned long currentMillis) {
       keypad.writeRegister(TCA8418_REG_INT_STAT, 2);
     }
 
-    //  check pending events
-    int intstat = keypad.readRegister(TCA8418_REG_INT_STAT);
-
-    if (rawKeyState == IDLE_RAW) {return;}
-
-    rawKeys[row][col].timestampReceived = currentMillis;
-
-    rawKeys[row][col].keyChar = keypadChars[row][col];
-    if (rawKeyState == PRESSED_RAW) {
-      rawKeys[row][col].rawKeyState = PRESSED_RAW;
-      setLastActivityTimestamp_HAL();
+  #else
 
-    } else if (rawKeyState == RELEASED_RAW) {
-      rawKeys[row][col].rawKeyState = RELEASED_RAW;
+    // the key that woke up the remote. It is announced with the current time, as if it had just been pressed. Otherwise it would already count as HOLD.
+    for (uint8_t i = 0; i < wakeupKeyCount; i++) {
       setLastActivityTimestamp_HAL();
+      if (thisAnnounceKeypadEvent_cb != NULL) {
+        thisAnnounceKeypadEvent_cb(currentMillis, wakeupKeys[i].row, wakeupKeys[i].col, wakeupKeys[i].keyChar, true);
+      }
     }
-
-    // Serial.printf("esp32 TCA8418 event: %c, %d %d, %d\r\n", keypadChars[row][col], row, col, rawKeyState);
-
-  #else
+    wakeupKeyCount = 0;
 
     // Only the current keypad state will be returned by the keypad library. If a key has been pressed and already been released between two calls, the key is lost.
     // But if a keypress has been started (PRESS has been received), all further events for this key will be provided, no following event is missed.
@@ -203,45 +234,85 @@ void keys_getKeys_HAL(void* ptr, unsigned long currentMillis) {
     uint8_t col;
     for(int i=0; i < LIST_MAX; i++) {
       if (!customKeypad.key[i].stateChanged) continue;
+      if ((customKeypad.key[i].kstate != PRESSED) && (customKeypad.key[i].kstate != RELEASED)) continue;
 
       // get the row and col for this key
       row = customKeypad.key[i].kcode / keypadROWS;
       col = customKeypad.key[i].kcode % keypadCOLS;
-    
-      rawKeys[row][col].timestampReceived = currentMillis;
-      rawKeys[row][col].keyChar = customKeypad.key[i].kchar;
-      if (customKeypad.key[i].kstate == PRESSED) {
-        rawKeys[row][col].rawKeyState = PRESSED_RAW;
-        setLastActivityTimestamp_HAL();
-    
-      } else if (customKeypad.key[i].kstate == RELEASED) {
-        rawKeys[row][col].rawKeyState = RELEASED_RAW;
-        setLastActivityTimestamp_HAL();
+
+      setLastActivityTimestamp_HAL();
+      // Serial.printf("esp32 keypad event for key %d: %c, %d %d, %d\r\n", i, customKeypad.key[i].kchar, row, col, customKeypad.key[i].kstate);
+      if (thisAnnounceKeypadEvent_cb != NULL) {
+        thisAnnounceKeypadEvent_cb(currentMillis, row, col, customKeypad.key[i].kchar, customKeypad.key[i].kstate == PRESSED);
       }
-      // Serial.printf("esp32 keypad event for key %d: %c, %d %d, %d\r\n", i, rawKeys[row][col].keyChar, row, col, customKeypad.key[i].kstate);
     }
   #endif
 }
 
-#if(OMOTE_HARDWARE_REV >= 5)
-void update_keyboardBrightness_HAL(void) {
-  // A variable declared static inside a function is visible only inside that function, exists only once (not created/destroyed for each call) and is permanent. It is in a sense a private global variable.
-  static int fadeInTimer = millis(); // fadeInTimer = time after setup
-  if (millis() < fadeInTimer + keyboardBrightness) {
-    // after boot or wakeup, fade in keyboard brightness
-    // fade in lasts for <keyboardBrightness> ms
-    ledcWrite(LEDC_CHANNEL_6, millis() - fadeInTimer);
-  }
-  else {
-    // normal mode, set full keyboardBrightness    
-    // turn off PWM if keyboard is at full brightness
-    if(keyboardBrightness < 255){
-      ledcWrite(LEDC_CHANNEL_6, keyboardBrightness);
+void keys_captureWakeupKey_HAL(uint64_t ext1WakeupStatus) {
+  #if(OMOTE_HARDWARE_REV >= 5)
+    // I2C is not powered yet. Nothing to do now, the FIFO of the TCA8418 keeps the key until it is read.
+    wakeupKeyInFIFO = true;
+  #else
+    // Scan right now. init_keys_HAL() comes after init_gui(), a short press would already be over by then.
+    // The Keypad library then knows the key as PRESSED and reports its release as usual.
+    if (customKeypad.getKeys()) {
+      for (int i = 0; i < LIST_MAX; i++) {
+        if (!customKeypad.key[i].stateChanged || (customKeypad.key[i].kstate != PRESSED)) continue;
+        wakeupKeys[wakeupKeyCount].row = customKeypad.key[i].kcode / keypadROWS;
+        wakeupKeys[wakeupKeyCount].col = customKeypad.key[i].kcode % keypadCOLS;
+        wakeupKeys[wakeupKeyCount].keyChar = customKeypad.key[i].kchar;
+        Serial.printf("wakeup by key '%c'\r\n", wakeupKeys[wakeupKeyCount].keyChar);
+        wakeupKeyCount++;
+      }
     }
-    else{
-      ledc_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_6, 255);
+    if (wakeupKeyCount == 0) {
+      // ext1 only tells the row, the column is unknown
+      Serial.printf("wakeup by keypad (GPIOs 0x%llx), but the key was already released\r\n", (unsigned long long)ext1WakeupStatus);
     }
-  }
+  #endif
+}
+
+bool keys_canSignalEvents_HAL(void) {
+  #if(OMOTE_HARDWARE_REV >= 5)
+    return true;
+  #else
+    // the key matrix has to be scanned
+    return false;
+  #endif
+}
+
+bool keys_isEventPending_HAL(void) {
+  #if(OMOTE_HARDWARE_REV >= 5)
+    return keypadInterruptPending || (digitalRead(TCA_INT_GPIO) == LOW);
+  #else
+    return true;
+  #endif
+}
+
+void keys_enableLightSleepWakeup_HAL(void) {
+  #if(OMOTE_HARDWARE_REV >= 5)
+    // GPIO wakeup only works with level triggers. The ISR must not see the level trigger, it would fire as long as INT is low.
+    gpio_intr_disable((gpio_num_t)TCA_INT_GPIO);
+    gpio_wakeup_enable((gpio_num_t)TCA_INT_GPIO, GPIO_INTR_LOW_LEVEL);
+  #endif
+}
+
+void keys_disableLightSleepWakeup_HAL(void) {
+  #if(OMOTE_HARDWARE_REV >= 5)
+    gpio_wakeup_disable((gpio_num_t)TCA_INT_GPIO);
+    // same as attachInterrupt(..., FALLING) in init_keys_HAL(). A press during light sleep is still in the FIFO of the TCA8418 and keeps INT low, keys_isEventPending_HAL() sees it.
+    gpio_set_intr_type((gpio_num_t)TCA_INT_GPIO, GPIO_INTR_NEGEDGE);
+    gpio_intr_enable((gpio_num_t)TCA_INT_GPIO);
+  #endif
+}
+
+#if(OMOTE_HARDWARE_REV >= 5)
+// Only sets the target of the keyboard backlight. The fade itself is done by the LEDC hardware.
+void update_keyboardBrightness_HAL(void) {
+  // after boot or wakeup, fade in from dark lasts for <keyboardBrightness> ms
+  uint32_t fadeTime = (ledFade_getTarget_HAL(LEDFADE_CHANNEL_KEYBOARD) == 0) ? keyboardBrightness : KEYBOARD_FADE_TIME_MS;
+  ledFade_setTarget_HAL(LEDFADE_CHANNEL_KEYBOARD, keyboardBrightness, fadeTime);
 }
 
 uint8_t get_keyboardBrightness_HAL() {
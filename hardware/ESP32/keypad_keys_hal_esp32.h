@@ -17,7 +17,22 @@
 extern const uint64_t BUTTON_PIN_BITMASK;
 
 void init_keys_HAL(void);
-void keys_getKeys_HAL(void* ptr, unsigned long currentMillis);
+// Reads all new keypad events from the hardware and announces each of them with the time it was captured.
+// OMOTE_HARDWARE_REV >= 5: exact only for the first event after an interrupt of the TCA8418. The events read together with it get the time they were read.
+void keys_getEvents_HAL(unsigned long currentMillis);
+typedef void (*tAnnounceKeypadEvent_cb)(unsigned long timestamp, uint8_t row, uint8_t col, char keyChar, bool pressed);
+void set_announceKeypadEvent_cb_HAL(tAnnounceKeypadEvent_cb pAnnounceKeypadEvent_cb);
+// called by init_sleep_HAL() after a wakeup by the keypad, with the GPIOs that woke up the remote.
+// The key that woke up the remote is announced by the first keys_getEvents_HAL(), so that it is executed like any other key press as soon as setup() is finished.
+void keys_captureWakeupKey_HAL(uint64_t ext1WakeupStatus);
+// true if the hardware tells when there are new events (TCA8418). Otherwise the keypad has to be polled.
+bool keys_canSignalEvents_HAL(void);
+// true if keys_getEvents_HAL() would get new events. Always true if the keypad has to be polled.
+bool keys_isEventPending_HAL(void);
+
+// called from the HAL, around light sleep. Only the TCA8418 can wake up from light sleep, the key matrix is polled.
+void keys_enableLightSleepWakeup_HAL(void);
+void keys_disableLightSleepWakeup_HAL(void);
 
 #if(OMOTE_HARDWARE_REV >= 5)
     // called from the HAL
@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include "driver/ledc.h"
+#include "ledFade_hal_esp32.h"
+
+struct t_ledFadeChannel {
+  ledc_mode_t speedMode;
+  ledc_channel_t channel;
+  uint8_t targetDuty;
+  unsigned long fadeEnd;
+  // at full duty, PWM is turned off
+  bool pwmStopped;
+};
+t_ledFadeChannel ledFadeChannels[] = {
+  {LEDC_SPEED_MODE,     LEDC_CHANNEL_5, 0, 0, false}, // LEDFADE_CHANNEL_BACKLIGHT
+  {LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_6, 0, 0, false}, // LEDFADE_CHANNEL_KEYBOARD
+};
+const uint8_t ledFadeChannelCount = sizeof(ledFadeChannels) / sizeof(ledFadeChannels[0]);
+
+void init_ledFade_HAL(void) {
+  static bool isInstalled = false;
+  if (isInstalled) {
+    return;
+  }
+  esp_err_t err = ledc_fade_func_install(0);
+  if (err != ESP_OK) {
+    Serial.printf("Error when calling ledc_fade_func_install: %d\r\n", err);
+    return;
+  }
+  isInstalled = true;
+}
+
+void ledFade_setTarget_HAL(uint8_t fadeChannel, uint8_t targetDuty, uint32_t fadeTime_ms) {
+  if (fadeChannel >= ledFadeChannelCount) {
+    return;
+  }
+  t_ledFadeChannel *ch = &ledFadeChannels[fadeChannel];
+  // a new fade would have to wait until the running one has ended. Never block, simply try again later.
+  bool isFading = (long)(millis() - ch->fadeEnd) < 0;
+
+  if (targetDuty == ch->targetDuty) {
+    if ((targetDuty == 255) && !isFading && !ch->pwmStopped) {
+      // turn off PWM if at full brightness
+      ledc_stop(ch->speedMode, ch->channel, 255);
+      ch->pwmStopped = true;
+    }
+    return;
+  }
+  if (isFading) {
+    return;
+  }
+
+  if (fadeTime_ms == 0) {
+    ledc_set_duty_and_update(ch->speedMode, ch->channel, targetDuty, 0);
+  } else {
+    ledc_set_fade_time_and_start(ch->speedMode, ch->channel, targetDuty, fadeTime_ms, LEDC_FADE_NO_WAIT);
+  }
+  ch->targetDuty = targetDuty;
+  ch->fadeEnd = millis() + fadeTime_ms;
+  ch->pwmStopped = false;
+}
+
+uint8_t ledFade_getTarget_HAL(uint8_t fadeChannel) {
+  if (fadeChannel >= ledFadeChannelCount) {
+    return 0;
+  }
+  return ledFadeChannels[fadeChannel].targetDuty;
+}
+
+bool ledFade_isStatic_HAL(void) {
+  for (uint8_t i = 0; i < ledFadeChannelCount; i++) {
+    t_ledFadeChannel *ch = &ledFadeChannels[i];
+    if ((long)(millis() - ch->fadeEnd) < 0) {
+      return false;
+    }
+    // duty 0 is constantly low, at full duty PWM is stopped. Everything in between needs the LEDC clock.
+    if ((ch->targetDuty != 0) && !ch->pwmStopped) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include "driver/ledc.h"
+
+// The ESP32 can only do LOW_SPEED_MODE
+#if(OMOTE_HARDWARE_REV >= 5)
+#define LEDC_SPEED_MODE LEDC_LOW_SPEED_MODE
+#else
+#define LEDC_SPEED_MODE LEDC_HIGH_SPEED_MODE
+#endif
+
+// Fade engine for the display and keyboard backlight.
+// A fade runs in the LEDC hardware, the CPU is only needed to start it.
+#define LEDFADE_CHANNEL_BACKLIGHT 0
+#define LEDFADE_CHANNEL_KEYBOARD  1
+
+// called from the HAL, after the LEDC channels are configured
+void init_ledFade_HAL(void);
+// Fades the channel from its current duty to targetDuty in fadeTime_ms. Does nothing if this is already the target.
+// If the channel is still fading to another target, the new target is ignored. Call it again later, e.g. on every update.
+void ledFade_setTarget_HAL(uint8_t fadeChannel, uint8_t targetDuty, uint32_t fadeTime_ms);
+// the duty the channel is fading to, or has reached
+uint8_t ledFade_getTarget_HAL(uint8_t fadeChannel);
+// true if no channel is fading and all channels are either off or at full duty. Only then the outputs keep their level in light sleep.
+bool ledFade_isStatic_HAL(void);
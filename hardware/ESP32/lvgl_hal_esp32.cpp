@@ -1,28 +1,131 @@
 #include <lvgl.h>
 #include "tft_hal_esp32.h"
 #include "sleep_hal_esp32.h"
+#include "lvgl_hal_esp32.h"
+#if(OMOTE_HARDWARE_REV >= 5)
+#include "esp32s3/rom/cache.h"
+#endif
 
 // -----------------------
 // https://docs.lvgl.io/8.3/porting/display.html?highlight=lv_disp_draw_buf_init#buffering-modes
-// With two buffers, the rendering and refreshing of the display become parallel operations
+// With two buffers, the rendering and refreshing of the display become parallel operations:
+// lvgl renders the next band into one buffer while the other one is sent to the display via DMA.
 // Second buffer needs 15.360 bytes more memory in heap.
 #define useTwoBuffersForlvgl
 
+// Size of each draw buffer as fraction of the screen. With 10, a full screen swipe needs ten render and flush rounds per frame.
+// Larger buffers (2: half screen, 1: full screen) need fewer rounds, but only fit into PSRAM (rev5). Can be set in platformio.ini.
+#ifndef LVGL_DRAW_BUFFER_DIVIDER
+#define LVGL_DRAW_BUFFER_DIVIDER 10
+#endif
+// Merge nearby dirty areas of a frame, so that fewer but larger areas are rendered and sent. More pixels are sent in exchange.
+// Off by default: it was not measured on hardware yet whether this is faster. Compare with the swipe log of guiBase.cpp.
+#ifndef LVGL_MERGE_DIRTY_AREAS
+#define LVGL_MERGE_DIRTY_AREAS 0
+#endif
+// true if the draw buffers could be allocated in PSRAM. Then the cache has to be written back before the DMA reads the buffer.
+bool drawBuffersInPSRAM = false;
+
+tAnnounceFrameTiming_cb thisAnnounceFrameTiming_cb = NULL;
+void set_announceFrameTiming_cb_HAL(tAnnounceFrameTiming_cb pAnnounceFrameTiming_cb) {
+  thisAnnounceFrameTiming_cb = pAnnounceFrameTiming_cb;
+}
+
+// timing of the frame currently refreshed
+unsigned long frameStart_us = 0;
+unsigned long frameFlush_us = 0;
+uint32_t framePixels = 0;
+
+#if (LVGL_MERGE_DIRTY_AREAS != 0)
+// Each area has a fixed cost, e.g. the redraw of the background below it and setting the address window of the display.
+// Two areas are merged into their bounding box if it has at most this many pixels more than both areas together. 8 lines is a guess, not tuned on hardware.
+#define DIRTY_AREA_MERGE_EXTRA_PIXELS (SCR_WIDTH * 8)
+
+// lvgl itself only joins areas if their bounding box is smaller than both areas together.
+// The merged area is always kept at the higher index, because lvgl has already determined the last area of the frame.
+void merge_dirty_areas(lv_disp_t *disp) {
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (int i = 0; i < disp->inv_p; i++) {
+      if (disp->inv_area_joined[i]) {continue;}
+      for (int j = i + 1; j < disp->inv_p; j++) {
+        if (disp->inv_area_joined[j]) {continue;}
+        lv_area_t boundingBox;
+        boundingBox.x1 = LV_MIN(disp->inv_areas[i].x1, disp->inv_areas[j].x1);
+        boundingBox.y1 = LV_MIN(disp->inv_areas[i].y1, disp->inv_areas[j].y1);
+        boundingBox.x2 = LV_MAX(disp->inv_areas[i].x2, disp->inv_areas[j].x2);
+        boundingBox.y2 = LV_MAX(disp->inv_areas[i].y2, disp->inv_areas[j].y2);
+        if (lv_area_get_size(&boundingBox) <= lv_area_get_size(&disp->inv_areas[i]) + lv_area_get_size(&disp->inv_areas[j]) + DIRTY_AREA_MERGE_EXTRA_PIXELS) {
+          disp->inv_areas[j] = boundingBox;
+          disp->inv_area_joined[i] = 1;
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+}
+#endif
+
+void my_render_start(lv_disp_drv_t *disp) {
+  #if (LVGL_MERGE_DIRTY_AREAS != 0)
+  merge_dirty_areas(_lv_refr_get_disp_refreshing());
+  #endif
+  frameStart_us = micros();
+  frameFlush_us = 0;
+  framePixels = 0;
+}
+
 // Display flushing
+// The DMA transfer is only started here. LovyanGFX has no callback when a DMA transfer is finished, so lvgl is told that the flush is ready
+// when it needs the buffer again (my_disp_wait). Only the last band of a frame is waited for here, so that the bus is released between two frames.
 void my_disp_flush( lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p ){
+  unsigned long flushStart_us = micros();
   uint32_t w = ( area->x2 - area->x1 + 1 );
   uint32_t h = ( area->y2 - area->y1 + 1 );
+  framePixels += w * h;
 
-  tft.startWrite();
+  // keep the bus until the last band of the frame was sent
+  if (tft.getStartCount() == 0) {
+    tft.startWrite();
+  }
+  #if(OMOTE_HARDWARE_REV >= 5)
+  if (drawBuffersInPSRAM) {
+    // the DMA reads directly from PSRAM, not from the cache
+    Cache_WriteBack_Addr((uint32_t)color_p, w * h * sizeof(lv_color_t));
+  }
+  #endif
+  // waits until the DMA transfer of the previous band is finished
   tft.setAddrWindow(area->x1, area->y1, w, h);
   #ifdef useTwoBuffersForlvgl
   tft.pushPixelsDMA((uint16_t*)&color_p->full, w * h);
   #else
   tft.pushColors((uint16_t*)&color_p->full, w * h, true);
   #endif
-  tft.endWrite();
 
+  if (lv_disp_flush_is_last(disp)) {
+    tft.waitDMA();
+    tft.endWrite();
+    lv_disp_flush_ready( disp );
+    frameFlush_us += micros() - flushStart_us;
+    if (thisAnnounceFrameTiming_cb != NULL) {
+      thisAnnounceFrameTiming_cb(micros() - frameStart_us - frameFlush_us, frameFlush_us, framePixels);
+    }
+  } else {
+    #ifndef useTwoBuffersForlvgl
+    lv_disp_flush_ready( disp );
+    #endif
+    frameFlush_us += micros() - flushStart_us;
+  }
+}
+
+// Called by lvgl as long as the buffer it wants to use is still being sent to the display
+void my_disp_wait(lv_disp_drv_t *disp) {
+  unsigned long waitStart_us = micros();
+  tft.waitDMA();
   lv_disp_flush_ready( disp );
+  frameFlush_us += micros() - waitStart_us;
 }
 
 // Read the touchpad
@@ -49,9 +152,29 @@ void init_lvgl_HAL() {
   init_tft();
 
   #ifdef useTwoBuffersForlvgl
-  lv_color_t * bufA = (lv_color_t *) malloc(sizeof(lv_color_t) * SCR_WIDTH * SCR_HEIGHT / 10);
-  lv_color_t * bufB = (lv_color_t *) malloc(sizeof(lv_color_t) * SCR_WIDTH * SCR_HEIGHT / 10);
-  lv_disp_draw_buf_init(&draw_buf, bufA, bufB, SCR_WIDTH * SCR_HEIGHT / 10);
+  uint32_t bufferSize = SCR_WIDTH * SCR_HEIGHT / LVGL_DRAW_BUFFER_DIVIDER;
+  lv_color_t * bufA = NULL;
+  lv_color_t * bufB = NULL;
+  #if(OMOTE_HARDWARE_REV >= 5)
+  if ((LVGL_DRAW_BUFFER_DIVIDER < 10) && psramFound()) {
+    // the GDMA of the ESP32-S3 can read from PSRAM
+    bufA = (lv_color_t *) heap_caps_malloc(sizeof(lv_color_t) * bufferSize, MALLOC_CAP_SPIRAM);
+    bufB = (lv_color_t *) heap_caps_malloc(sizeof(lv_color_t) * bufferSize, MALLOC_CAP_SPIRAM);
+    drawBuffersInPSRAM = (bufA != NULL) && (bufB != NULL);
+  }
+  #endif
+  if (!drawBuffersInPSRAM) {
+    if (bufferSize > SCR_WIDTH * SCR_HEIGHT / 10) {
+      Serial.printf("Draw buffers of 1/%d screen need PSRAM, will use 1/10 screen\r\n", LVGL_DRAW_BUFFER_DIVIDER);
+      bufferSize = SCR_WIDTH * SCR_HEIGHT / 10;
+    }
+    free(bufA);
+    free(bufB);
+    // the buffers are read by DMA, so they have to be in internal memory
+    bufA = (lv_color_t *) heap_caps_malloc(sizeof(lv_color_t) * bufferSize, MALLOC_CAP_DMA);
+    bufB = (lv_color_t *) heap_caps_malloc(sizeof(lv_color_t) * bufferSize, MALLOC_CAP_DMA);
+  }
+  lv_disp_draw_buf_init(&draw_buf, bufA, bufB, bufferSize);
   #else
   lv_color_t * bufA = (lv_color_t *) malloc(sizeof(lv_color_t) * SCR_WIDTH * SCR_HEIGHT / 10);
   lv_disp_draw_buf_init(&draw_buf, bufA, NULL, SCR_WIDTH * SCR_HEIGHT / 10);
@@ -63,6 +186,8 @@ void init_lvgl_HAL() {
   disp_drv.hor_res = SCR_WIDTH;
   disp_drv.ver_res = SCR_HEIGHT;
   disp_drv.flush_cb = my_disp_flush;
+  disp_drv.wait_cb = my_disp_wait;
+  disp_drv.render_start_cb = my_render_start;
   disp_drv.draw_buf = &draw_buf;
   lv_disp_drv_register( &disp_drv );
 
@@ -26,6 +26,11 @@ bool getIsWifiConnected_HAL() {
   return isWifiConnected;
 }
 
+// Channel and access point of the last connection. Kept in RTC memory over deep sleep, so that the reconnect after wakeup can skip the scan.
+RTC_DATA_ATTR bool wifiLastConnectionValid = false;
+RTC_DATA_ATTR int32_t wifiLastConnectionChannel;
+RTC_DATA_ATTR uint8_t wifiLastConnectionBSSID[6];
+
 // WiFi status event
 void WiFiEvent(WiFiEvent_t event){
   //Serial.printf("[WiFi-event] event: %d\r\n", event);
@@ -39,11 +44,16 @@ void WiFiEvent(WiFiEvent_t event){
   // Set status bar icon based on WiFi status
   if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP || event == ARDUINO_EVENT_WIFI_STA_GOT_IP6) {
     isWifiConnected = true;
+    wifiLastConnectionChannel = WiFi.channel();
+    memcpy(wifiLastConnectionBSSID, WiFi.BSSID(), sizeof(wifiLastConnectionBSSID));
+    wifiLastConnectionValid = true;
     thisAnnounceWiFiconnected_cb(true);
     Serial.printf("WiFi connected, IP address: %s\r\n", WiFi.localIP().toString().c_str());
 
   } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
     isWifiConnected = false;
+    // the access point might have changed, scan again
+    wifiLastConnectionValid = false;
     thisAnnounceWiFiconnected_cb(false);
     // automatically try to reconnect
     Serial.printf("WiFi got disconnected. Will try to reconnect.\r\n");
@@ -62,7 +72,12 @@ void init_mqtt_HAL(void) {
   // Setup WiFi
   WiFi.setHostname("OMOTE"); //define hostname
   WiFi.onEvent(WiFiEvent);
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  if (wifiLastConnectionValid) {
+    // after wakeup from deep sleep
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD, wifiLastConnectionChannel, wifiLastConnectionBSSID);
+  } else {
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  }
   WiFi.setSleep(true);
 }
 
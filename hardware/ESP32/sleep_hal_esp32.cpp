@@ -16,6 +16,14 @@
 #include "keyboard_ble_hal_esp32.h"
 // prepare keypad keys to wakeup
 #include "keypad_keys_hal_esp32.h"
+// light sleep is only possible while nothing needs the clocks of the SoC
+#if (ENABLE_WIFI_AND_MQTT == 1)
+#include "WiFi.h"
+#endif
+#include "ledFade_hal_esp32.h"
+#include "commandWorker_hal_esp32.h"
+// with the task split, the loopTask waits for the other tasks instead of light sleep
+#include "tasks_hal_esp32.h"
 
 #if (OMOTE_HARDWARE_REV >= 5)
   const uint8_t ACC_INT_GPIO = 2;
@@ -38,6 +46,18 @@ uint32_t lastActivityTimestamp;
 LIS3DH IMU(I2C_MODE, 0x19);
 Wakeup_reasons wakeup_reason;
 
+RTC_DATA_ATTR uint8_t rtcMemory[RTC_MEMORY_SIZE];
+tAnnounceGoingToSleep_cb thisAnnounceGoingToSleep_cb = NULL;
+void set_announceGoingToSleep_cb_HAL(tAnnounceGoingToSleep_cb pAnnounceGoingToSleep_cb) {
+  thisAnnounceGoingToSleep_cb = pAnnounceGoingToSleep_cb;
+}
+uint8_t *get_rtcMemory_HAL() {
+  return rtcMemory;
+}
+bool get_wakeupFromDeepSleep_HAL() {
+  return wakeup_reason != WAKEUP_BY_RESET;
+}
+
 void setLastActivityTimestamp_HAL() {
   // There was motion, touchpad or key hit.
   // Set the time where this happens.
@@ -135,6 +155,10 @@ void configIMUInterruptsBeforeGoingToSleep()
 
 // Enter Sleep Mode
 void enterSleep(){
+  // Snapshot for a fast wakeup in RTC memory
+  if (thisAnnounceGoingToSleep_cb != NULL) {
+    thisAnnounceGoingToSleep_cb();
+  }
   // Save settings to internal flash memory
   save_preferences_HAL();
 
@@ -146,6 +170,11 @@ void enterSleep(){
   // really clear interrupt
   IMU.readRegister(&intDataRead, LIS3DH_INT1_SRC);
 
+  #if (ENABLE_TASK_SPLIT == 1)
+  // the connectivity task owns WiFi and BLE, and the input task must not scan the keys any more
+  tasks_stop_HAL();
+  #endif
+
   #if (ENABLE_WIFI_AND_MQTT == 1)
   // Power down modem
   wifi_shutdown_HAL();
@@ -219,8 +248,103 @@ void enterSleep(){
   esp_deep_sleep_start();
 }
 
+// light sleep between two loop()
+uint64_t idleSleepTime_us = 0;
+// the Arduino loopTask, which runs setup() and loop(). Woken by wakeIdle_HAL() while it blocks in idle_HAL().
+static TaskHandle_t volatile loopTaskHandle = NULL;
+
+#if (ENABLE_TASK_SPLIT != 1)
+// Blocks the loopTask until the next deadline or until it is notified. Without this, loop() would spin at full speed while nothing is due.
+// A notification given while loop() was running is not lost, the next call returns at once.
+static void blockMainLoop(uint32_t timeTillNextDeadline_ms) {
+  if ((timeTillNextDeadline_ms == 0) || (loopTaskHandle == NULL)) {
+    return;
+  }
+  uint32_t block_ms = (timeTillNextDeadline_ms < IDLE_MAX_MS) ? timeTillNextDeadline_ms : IDLE_MAX_MS;
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(block_ms));
+}
+#endif
+
+#if (ENABLE_LIGHT_SLEEP == 1) && (ENABLE_TASK_SPLIT != 1)
+static bool lightSleepPossible() {
+  #if (ENABLE_WIFI_AND_MQTT == 1)
+  // the radio would lose the connection
+  if (WiFi.getMode() != WIFI_OFF) {return false;}
+  #endif
+  #if (ENABLE_KEYBOARD_BLE == 1)
+  if (keyboardBLE_isAdvertising_HAL() || keyboardBLE_isConnected_HAL()) {return false;}
+  #endif
+  // an IR code would be cut in pieces, no matter if it is sent or received. Queued commands of the main loop must not wait either.
+  if (commandWorker_isBusy_HAL()) {return false;}
+  if (get_irReceiverEnabled_HAL()) {return false;}
+  // PWM of the backlights stops in light sleep
+  if (!ledFade_isStatic_HAL()) {return false;}
+  return true;
+}
+#endif
+
+void idle_HAL(uint32_t timeTillNextDeadline_ms) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  // Light sleep would stop the input and the connectivity task as well. Block the loopTask until the next deadline or until one of them wakes it up.
+  tasks_idleMainLoop_HAL(timeTillNextDeadline_ms);
+  #elif (ENABLE_LIGHT_SLEEP == 1)
+  if ((timeTillNextDeadline_ms < LIGHT_SLEEP_MIN_MS) || !lightSleepPossible()) {
+    blockMainLoop(timeTillNextDeadline_ms);
+    return;
+  }
+  uint32_t sleep_ms = (timeTillNextDeadline_ms < IDLE_MAX_MS) ? timeTillNextDeadline_ms : IDLE_MAX_MS;
+
+  // Touch and IMU have no interrupt while awake. They are polled by lvgl and by check_activity_HAL(), which limits the sleep time anyway.
+  esp_sleep_enable_timer_wakeup((uint64_t)sleep_ms * 1000);
+  keys_enableLightSleepWakeup_HAL();
+  esp_sleep_enable_gpio_wakeup();
+  // UART output would be garbled
+  Serial.flush();
+
+  // millis() and micros() keep counting in light sleep
+  unsigned long start = micros();
+  esp_light_sleep_start();
+  idleSleepTime_us += micros() - start;
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  keys_disableLightSleepWakeup_HAL();
+  #else
+  blockMainLoop(timeTillNextDeadline_ms);
+  #endif
+}
+
+void wakeIdle_HAL(void) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  tasks_wake_HAL(0);
+  #else
+  // Light sleep is not entered as long as there are queued commands, but loop() may block instead
+  if (loopTaskHandle != NULL) {
+    xTaskNotifyGive(loopTaskHandle);
+  }
+  #endif
+}
+
+void IRAM_ATTR wakeIdleFromISR_HAL(void) {
+  #if (ENABLE_TASK_SPLIT != 1)
+  // with the task split, the input task polls the keypad
+  if (loopTaskHandle != NULL) {
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(loopTaskHandle, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) {
+      portYIELD_FROM_ISR();
+    }
+  }
+  #endif
+}
+
+uint64_t get_idleSleepTime_us_HAL() {
+  return idleSleepTime_us;
+}
+
 void init_sleep_HAL() {
   // will be called after boot or wakeup. Releases GPIO hold and sets wakeup_reason
+  // setup() runs in the loopTask, like loop()
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
   if (sleepTimeout == 0){
     sleepTimeout = DEFAULT_SLEEP_TIMEOUT;
   }
@@ -229,8 +353,10 @@ void init_sleep_HAL() {
   }
 
   // Find out wakeup cause
+  uint64_t ext1WakeupStatus = 0;
   if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT1) {
-    if (esp_sleep_get_ext1_wakeup_status() == (0x01<<ACC_INT_GPIO)) {
+    ext1WakeupStatus = esp_sleep_get_ext1_wakeup_status();
+    if (ext1WakeupStatus == (0x01<<ACC_INT_GPIO)) {
       wakeup_reason = WAKEUP_BY_IMU;
     } else {
       wakeup_reason = WAKEUP_BY_KEYPAD;
@@ -252,6 +378,11 @@ void init_sleep_HAL() {
   gpio_hold_dis((gpio_num_t)LCD_EN_GPIO);
   gpio_hold_dis((gpio_num_t)LCD_BL_GPIO);
   gpio_deep_sleep_hold_dis();
+
+  // as early as possible, the key matrix has to be scanned while the key is still pressed. Needs the released GPIO hold.
+  if (wakeup_reason == WAKEUP_BY_KEYPAD) {
+    keys_captureWakeupKey_HAL(ext1WakeupStatus);
+  }
 }
 
 void init_IMU_HAL(void) {
@@ -293,7 +424,7 @@ bool get_wakeupByIMUEnabled_HAL() {
 void set_wakeupByIMUEnabled_HAL(bool aWakeupByIMUEnabled) {
   wakeupByIMUEnabled = aWakeupByIMUEnabled;
 }
-uint32_t get_lastActivityTimestamp() {
+uint32_t get_lastActivityTimestamp_HAL() {
   return lastActivityTimestamp;
 }
 uint8_t get_motionThreshold_HAL() {
@@ -9,14 +9,35 @@ extern int DEFAULT_SLEEP_TIMEOUT;
 enum Wakeup_reasons{WAKEUP_BY_RESET, WAKEUP_BY_IMU, WAKEUP_BY_KEYPAD};
 extern Wakeup_reasons wakeup_reason;
 
-// only called by tft.cpp, needs to know this because tft gets dimmed 2000 ms before going to sleep
-uint32_t get_lastActivityTimestamp();
+// called by tft.cpp, needs to know this because tft gets dimmed 2000 ms before going to sleep. And by the energy model.
+uint32_t get_lastActivityTimestamp_HAL();
 
 // called from the HAL
 void init_sleep_HAL();
+bool get_wakeupFromDeepSleep_HAL();
+// RTC slow memory, keeps its content in deep sleep. Zero after reset or power on.
+#define RTC_MEMORY_SIZE 128
+uint8_t *get_rtcMemory_HAL();
+// called right before deep sleep, e.g. to write into the RTC memory
+typedef void (*tAnnounceGoingToSleep_cb)(void);
+void set_announceGoingToSleep_cb_HAL(tAnnounceGoingToSleep_cb pAnnounceGoingToSleep_cb);
 void init_IMU_HAL();
 void check_activity_HAL();
 void setLastActivityTimestamp_HAL();
+// Light sleep between two loop() (build flag ENABLE_LIGHT_SLEEP=1), until the next task is due or a key is pressed.
+// Only if WiFi is off, BLE is neither advertising nor connected, no IR code is sent or received and the backlights are either off or at full brightness.
+// Shorter sleeps cost more than they save, the wakeup takes about 1 ms.
+#define LIGHT_SLEEP_MIN_MS 3
+// Without light sleep, the loopTask blocks until the next task is due or until wakeIdle_HAL() is called. The CPU only runs the idle task of FreeRTOS then.
+// This is awake idle, not idle sleep, so it is not counted by get_idleSleepTime_us_HAL().
+// Max time of both. The scheduler always has a task due within this time, it's only a safety net.
+#define IDLE_MAX_MS 1000
+void idle_HAL(uint32_t timeTillNextDeadline_ms);
+// ends idle_HAL() early. Can be called from any task.
+void wakeIdle_HAL(void);
+// the same, from an interrupt, e.g. of the keypad
+void wakeIdleFromISR_HAL(void);
+uint64_t get_idleSleepTime_us_HAL();
 
 uint32_t get_sleepTimeout_HAL();
 void set_sleepTimeout_HAL(uint32_t aSleepTimeout);
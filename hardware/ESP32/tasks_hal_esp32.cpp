@@ -0,0 +1,130 @@
+#include <Arduino.h>
+#include <atomic>
+#include "esp_timer.h"
+#include "tasks_hal_esp32.h"
+
+struct t_task {
+  const char *name;
+  tTaskLoop_cb loop_cb;
+  TaskHandle_t handle;
+  int8_t core;
+  // esp_timer_get_time(), micros() would wrap after 71 minutes
+  int64_t start_us;
+  // written by the task itself, read by the statistics
+  std::atomic<uint64_t> sleepTime_us;
+  std::atomic<bool> stopRequested;
+  // given by the task when it has stopped
+  SemaphoreHandle_t stoppedSemaphore;
+};
+t_task tasks[TASKS_MAX];
+std::atomic<uint8_t> taskCount(0);
+
+// the loopTask is registered the first time it idles
+static void registerMainLoop() {
+  if (taskCount > 0) {
+    return;
+  }
+  t_task *t = &tasks[0];
+  t->name = "gui (loop)";
+  t->loop_cb = NULL;
+  t->handle = xTaskGetCurrentTaskHandle();
+  t->core = xPortGetCoreID();
+  t->start_us = esp_timer_get_time();
+  t->sleepTime_us = 0;
+  taskCount = 1;
+}
+
+// sleeps until the timeout or until the task is notified
+static void sleepTask(t_task *t, uint32_t sleep_ms) {
+  if (sleep_ms == 0) {
+    // let tasks of the same priority run
+    taskYIELD();
+    return;
+  }
+  int64_t start = esp_timer_get_time();
+  ulTaskNotifyTake(pdTRUE, (sleep_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(sleep_ms));
+  t->sleepTime_us += esp_timer_get_time() - start;
+}
+
+static void taskFunction(void *parameter) {
+  t_task *t = (t_task *)parameter;
+  while (!t->stopRequested) {
+    uint32_t sleep_ms = t->loop_cb();
+    if (!t->stopRequested) {
+      sleepTask(t, sleep_ms);
+    }
+  }
+  xSemaphoreGive(t->stoppedSemaphore);
+  // not deleted, so that the handle stays valid for tasks_wake_HAL()
+  vTaskSuspend(NULL);
+}
+
+uint8_t tasks_start_HAL(const char *name, tTaskLoop_cb pTaskLoop_cb, uint32_t stackSize, int8_t core, uint8_t priority) {
+  registerMainLoop();
+  if (taskCount >= TASKS_MAX) {
+    Serial.printf("cannot start task %s, increase TASKS_MAX\r\n", name);
+    return UINT8_MAX;
+  }
+  uint8_t taskId = taskCount;
+  t_task *t = &tasks[taskId];
+  t->name = name;
+  t->loop_cb = pTaskLoop_cb;
+  t->core = core;
+  t->start_us = esp_timer_get_time();
+  t->sleepTime_us = 0;
+  t->stopRequested = false;
+  t->stoppedSemaphore = xSemaphoreCreateBinary();
+  if (core == TASKS_NO_CORE) {
+    xTaskCreate(taskFunction, name, stackSize, t, priority, &t->handle);
+  } else {
+    xTaskCreatePinnedToCore(taskFunction, name, stackSize, t, priority, &t->handle, core);
+  }
+  // only now the handle is valid for tasks_wake_HAL()
+  taskCount = taskId + 1;
+  return taskId;
+}
+
+void tasks_wake_HAL(uint8_t taskId) {
+  if ((taskId < taskCount) && (tasks[taskId].handle != NULL)) {
+    xTaskNotifyGive(tasks[taskId].handle);
+  }
+}
+
+void tasks_stop_HAL(void) {
+  // task 0 is the loopTask, which calls this
+  for (uint8_t i = 1; i < taskCount; i++) {
+    tasks[i].stopRequested = true;
+    if (tasks[i].handle != NULL) {
+      xTaskNotifyGive(tasks[i].handle);
+    }
+  }
+  for (uint8_t i = 1; i < taskCount; i++) {
+    if (tasks[i].handle == NULL) {
+      continue;
+    }
+    if (xSemaphoreTake(tasks[i].stoppedSemaphore, pdMS_TO_TICKS(TASKS_STOP_TIMEOUT_MS)) != pdTRUE) {
+      Serial.printf("task %s did not stop\r\n", tasks[i].name);
+    }
+  }
+}
+
+void tasks_idleMainLoop_HAL(uint32_t timeTillNextDeadline_ms) {
+  registerMainLoop();
+  sleepTask(&tasks[0], timeTillNextDeadline_ms);
+}
+
+uint8_t tasks_getCount_HAL(void) {
+  return taskCount;
+}
+
+taskStatistics_HAL tasks_getStatistics_HAL(uint8_t taskId) {
+  if (taskId >= taskCount) {
+    return taskStatistics_HAL{"", TASKS_NO_CORE, 0, 0, 0};
+  }
+  t_task *t = &tasks[taskId];
+  uint64_t lifeTime_us = esp_timer_get_time() - t->start_us;
+  uint64_t sleepTime_us = t->sleepTime_us;
+  // uxTaskGetStackHighWaterMark() counts bytes on the ESP32, not words
+  uint32_t stackHighWaterMark = (t->handle != NULL) ? uxTaskGetStackHighWaterMark(t->handle) : 0;
+  return taskStatistics_HAL{t->name, t->core, (sleepTime_us < lifeTime_us) ? lifeTime_us - sleepTime_us : 0, lifeTime_us, stackHighWaterMark};
+}
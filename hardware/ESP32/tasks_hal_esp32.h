@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// Tasks of the optional task split (ENABLE_TASK_SPLIT=1). Each task calls its callback in a loop. The callback returns the ms until it has to run again,
+// the task sleeps until then or until tasks_wake_HAL() is called. The Arduino loopTask, which runs loop(), is counted as task 0.
+#define TASKS_MAX 4
+#define TASKS_NO_CORE -1
+typedef uint32_t (*tTaskLoop_cb)(void);
+// returns the id of the new task
+uint8_t tasks_start_HAL(const char *name, tTaskLoop_cb pTaskLoop_cb, uint32_t stackSize, int8_t core, uint8_t priority);
+// lets the task run as soon as possible. Can be called from any task.
+void tasks_wake_HAL(uint8_t taskId);
+// called by idle_HAL(). The loopTask sleeps until the next deadline or until it is woken.
+void tasks_idleMainLoop_HAL(uint32_t timeTillNextDeadline_ms);
+// Called by enterSleep(), before the radios are shut down. Each task finishes the pass of its callback and is then suspended for good.
+// Returns when all tasks have stopped, or after TASKS_STOP_TIMEOUT_MS per task.
+#define TASKS_STOP_TIMEOUT_MS 2000
+void tasks_stop_HAL(void);
+
+struct taskStatistics_HAL {
+  const char *name;
+  int8_t core;
+  // time the task was not sleeping, since it was started. Includes the time it was ready, but another task of the same or a higher priority was running.
+  uint64_t awakeTime_us;
+  uint64_t lifeTime_us;
+  // bytes of the stack that were never used
+  uint32_t stackHighWaterMark;
+};
+uint8_t tasks_getCount_HAL(void);
+taskStatistics_HAL tasks_getStatistics_HAL(uint8_t taskId);
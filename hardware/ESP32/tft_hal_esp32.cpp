@@ -2,13 +2,10 @@
 #include "driver/ledc.h"
 #include "tft_hal_esp32.h"
 #include "sleep_hal_esp32.h"
+#include "ledFade_hal_esp32.h"
 
-// The ESP32 can only do LOW_SPEED_MODE
-#if(OMOTE_HARDWARE_REV >= 5)
-#define LEDC_SPEED_MODE LEDC_LOW_SPEED_MODE
-#else
-#define LEDC_SPEED_MODE LEDC_HIGH_SPEED_MODE
-#endif
+// fade time when the brightness changes, e.g. when dimming before going to sleep. After boot or wakeup, fade in lasts for <backlightBrightness> ms.
+#define BACKLIGHT_FADE_TIME_MS 200
 
 // Set pins for 8-bit mode (ESP32-S3) or SPI (ESP32)
 #if(OMOTE_HARDWARE_REV >= 5)
@@ -130,6 +127,7 @@ void init_tft(void) {
   if (err != ESP_OK) {
     Serial.println("Error when calling ledc_timer_config!");
   }  
+  init_ledFade_HAL();
 
   #if (OMOTE_HARDWARE_REV == 1)
   // Slowly charge the VSW voltage to prevent a brownout
@@ -153,29 +151,20 @@ void init_tft(void) {
   tft.setSwapBytes(true);
 }
 
+// Only sets the target of the backlight. The fade itself is done by the LEDC hardware.
 void update_backlightBrightness_HAL(void) {
-  // A variable declared static inside a function is visible only inside that function, exists only once (not created/destroyed for each call) and is permanent. It is in a sense a private global variable.
-  static int fadeInTimer = millis(); // fadeInTimer = time after setup
-  if (millis() < fadeInTimer + backlightBrightness) {
-    // after boot or wakeup, fade in backlight brightness
-    // fade in lasts for <backlightBrightness> ms
-    ledcWrite(LEDC_CHANNEL_5, millis() - fadeInTimer);
+  uint8_t targetDuty;
+  if (millis() - get_lastActivityTimestamp_HAL() > get_sleepTimeout_HAL() - 2000) {
+    // less than 2000 ms until standby
+    // dim backlight
+    targetDuty = backlightBrightness * 0.3;
   } else {
-    if (millis() - get_lastActivityTimestamp() > get_sleepTimeout_HAL() - 2000) {
-      // less than 2000 ms until standby
-      // dim backlight
-      ledcWrite(LEDC_CHANNEL_5, get_backlightBrightness_HAL() * 0.3);
-    } else {
-      // normal mode, set full backlightBrightness
-      // turn off PWM if backlight is at full brightness
-      if(backlightBrightness < 255){
-        ledcWrite(LEDC_CHANNEL_5, backlightBrightness);
-      }
-      else{
-        ledc_stop(LEDC_SPEED_MODE, LEDC_CHANNEL_5, 255);
-      }
-    }
+    // normal mode, set full backlightBrightness
+    targetDuty = backlightBrightness;
   }
+  // after boot or wakeup, fade in from dark lasts for <backlightBrightness> ms
+  uint32_t fadeTime = (ledFade_getTarget_HAL(LEDFADE_CHANNEL_BACKLIGHT) == 0) ? targetDuty : BACKLIGHT_FADE_TIME_MS;
+  ledFade_setTarget_HAL(LEDFADE_CHANNEL_BACKLIGHT, targetDuty, fadeTime);
 }
 
 uint8_t get_backlightBrightness_HAL() {
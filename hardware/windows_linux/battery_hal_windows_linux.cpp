@@ -1,3 +1,5 @@
+#include <math.h>
+
 void init_battery_HAL(void) {};
 
 void get_battery_status_HAL(int *battery_voltage, int *battery_percentage, bool *battery_ischarging) {
@@ -5,3 +7,7 @@ void get_battery_status_HAL(int *battery_voltage, int *battery_percentage, bool
   *battery_percentage = 50;
   *battery_ischarging = false; 
 }
+
+float get_battery_chargeRate_HAL(void) {
+  return NAN;
+}
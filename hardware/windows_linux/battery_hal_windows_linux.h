@@ -2,3 +2,5 @@
 
 void init_battery_HAL(void);
 void get_battery_status_HAL(int *battery_voltage, int *battery_percentage, bool *battery_ischarging);
+// no fuel gauge in the simulator, always NAN
+float get_battery_chargeRate_HAL(void);
@@ -0,0 +1,226 @@
+#include <atomic>
+#include <lvgl.h>
+#include <stdio.h>
+#include <SDL2/SDL_timer.h>
+#include <SDL2/SDL_events.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+#include "clock_hal_windows_linux.h"
+// after clock_hal_windows_linux.h, where SHOW_CPU_USAGE can be activated
+#if defined(SHOW_CPU_USAGE) && (defined(__linux__) || defined(__APPLE__))
+#include <sys/resource.h>
+#endif
+#if (SIMULATOR_HEADLESS == 1)
+#include "headless/headless.h"
+#endif
+
+#if (SIMULATOR_VIRTUAL_CLOCK == 1) && (SIMULATOR_HEADLESS != 1)
+  // with the SDL windows, the time would pass as fast as loop() runs and mouse events would have SDL timestamps
+  #error "SIMULATOR_VIRTUAL_CLOCK=1 needs SIMULATOR_HEADLESS=1"
+#endif
+
+#if (SIMULATOR_VIRTUAL_CLOCK == 1) && (ENABLE_TASK_SPLIT == 1)
+  // the tasks sleep in real time, and only the main thread may advance the virtual clock
+  #error "SIMULATOR_VIRTUAL_CLOCK=1 does not work with ENABLE_TASK_SPLIT=1"
+#endif
+
+#if (SIMULATOR_VIRTUAL_CLOCK == 1)
+// read from the command worker thread, too
+static std::atomic<uint32_t> virtualMillis(0);
+static uint32_t pendingSkip_ms = 0;
+// Only the main thread advances the virtual clock. Initialized before main() runs, so on the main thread.
+static SDL_threadID mainThreadID = SDL_ThreadID();
+// The command worker is either idle, busy or waiting in clock_delay_HAL(). The main thread only advances the clock while it is not busy,
+// so everything the worker does happens at a reproducible time, too.
+static SDL_mutex *workerMutex = SDL_CreateMutex();
+static SDL_cond *workerCondition = SDL_CreateCond();
+// notifications of the worker not yet finished
+static uint32_t workerPendingNotifications = 0;
+static bool workerWaiting = false;
+static uint32_t workerWakeAt = 0;
+
+static bool workerIsBusy(void) {
+  return (workerPendingNotifications > 0) && !workerWaiting;
+}
+
+static void advanceVirtualClock(uint32_t ms) {
+  while (ms > 0) {
+    SDL_LockMutex(workerMutex);
+    while (workerIsBusy()) {
+      SDL_CondWait(workerCondition, workerMutex);
+    }
+    // stop at the time the worker waits for, so that it continues exactly then
+    uint32_t step = ms;
+    if (workerWaiting && (workerWakeAt - virtualMillis < step)) {
+      step = workerWakeAt - virtualMillis;
+    }
+    virtualMillis += step;
+    if (workerWaiting && (virtualMillis == workerWakeAt)) {
+      workerWaiting = false;
+      SDL_CondBroadcast(workerCondition);
+      // the worker continues at this time, not at some later time depending on the speed of the host
+      while (workerIsBusy()) {
+        SDL_CondWait(workerCondition, workerMutex);
+      }
+    }
+    SDL_UnlockMutex(workerMutex);
+    lv_tick_inc(step);
+    ms -= step;
+  }
+}
+
+// the command worker waits until the main thread has advanced the clock by ms
+static void waitForVirtualClock(uint32_t ms) {
+  if (ms == 0) {
+    return;
+  }
+  SDL_LockMutex(workerMutex);
+  workerWakeAt = virtualMillis + ms;
+  workerWaiting = true;
+  // the main thread may be waiting for the worker
+  SDL_CondBroadcast(workerCondition);
+  while (workerWaiting) {
+    SDL_CondWait(workerCondition, workerMutex);
+  }
+  SDL_UnlockMutex(workerMutex);
+}
+#endif
+
+uint32_t clock_millis_HAL(void) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  return virtualMillis;
+  #else
+  return SDL_GetTicks();
+  #endif
+}
+
+void clock_loop_HAL(void) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  if (pendingSkip_ms > 0) {
+    uint32_t step = (pendingSkip_ms < VIRTUAL_CLOCK_SKIP_STEP_MS) ? pendingSkip_ms : VIRTUAL_CLOCK_SKIP_STEP_MS;
+    pendingSkip_ms -= step;
+    advanceVirtualClock(step);
+  } else {
+    advanceVirtualClock(VIRTUAL_CLOCK_STEP_MS);
+  }
+  #endif
+  #if (SIMULATOR_HEADLESS == 1)
+  headless_loop();
+  #endif
+}
+
+void clock_delay_HAL(uint32_t ms) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  if (SDL_ThreadID() == mainThreadID) {
+    advanceVirtualClock(ms);
+  } else {
+    waitForVirtualClock(ms);
+  }
+  #else
+  SDL_Delay(ms);
+  #endif
+}
+
+#if defined(SHOW_CPU_USAGE) && (defined(__linux__) || defined(__APPLE__))
+static uint64_t cpuUsageTimer = 0;
+static uint64_t cpuUsageLastCPUTime_us = 0;
+static uint64_t cpuUsageSleepTime_us = 0;
+
+// CPU time of all threads of the simulator
+static uint64_t getProcessCPUTime_us() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ULL + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static void logCPUUsage(uint64_t sleepTime_us) {
+  uint64_t now = SDL_GetTicks64();
+  cpuUsageSleepTime_us += sleepTime_us;
+  if (now - cpuUsageTimer < 10000) {
+    return;
+  }
+  uint64_t cpuTime_us = getProcessCPUTime_us();
+  uint64_t interval_us = (now - cpuUsageTimer) * 1000;
+  printf("simulator: CPU usage %.1f%% of one core, main loop sleeping %.1f%% of the time\r\n",
+    (float)(cpuTime_us - cpuUsageLastCPUTime_us) * 100 / interval_us, (float)cpuUsageSleepTime_us * 100 / interval_us);
+  cpuUsageTimer = now;
+  cpuUsageLastCPUTime_us = cpuTime_us;
+  cpuUsageSleepTime_us = 0;
+}
+#endif
+
+static uint64_t idleSleepTime_us = 0;
+#if (SIMULATOR_HEADLESS == 1)
+// without window there are no SDL events, clock_wakeIdle_HAL() posts this instead
+static SDL_sem *idleWakeupSemaphore = SDL_CreateSemaphore(0);
+#endif
+
+void clock_idle_HAL(uint32_t timeTillNextDeadline_ms) {
+  #if (SIMULATOR_VIRTUAL_CLOCK != 1)
+  uint32_t sleep_ms = (timeTillNextDeadline_ms < IDLE_MAX_SLEEP_MS) ? timeTillNextDeadline_ms : IDLE_MAX_SLEEP_MS;
+  uint64_t sleepStart = SDL_GetPerformanceCounter();
+  if (sleep_ms > 0) {
+    #if (SIMULATOR_HEADLESS == 1)
+    // no SDL events without window. The script is executed by an lvgl timer.
+    SDL_SemWaitTimeout(idleWakeupSemaphore, sleep_ms);
+    // several wakeups are merged into one
+    while (SDL_SemTryWait(idleWakeupSemaphore) == 0) {}
+    #else
+    // mouse events are processed by lvgl, clicks on the keypad window are already queued when the event filter sees them
+    SDL_WaitEventTimeout(NULL, sleep_ms);
+    #endif
+  }
+  uint64_t sleepTime_us = (SDL_GetPerformanceCounter() - sleepStart) * 1000000 / SDL_GetPerformanceFrequency();
+  idleSleepTime_us += sleepTime_us;
+  #if defined(SHOW_CPU_USAGE) && (defined(__linux__) || defined(__APPLE__))
+  logCPUUsage(sleepTime_us);
+  #endif
+  #endif
+}
+
+void clock_wakeIdle_HAL(void) {
+  #if (SIMULATOR_HEADLESS == 1)
+  SDL_SemPost(idleWakeupSemaphore);
+  #else
+  // any event ends SDL_WaitEventTimeout(). lvgl and the keypad window ignore it.
+  SDL_Event event;
+  SDL_zero(event);
+  event.type = SDL_USEREVENT;
+  SDL_PushEvent(&event);
+  #endif
+}
+
+void clock_workerNotified_HAL(void) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  SDL_LockMutex(workerMutex);
+  workerPendingNotifications++;
+  SDL_UnlockMutex(workerMutex);
+  #endif
+}
+
+void clock_workerFinished_HAL(uint32_t notifications) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  SDL_LockMutex(workerMutex);
+  workerPendingNotifications -= notifications;
+  SDL_CondBroadcast(workerCondition);
+  SDL_UnlockMutex(workerMutex);
+  #endif
+}
+
+uint64_t clock_getIdleSleepTime_us_HAL(void) {
+  return idleSleepTime_us;
+}
+
+void clock_skip_HAL(uint32_t ms) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  pendingSkip_ms += ms;
+  #endif
+}
+
+bool clock_isVirtual_HAL(void) {
+  #if (SIMULATOR_VIRTUAL_CLOCK == 1)
+  return true;
+  #else
+  return false;
+  #endif
+}
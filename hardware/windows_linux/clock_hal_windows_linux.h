@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+// The simulator has no millis(). All of its time comes from here: either from the SDL clock or, with SIMULATOR_VIRTUAL_CLOCK=1, from a virtual clock.
+// The virtual clock does not depend on the speed of the host. It only advances in clock_loop_HAL(), by VIRTUAL_CLOCK_STEP_MS per loop(),
+// and it also drives the lvgl tick. This makes timing dependent behaviour reproducible: key hold detection, the periodic tasks in loop(), lvgl timers and animations.
+#define VIRTUAL_CLOCK_STEP_MS      1
+// max time the virtual clock advances per loop() while skipping. Small enough that the 100 ms tasks in loop() still run every time.
+#define VIRTUAL_CLOCK_SKIP_STEP_MS 100
+// When there is nothing to do, the simulator sleeps between two loop() until the next task of the scheduler is due, but at most this long.
+#define IDLE_MAX_SLEEP_MS          20
+// activate, or add -D SHOW_CPU_USAGE to the build flags, to print the CPU usage of the simulator every 10 s. For a measurement idle vs. interacting,
+// see headless/tests/cpuUsage.txt
+//#define SHOW_CPU_USAGE
+
+// ms since program start
+uint32_t clock_millis_HAL(void);
+// called once per loop(). Headless, it also runs the self tests requested by the script.
+void clock_loop_HAL(void);
+// blocks for ms. With the virtual clock, the time passes immediately on the main thread. Only the main thread advances the virtual clock:
+// the command worker waits until the main thread has reached its time.
+void clock_delay_HAL(uint32_t ms);
+// called after every loop(). Sleeps up to timeTillNextDeadline_ms (max IDLE_MAX_SLEEP_MS), but wakes up on an SDL event.
+// Does not sleep with the virtual clock.
+void clock_idle_HAL(uint32_t timeTillNextDeadline_ms);
+// ends clock_idle_HAL() early. Can be called from any thread.
+void clock_wakeIdle_HAL(void);
+// Called by the command worker HAL: before the worker is notified, and with the number of notifications when it has executed the commands.
+// With the virtual clock, the main thread does not advance the clock in between, unless the worker waits in clock_delay_HAL().
+void clock_workerNotified_HAL(void);
+void clock_workerFinished_HAL(uint32_t notifications);
+// total time slept in clock_idle_HAL()
+uint64_t clock_getIdleSleepTime_us_HAL(void);
+// lets ms pass as fast as possible, in steps of VIRTUAL_CLOCK_SKIP_STEP_MS per loop(). Does nothing with the SDL clock.
+void clock_skip_HAL(uint32_t ms);
+bool clock_isVirtual_HAL(void);
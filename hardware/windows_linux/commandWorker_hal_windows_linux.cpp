@@ -0,0 +1,41 @@
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_mutex.h>
+#include "commandWorker_hal_windows_linux.h"
+#include "clock_hal_windows_linux.h"
+
+// Same as on the ESP32, but with an SDL thread instead of a FreeRTOS task
+SDL_Thread *commandWorkerThread = NULL;
+SDL_sem *commandWorkerSemaphore = NULL;
+tCommandWorker_cb thisCommandWorker_cb = NULL;
+
+static int commandWorkerThreadFunction(void *data) {
+  while (true) {
+    // sleep until notified
+    SDL_SemWait(commandWorkerSemaphore);
+    // several notifications are merged into one, the callback executes all queued commands anyway
+    uint32_t notifications = 1;
+    while (SDL_SemTryWait(commandWorkerSemaphore) == 0) {
+      notifications++;
+    }
+    thisCommandWorker_cb();
+    clock_workerFinished_HAL(notifications);
+  }
+  return 0;
+}
+
+void start_commandWorker_HAL(tCommandWorker_cb pCommandWorker_cb, tCommandWorkerHasCommands_cb pCommandWorkerHasCommands_cb) {
+  if (commandWorkerThread != NULL) {
+    return;
+  }
+  thisCommandWorker_cb = pCommandWorker_cb;
+  commandWorkerSemaphore = SDL_CreateSemaphore(0);
+  commandWorkerThread = SDL_CreateThread(commandWorkerThreadFunction, "commandWorker", NULL);
+}
+
+void notify_commandWorker_HAL(void) {
+  if (commandWorkerSemaphore != NULL) {
+    // before the post, so that the virtual clock waits for the worker
+    clock_workerNotified_HAL();
+    SDL_SemPost(commandWorkerSemaphore);
+  }
+}
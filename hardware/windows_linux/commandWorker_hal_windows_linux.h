@@ -0,0 +1,9 @@
+#pragma once
+
+// The command worker is a separate thread which executes commands that only talk to a transport (IR, BLE keyboard).
+// It sleeps until it is notified, then calls the callback, which executes all queued commands.
+typedef void (*tCommandWorker_cb)(void);
+// true as long as there are commands in the queue, no matter if they are executed by the worker or by the main loop. Not needed in the simulator, it has no light sleep.
+typedef bool (*tCommandWorkerHasCommands_cb)(void);
+void start_commandWorker_HAL(tCommandWorker_cb pCommandWorker_cb, tCommandWorkerHasCommands_cb pCommandWorkerHasCommands_cb);
+void notify_commandWorker_HAL(void);
@@ -0,0 +1,352 @@
+#if (SIMULATOR_HEADLESS == 1)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include "../keypad_gui/keypad_gui.h"
+#include "../keypad_gui/key_map.h"
+#include "../clock_hal_windows_linux.h"
+#include "headless.h"
+
+// --- offscreen display ------------------------------------------------------
+static lv_color_t *framebuffer = NULL;
+static uint32_t flushedFrames = 0;
+
+void headless_display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+  int32_t width = area->x2 - area->x1 + 1;
+  for (int32_t y = area->y1; y <= area->y2; y++) {
+    memcpy(&framebuffer[y * SDL_HOR_RES + area->x1], color_p, width * sizeof(lv_color_t));
+    color_p += width;
+  }
+  if (lv_disp_flush_is_last(disp)) {
+    flushedFrames++;
+  }
+  lv_disp_flush_ready(disp);
+}
+
+static uint32_t framebuffer_crc32() {
+  const uint8_t *data = (const uint8_t *)framebuffer;
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < sizeof(lv_color_t) * SDL_HOR_RES * SDL_VER_RES; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static bool framebuffer_savePNG(const char *filename) {
+  #if LV_COLOR_DEPTH == 32
+  Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+  #else
+  Uint32 format = SDL_PIXELFORMAT_RGB565;
+  #endif
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(framebuffer, SDL_HOR_RES, SDL_VER_RES, LV_COLOR_DEPTH, SDL_HOR_RES * sizeof(lv_color_t), format);
+  if (surface == NULL) {
+    return false;
+  }
+  bool res = (IMG_SavePNG(surface, filename) == 0);
+  SDL_FreeSurface(surface);
+  return res;
+}
+
+// --- script -----------------------------------------------------------------
+enum headlessCommandType {WAIT, SKIP, PRESS, MOVE, RELEASE, SWIPE, KEY, KEYDOWN, KEYUP, CRC, PNG, SELFTEST, EXIT};
+struct headlessCommand {
+  headlessCommandType type;
+  lv_point_t from;
+  lv_point_t to;
+  uint32_t duration_ms;
+  char keyChar;
+  bool hasExpectedCrc;
+  uint32_t expectedCrc;
+  // filename of png, name of selftest
+  std::string text;
+  int line;
+};
+static std::vector<headlessCommand> commands;
+static std::vector<KeyPadKey> keypadKeys;
+
+static size_t currentCommand = 0;
+static bool currentCommandStarted = false;
+static uint32_t currentCommandStart;
+static lv_point_t pointer = {0, 0};
+static bool pointerPressed = false;
+static int failures = 0;
+
+static tRunSelfTest_cb thisRunSelfTest_cb = NULL;
+// set by the script, run by headless_loop()
+static const char *pendingSelfTest = NULL;
+static bool selfTestDone = false;
+
+// reads lines from index on until "end" or the end of the script. Commands inside "repeat" are added multiple times.
+static bool parseScript(const std::vector<std::string> &lines, size_t *index, bool insideRepeat) {
+  while (*index < lines.size()) {
+    int line = *index + 1;
+    std::istringstream tokens(lines[(*index)++]);
+    std::string cmd;
+    if (!(tokens >> cmd) || (cmd[0] == '#')) {
+      continue;
+    }
+    headlessCommand command = {WAIT, {0, 0}, {0, 0}, 0, '\0', false, 0, "", line};
+    bool ok = true;
+    if (cmd == "end") {
+      if (!insideRepeat) {
+        printf("headless: line %d: \"end\" without \"repeat\"\r\n", line);
+        return false;
+      }
+      return true;
+    } else if (cmd == "repeat") {
+      unsigned int count;
+      if (!(tokens >> count)) {
+        printf("headless: line %d: \"repeat\" needs a count\r\n", line);
+        return false;
+      }
+      size_t repeatStart = *index;
+      for (unsigned int i = 0; i < count; i++) {
+        *index = repeatStart;
+        if (!parseScript(lines, index, true)) {
+          return false;
+        }
+      }
+      if (count == 0) {
+        // skip the enclosed commands
+        size_t sizeBefore = commands.size();
+        if (!parseScript(lines, index, true)) {
+          return false;
+        }
+        commands.resize(sizeBefore);
+      }
+      continue;
+    } else if ((cmd == "wait") || (cmd == "skip")) {
+      command.type = (cmd == "wait") ? WAIT : SKIP;
+      ok = !!(tokens >> command.duration_ms);
+    } else if ((cmd == "press") || (cmd == "move")) {
+      command.type = (cmd == "press") ? PRESS : MOVE;
+      ok = !!(tokens >> command.to.x >> command.to.y);
+    } else if (cmd == "release") {
+      command.type = RELEASE;
+    } else if (cmd == "swipe") {
+      command.type = SWIPE;
+      ok = !!(tokens >> command.from.x >> command.from.y >> command.to.x >> command.to.y >> command.duration_ms);
+    } else if ((cmd == "key") || (cmd == "keydown") || (cmd == "keyup")) {
+      command.type = (cmd == "key") ? KEY : ((cmd == "keydown") ? KEYDOWN : KEYUP);
+      ok = !!(tokens >> command.keyChar);
+      command.duration_ms = 100;
+      if (command.type == KEY) {
+        tokens >> command.duration_ms;
+      }
+    } else if (cmd == "crc") {
+      command.type = CRC;
+      command.hasExpectedCrc = !!(tokens >> std::hex >> command.expectedCrc);
+    } else if (cmd == "png") {
+      command.type = PNG;
+      ok = !!(tokens >> command.text);
+    } else if (cmd == "selftest") {
+      command.type = SELFTEST;
+      ok = !!(tokens >> command.text);
+    } else if (cmd == "exit") {
+      command.type = EXIT;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      printf("headless: line %d: cannot parse \"%s\"\r\n", line, lines[*index - 1].c_str());
+      return false;
+    }
+    commands.push_back(command);
+  }
+  if (insideRepeat) {
+    printf("headless: \"repeat\" without \"end\"\r\n");
+    return false;
+  }
+  return true;
+}
+
+static void loadScript() {
+  const char *filename = getenv("OMOTE_HEADLESS_SCRIPT");
+  if (filename == NULL) {
+    printf("headless: no script given in OMOTE_HEADLESS_SCRIPT, simulator runs without input\r\n");
+    return;
+  }
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    printf("headless: cannot open script %s\r\n", filename);
+    exit(2);
+  }
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    lines.push_back(line);
+  }
+  size_t index = 0;
+  if (!parseScript(lines, &index, false)) {
+    exit(2);
+  }
+  // an empty script ends immediately
+  commands.push_back(headlessCommand{EXIT, {0, 0}, {0, 0}, 0, '\0', false, 0, "", (int)lines.size()});
+  printf("headless: script %s loaded, %lu commands\r\n", filename, (unsigned long)commands.size());
+}
+
+static bool pushKeyEvent(const headlessCommand &command, guiKeyStates keyState) {
+  for (auto const &key : keypadKeys) {
+    if (key.key == command.keyChar) {
+      keyEventsQueue_push(KeyEvent{key.key, key.id, keyState, clock_millis_HAL()});
+      return true;
+    }
+  }
+  printf("headless: line %d: unknown key '%c'\r\n", command.line, command.keyChar);
+  failures++;
+  return false;
+}
+
+// returns false if the command is not finished yet. Then it is called again with firstCall == false.
+static bool executeCommand(const headlessCommand &command, bool firstCall, uint32_t elapsed) {
+  switch (command.type) {
+    case WAIT: {
+      return (elapsed >= command.duration_ms);
+    }
+    case SKIP: {
+      if (firstCall) {
+        clock_skip_HAL(command.duration_ms);
+      }
+      return (elapsed >= command.duration_ms);
+    }
+    case PRESS:
+    case MOVE: {
+      pointer = command.to;
+      pointerPressed = true;
+      return true;
+    }
+    case RELEASE: {
+      pointerPressed = false;
+      return true;
+    }
+    case SWIPE: {
+      if (elapsed < command.duration_ms) {
+        pointer.x = command.from.x + (command.to.x - command.from.x) * (int32_t)elapsed / (int32_t)command.duration_ms;
+        pointer.y = command.from.y + (command.to.y - command.from.y) * (int32_t)elapsed / (int32_t)command.duration_ms;
+        pointerPressed = true;
+        return false;
+      }
+      pointer = command.to;
+      pointerPressed = false;
+      return true;
+    }
+    case KEY: {
+      if (firstCall) {
+        pushKeyEvent(command, PRESSED_SIMULATOR);
+      }
+      if (elapsed < command.duration_ms) {
+        return false;
+      }
+      pushKeyEvent(command, RELEASED_SIMULATOR);
+      return true;
+    }
+    case KEYDOWN:
+    case KEYUP: {
+      pushKeyEvent(command, (command.type == KEYDOWN) ? PRESSED_SIMULATOR : RELEASED_SIMULATOR);
+      return true;
+    }
+    case CRC: {
+      uint32_t crc = framebuffer_crc32();
+      if (command.hasExpectedCrc && (crc != command.expectedCrc)) {
+        printf("headless: line %d: frame crc 0x%08x, expected 0x%08x\r\n", command.line, crc, command.expectedCrc);
+        failures++;
+      } else {
+        printf("headless: line %d: frame crc 0x%08x\r\n", command.line, crc);
+      }
+      return true;
+    }
+    case PNG: {
+      if (!framebuffer_savePNG(command.text.c_str())) {
+        printf("headless: line %d: cannot save %s: %s\r\n", command.line, command.text.c_str(), SDL_GetError());
+        failures++;
+      }
+      return true;
+    }
+    case SELFTEST: {
+      // Not run here, inside of lvgl. The tests execute commands, which change the GUI. headless_loop() runs them.
+      if (firstCall) {
+        pendingSelfTest = command.text.c_str();
+        selfTestDone = false;
+      }
+      return selfTestDone;
+    }
+    case EXIT: {
+      printf("headless: script finished after %lu ms, %lu frames, %d failures\r\n", (unsigned long)clock_millis_HAL(), (unsigned long)flushedFrames, failures);
+      exit(failures > 0 ? 1 : 0);
+    }
+  }
+  return true;
+}
+
+void headless_pointer_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data) {
+  uint32_t now = clock_millis_HAL();
+  while (currentCommand < commands.size()) {
+    bool firstCall = !currentCommandStarted;
+    if (firstCall) {
+      currentCommandStarted = true;
+      currentCommandStart = now;
+    }
+    if (!executeCommand(commands[currentCommand], firstCall, now - currentCommandStart)) {
+      break;
+    }
+    currentCommand++;
+    currentCommandStarted = false;
+  }
+
+  data->point = pointer;
+  data->state = pointerPressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+void set_runSelfTest_cb_HAL(tRunSelfTest_cb pRunSelfTest_cb) {
+  thisRunSelfTest_cb = pRunSelfTest_cb;
+}
+
+#if (ENABLE_SELFTESTS == 1)
+void set_touchPoint_HAL(lv_coord_t x, lv_coord_t y, bool pressed) {
+  pointer.x = x;
+  pointer.y = y;
+  pointerPressed = pressed;
+}
+#endif
+
+void headless_loop(void) {
+  if (pendingSelfTest == NULL) {
+    return;
+  }
+  // the tests run the main loop themselves, e.g. until queued commands are executed. They must not start again.
+  const char *name = pendingSelfTest;
+  pendingSelfTest = NULL;
+  int failed;
+  if (thisRunSelfTest_cb == NULL) {
+    printf("headless: selftest %s: no self tests in this build, use env:linux_64bit_selftest\r\n", name);
+    failed = 1;
+  } else {
+    failed = thisRunSelfTest_cb(name);
+    if (failed < 0) {
+      printf("headless: selftest %s: unknown test\r\n", name);
+      failed = 1;
+    }
+  }
+  printf("headless: selftest %s: %d failed checks\r\n", name, failed);
+  failures += failed;
+  selfTestDone = true;
+}
+
+void headless_init(void) {
+  framebuffer = (lv_color_t *) calloc(SDL_HOR_RES * SDL_VER_RES, sizeof(lv_color_t));
+  keypadKeys = loadKeypadMap();
+  loadScript();
+}
+
+#endif
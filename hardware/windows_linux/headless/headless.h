@@ -0,0 +1,40 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Headless simulator (build flag SIMULATOR_HEADLESS=1, see env:linux_64bit_headless in platformio.ini)
+// Instead of the SDL window, lvgl renders into an offscreen framebuffer. Instead of mouse and keypad window, the input comes from a script.
+// The script is read from the file given in the environment variable OMOTE_HEADLESS_SCRIPT. One command per line, '#' starts a comment:
+//   wait <ms>                          do nothing for ms milliseconds
+//   skip <ms>                          same as wait, but with the virtual clock (SIMULATOR_VIRTUAL_CLOCK=1) the time passes as fast as possible
+//   press <x> <y>                      touch down at x,y
+//   move <x> <y>                       move the touch point to x,y
+//   release                            lift the finger
+//   swipe <x1> <y1> <x2> <y2> <ms>     touch down at x1,y1, move to x2,y2 within ms milliseconds and release
+//   key <keyChar> [<ms>]               press the key on the keypad and release it after ms milliseconds (default 100)
+//   keydown <keyChar>                  press the key on the keypad
+//   keyup <keyChar>                    release the key on the keypad
+//   crc [<expected>]                   print the CRC32 of the framebuffer. If expected (hex) is given and differs, the simulator exits with 1 at the end.
+//   png <filename>                     save the framebuffer as PNG
+//   selftest <name>                    run the self test with this name, or all of them with "all". Needs ENABLE_SELFTESTS=1, see env:linux_64bit_selftest.
+//                                      Every failed check counts as failure.
+//   repeat <n>  ...  end               repeat the enclosed commands n times, can be nested
+//   exit                               end the simulator. The simulator also ends after the last command.
+// All times are in ms of clock_millis_HAL(). With the virtual clock, a script always gives the same frames.
+// Frame dumps show what was rendered until then. Add a "wait" before them to let animations finish.
+// Key chars are the ones from keypad_gui/buttons.map.json, e.g. 'k' for OK, 'r' for right and '1' to '4' for the scene keys.
+void headless_init(void);
+void headless_display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
+// is called periodically by lvgl, executes the script
+void headless_pointer_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+// called by clock_loop_HAL(), once per loop() and outside of lvgl. Runs a self test requested by the script.
+void headless_loop(void);
+
+// Self tests are registered by the application (src/applicationInternal/selfTests). The callback runs the test with this name, or all tests for "all".
+// It returns the number of failed checks, or -1 if there is no test with this name.
+typedef int (*tRunSelfTest_cb)(const char *name);
+void set_runSelfTest_cb_HAL(tRunSelfTest_cb pRunSelfTest_cb);
+#if (ENABLE_SELFTESTS == 1)
+// For the self tests: touch down at x,y, or lift the finger. The script does not move the pointer while a self test runs.
+void set_touchPoint_HAL(lv_coord_t x, lv_coord_t y, bool pressed);
+#endif
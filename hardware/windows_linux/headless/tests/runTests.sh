@@ -0,0 +1,41 @@
+#!/bin/sh
+# Runs the self tests in the headless simulator. Exits with 1 if one of them failed.
+# Build first with "pio run -e linux_64bit_selftest", then run this from the project folder:
+#   hardware/windows_linux/headless/tests/runTests.sh [program]
+# With the program of env:linux_64bit_selftest_tsan, the tests run with ENABLE_TASK_SPLIT=1 under ThreadSanitizer. A data race makes the run fail.
+PROGRAM=${1:-.pio/build/linux_64bit_selftest/program}
+TESTS=$(dirname "$0")
+FAILED=0
+
+run() {
+  echo "=== $1"
+  shift
+  if ! env "$@"; then
+    FAILED=1
+  fi
+}
+
+run "self tests" OMOTE_HEADLESS_SCRIPT="$TESTS/selfTests.txt" "$PROGRAM"
+
+# Wake snapshot: the first run ends as if going to deep sleep, the second one starts as after the wakeup
+RTC_MEMORY=$(mktemp)
+rm -f "$RTC_MEMORY"
+run "wake snapshot, before deep sleep" OMOTE_RTC_MEMORY_FILE="$RTC_MEMORY" OMOTE_HEADLESS_SCRIPT="$TESTS/wakeSnapshotSave.txt" "$PROGRAM"
+run "wake snapshot, after wakeup" OMOTE_RTC_MEMORY_FILE="$RTC_MEMORY" OMOTE_HEADLESS_SCRIPT="$TESTS/wakeSnapshotRestored.txt" "$PROGRAM"
+# damage the first byte of the scene name, the crc no longer matches
+printf '\377' | dd of="$RTC_MEMORY" bs=1 seek=8 conv=notrunc 2>/dev/null
+run "wake snapshot, damaged" OMOTE_RTC_MEMORY_FILE="$RTC_MEMORY" OMOTE_HEADLESS_SCRIPT="$TESTS/wakeSnapshotInvalid.txt" "$PROGRAM"
+rm -f "$RTC_MEMORY"
+
+# Wakeup by a key: the key that woke up the remote is sent as IR code after the wakeup
+RTC_MEMORY=$(mktemp)
+rm -f "$RTC_MEMORY"
+run "wakeup key, before deep sleep" OMOTE_RTC_MEMORY_FILE="$RTC_MEMORY" OMOTE_HEADLESS_SCRIPT="$TESTS/wakeupKeySleep.txt" "$PROGRAM"
+run "wakeup key, after wakeup" OMOTE_RTC_MEMORY_FILE="$RTC_MEMORY" OMOTE_WAKEUP_KEY=+ OMOTE_HEADLESS_SCRIPT="$TESTS/wakeupKey.txt" "$PROGRAM"
+rm -f "$RTC_MEMORY"
+
+if [ $FAILED -ne 0 ]; then
+  echo "=== FAILED"
+  exit 1
+fi
+echo "=== passed"
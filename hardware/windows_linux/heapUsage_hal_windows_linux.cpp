@@ -49,3 +49,12 @@ void get_heapUsage_HAL(unsigned long *heapSize, unsigned long *freeHeap, unsigne
   *maxAllocHeap = 0;
   *minFreeHeap = 0;
 }
+
+// no PSRAM in the simulator, large buffers are put into the normal heap
+void* malloc_largeBuffer_HAL(size_t size) {
+  return malloc(size);
+}
+
+void free_largeBuffer_HAL(void* buffer) {
+  free(buffer);
+}
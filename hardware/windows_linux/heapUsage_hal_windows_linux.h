@@ -1,3 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+
 void get_heapUsage_HAL(unsigned long *heapSize, unsigned long *freeHeap, unsigned long *maxAllocHeap, unsigned long *minFreeHeap);
+void* malloc_largeBuffer_HAL(size_t size);
+void free_largeBuffer_HAL(void* buffer);
@@ -1,8 +1,74 @@
-#include <string>
-#include <list>
+#include <stdint.h>
+#include "infrared_sender_hal_windows_linux.h"
+
+#if (ENABLE_SELFTESTS == 1)
+#include <SDL2/SDL_mutex.h>
+#include <string.h>
+#include "clock_hal_windows_linux.h"
+
+// The simulator has no IR LED. For the self tests, the last sent code is recorded instead.
+// Codes are sent by the command worker and read by the main thread, so the record is protected by a mutex.
+SDL_mutex *sentIRcodeMutex = SDL_CreateMutex();
+uint32_t sentIRcodeCount = 0;
+int      sentIRcodeProtocol = -1;
+uint64_t sentIRcodeData = 0;
+uint16_t sentIRcodeNbits = 0;
+uint16_t sentIRcodeRepeat = 0;
+uint16_t sentIRcodeTimings[SENT_IR_TIMINGS_MAX];
+uint16_t sentIRcodeTimingsLength = 0;
+uint32_t sentIRcodeFirstTime = UINT32_MAX;
+
+static void recordIRcode(int protocol, uint64_t data, uint16_t nbits, uint16_t repeat, const uint16_t *timings, uint16_t timingsLength) {
+  SDL_LockMutex(sentIRcodeMutex);
+  if (sentIRcodeCount == 0) {
+    sentIRcodeFirstTime = clock_millis_HAL();
+  }
+  sentIRcodeCount++;
+  sentIRcodeProtocol = protocol;
+  sentIRcodeData = data;
+  sentIRcodeNbits = nbits;
+  sentIRcodeRepeat = repeat;
+  sentIRcodeTimingsLength = (timingsLength < SENT_IR_TIMINGS_MAX) ? timingsLength : SENT_IR_TIMINGS_MAX;
+  if (sentIRcodeTimingsLength > 0) {
+    memcpy(sentIRcodeTimings, timings, sentIRcodeTimingsLength * sizeof(uint16_t));
+  }
+  SDL_UnlockMutex(sentIRcodeMutex);
+}
+
+uint32_t get_lastSentIRcode_HAL(int *protocol, uint64_t *data, uint16_t *nbits, uint16_t *repeat, uint16_t *timings, uint16_t *timingsLength) {
+  SDL_LockMutex(sentIRcodeMutex);
+  uint32_t count = sentIRcodeCount;
+  *protocol = sentIRcodeProtocol;
+  *data = sentIRcodeData;
+  *nbits = sentIRcodeNbits;
+  *repeat = sentIRcodeRepeat;
+  *timingsLength = sentIRcodeTimingsLength;
+  if (sentIRcodeTimingsLength > 0) {
+    memcpy(timings, sentIRcodeTimings, sentIRcodeTimingsLength * sizeof(uint16_t));
+  }
+  SDL_UnlockMutex(sentIRcodeMutex);
+  return count;
+}
+
+uint32_t get_firstSentIRcodeTime_HAL(void) {
+  SDL_LockMutex(sentIRcodeMutex);
+  uint32_t firstTime = sentIRcodeFirstTime;
+  SDL_UnlockMutex(sentIRcodeMutex);
+  return firstTime;
+}
+#endif
 
 void init_infraredSender_HAL(void) {
 }
 
-void sendIRcode_HAL(int protocol, std::list<std::string> commandPayloads, std::string additionalPayload) {
-}
\ No newline at end of file
+void sendIRcode_HAL(int protocol, uint64_t data, uint16_t nbits, uint16_t repeat) {
+  #if (ENABLE_SELFTESTS == 1)
+  recordIRcode(protocol, data, nbits, repeat, NULL, 0);
+  #endif
+}
+
+void sendIRcodeGC_HAL(const uint16_t *timings, uint16_t timingsLength) {
+  #if (ENABLE_SELFTESTS == 1)
+  recordIRcode(-1, 0, 0, 0, timings, timingsLength);
+  #endif
+}
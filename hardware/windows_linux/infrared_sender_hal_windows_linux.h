@@ -1,8 +1,18 @@
 #pragma once
 
-#include <string>
-#include <list>
+#include <stdint.h>
 
 // infrared
 void init_infraredSender_HAL(void);
-void sendIRcode_HAL(int protocol, std::list<std::string> commandPayloads, std::string additionalPayload);
\ No newline at end of file
+// IR codes are already parsed by the application, so the HAL only gets binary values
+void sendIRcode_HAL(int protocol, uint64_t data, uint16_t nbits, uint16_t repeat);
+void sendIRcodeGC_HAL(const uint16_t *timings, uint16_t timingsLength);
+
+#if (ENABLE_SELFTESTS == 1)
+// For the self tests: returns the number of IR codes sent so far, and the last one. For GC codes, protocol is -1 and timings are set.
+// 'timings' must have room for SENT_IR_TIMINGS_MAX values, longer GC codes are cut.
+#define SENT_IR_TIMINGS_MAX 128
+uint32_t get_lastSentIRcode_HAL(int *protocol, uint64_t *data, uint16_t *nbits, uint16_t *repeat, uint16_t *timings, uint16_t *timingsLength);
+// clock_millis_HAL() when the first IR code was sent, UINT32_MAX if none was sent yet
+uint32_t get_firstSentIRcodeTime_HAL(void);
+#endif
@@ -2,6 +2,7 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mutex.h>
 
 #include "key_map.h"
 
@@ -13,7 +14,30 @@ struct KeyPadManager {
 
 SDL_Surface* loadSurface( SDL_Surface* screenSurface );
 
-std::queue<KeyEvent> keyEventsQueue;
+static std::queue<KeyEvent> keyEventsQueue;
+static SDL_mutex *keyEventsQueueMutex = SDL_CreateMutex();
+
+void keyEventsQueue_push(const KeyEvent &event) {
+  SDL_LockMutex(keyEventsQueueMutex);
+  keyEventsQueue.push(event);
+  SDL_UnlockMutex(keyEventsQueueMutex);
+}
+bool keyEventsQueue_pop(KeyEvent *event) {
+  SDL_LockMutex(keyEventsQueueMutex);
+  bool available = !keyEventsQueue.empty();
+  if (available) {
+    *event = keyEventsQueue.front();
+    keyEventsQueue.pop();
+  }
+  SDL_UnlockMutex(keyEventsQueueMutex);
+  return available;
+}
+bool keyEventsQueue_isEmpty(void) {
+  SDL_LockMutex(keyEventsQueueMutex);
+  bool empty = keyEventsQueue.empty();
+  SDL_UnlockMutex(keyEventsQueueMutex);
+  return empty;
+}
 
 // https://wrfranklin.org/Research/Short_Notes/pnpoly.html
 int pnpoly(int nvert, float *vertx, float *verty, float testx, float testy)
@@ -76,8 +100,9 @@ int event_filter(void *userdata, SDL_Event * event) {
             keyEvent.keyChar = key.key;
             keyEvent.keyCode = key.id;
             keyEvent.keyState = event->type == SDL_MOUSEBUTTONDOWN ? PRESSED_SIMULATOR : RELEASED_SIMULATOR;
+            keyEvent.timestamp = mouse_event->timestamp;
             // printf("simulator click event: %c, %d %d, %d, added to queue\r\n", keyEvent.keyChar, keyEvent.keyCode/5, keyEvent.keyCode%5, keyEvent.keyState);
-            keyEventsQueue.push(keyEvent);
+            keyEventsQueue_push(keyEvent);
             break;
           }
         }
@@ -8,9 +8,14 @@ struct KeyEvent {
   char keyChar;
   int keyCode;
   guiKeyStates keyState;
+  // clock_millis_HAL() when the event was captured. For mouse clicks, this is the SDL timestamp, which is the same clock.
+  uint32_t timestamp;
 };
 
 SDL_Window* keypad_gui_setup();
 
-// A queue for all mouse events between two loops
-extern std::queue<KeyEvent> keyEventsQueue;
\ No newline at end of file
+// A queue for all mouse events between two loops.
+// Filled by the main thread. With ENABLE_TASK_SPLIT=1 it is read by the input task, so it is only accessed with these functions.
+void keyEventsQueue_push(const KeyEvent &event);
+bool keyEventsQueue_pop(KeyEvent *event);
+bool keyEventsQueue_isEmpty(void);
\ No newline at end of file
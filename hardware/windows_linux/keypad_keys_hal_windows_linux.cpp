@@ -1,50 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
 
 #include "keypad_gui/keypad_gui.h"
+#include "keypad_gui/key_map.h"
+#include "clock_hal_windows_linux.h"
+#include "sleep_hal_windows_linux.h"
+#include "keypad_keys_hal_windows_linux.h"
 
-void init_keys_HAL(void) {
-}
-
-// has to be exactly the same structure as in hardwarePresenter.h
 const uint8_t keypadROWS = 5; //five rows
 const uint8_t keypadCOLS = 5; //five columns
-enum keypad_rawKeyStates {IDLE_RAW, PRESSED_RAW,       RELEASED_RAW};
-struct rawKey {
-  unsigned long timestampReceived;
-  char keyChar;
-  keypad_rawKeyStates rawKeyState;
-};
 
-void keys_getKeys_HAL(void* ptr, unsigned long currentMillis) {
+tAnnounceKeypadEvent_cb thisAnnounceKeypadEvent_cb = NULL;
+void set_announceKeypadEvent_cb_HAL(tAnnounceKeypadEvent_cb pAnnounceKeypadEvent_cb) {
+  thisAnnounceKeypadEvent_cb = pAnnounceKeypadEvent_cb;
+}
+
+// the key from OMOTE_WAKEUP_KEY, pressed and released with the first keys_getEvents_HAL()
+static int wakeupKeyCode = -1;
+static char wakeupKeyChar = NO_KEY;
 
-  if (keyEventsQueue.empty()) {
+void init_keys_HAL(void) {
+  const char *wakeupKey = getenv("OMOTE_WAKEUP_KEY");
+  if (!get_wakeupFromDeepSleep_HAL() || (wakeupKey == NULL) || (wakeupKey[0] == NO_KEY)) {
     return;
   }
+  for (auto const &key : loadKeypadMap()) {
+    if (key.key == wakeupKey[0]) {
+      wakeupKeyCode = key.id;
+      wakeupKeyChar = key.key;
+      printf("simulating wakeup by key '%c'\r\n", wakeupKeyChar);
+      return;
+    }
+  }
+  printf("OMOTE_WAKEUP_KEY: unknown key '%c'\r\n", wakeupKey[0]);
+}
 
-  // https://stackoverflow.com/questions/68788080/is-it-possible-to-pass-a-2d-array-using-a-void-pointer-in-c
-  // https://www.geeksforgeeks.org/pass-2d-array-parameter-c/
-  // https://stackoverflow.com/questions/16724368/how-to-pass-a-2d-array-by-pointer-in-c
-  // cast the pointer to the same structure as in hardwarePresenter.h
-  rawKey (*rawKeys)[keypadCOLS] = static_cast<rawKey (*)[keypadCOLS]>(ptr);
+void keys_getEvents_HAL(unsigned long currentMillis) {
 
-  // get first event in queue
-  KeyEvent event = keyEventsQueue.front();
+  // Like the TCA8418, which keeps the key that woke up the remote in its FIFO until the main loop reads it
+  if (wakeupKeyCode >= 0) {
+    keyEventsQueue_push(KeyEvent{wakeupKeyChar, wakeupKeyCode, PRESSED_SIMULATOR, clock_millis_HAL()});
+    keyEventsQueue_push(KeyEvent{wakeupKeyChar, wakeupKeyCode, RELEASED_SIMULATOR, clock_millis_HAL()});
+    wakeupKeyCode = -1;
+  }
 
-  // get the row and col from the lastActiveKey
-  uint8_t row = event.keyCode / keypadROWS;
-  uint8_t col = event.keyCode % keypadCOLS;
+  // This is the stand-in for the event FIFO of the TCA8418: all mouse clicks on the keypad window since the last call
+  KeyEvent event;
+  while (keyEventsQueue_pop(&event)) {
 
-  rawKeys[row][col].timestampReceived = currentMillis;
+    // get the row and col from the lastActiveKey
+    uint8_t row = event.keyCode / keypadROWS;
+    uint8_t col = event.keyCode % keypadCOLS;
 
-  rawKeys[row][col].keyChar = event.keyChar;
-  if (event.keyState == PRESSED_SIMULATOR) {
-    rawKeys[row][col].rawKeyState = PRESSED_RAW;
+    // Find out how long ago the event was captured
+    unsigned long timestamp = currentMillis - (clock_millis_HAL() - event.timestamp);
 
-  } else if (event.keyState == RELEASED_SIMULATOR) {
-    rawKeys[row][col].rawKeyState = RELEASED_RAW;
+    // printf("simulator key event: %c, %d %d, %d, removed from queue\r\n", event.keyChar, row, col, event.keyState);
+    if (thisAnnounceKeypadEvent_cb != NULL) {
+      thisAnnounceKeypadEvent_cb(timestamp, row, col, event.keyChar, event.keyState == PRESSED_SIMULATOR);
+    }
   }
+}
+
+bool keys_canSignalEvents_HAL(void) {
+  return true;
+}
 
-  // printf("simulator key event: %c, %d %d, %d, removed from queue\r\n", rawKeys[row][col].keyChar, row, col, rawKeys[row][col].rawKeyState);
-  // remove first event
-  keyEventsQueue.pop();
-}
\ No newline at end of file
+bool keys_isEventPending_HAL(void) {
+  return (wakeupKeyCode >= 0) || !keyEventsQueue_isEmpty();
+}
+
+#if (ENABLE_SELFTESTS == 1)
+bool keys_pushEvent_HAL(char keyChar, bool pressed, uint32_t capturedAt) {
+  static std::vector<KeyPadKey> keypadKeys = loadKeypadMap();
+  for (auto const &key : keypadKeys) {
+    if (key.key == keyChar) {
+      keyEventsQueue_push(KeyEvent{key.key, key.id, pressed ? PRESSED_SIMULATOR : RELEASED_SIMULATOR, capturedAt});
+      return true;
+    }
+  }
+  return false;
+}
+#endif
@@ -1,4 +1,19 @@
 #pragma once
 
+#include <stdint.h>
+
+// After a simulated wakeup from deep sleep (see sleep_hal_windows_linux.h), the environment variable OMOTE_WAKEUP_KEY can give the key that woke up the remote,
+// e.g. OMOTE_WAKEUP_KEY=k. It is pressed and released as soon as the main loop runs, like on the ESP32.
 void init_keys_HAL(void);
-void keys_getKeys_HAL(void* ptr, unsigned long currentMillis);
+// Reads all new keypad events from the hardware and announces each of them with the time it was captured.
+void keys_getEvents_HAL(unsigned long currentMillis);
+typedef void (*tAnnounceKeypadEvent_cb)(unsigned long timestamp, uint8_t row, uint8_t col, char keyChar, bool pressed);
+void set_announceKeypadEvent_cb_HAL(tAnnounceKeypadEvent_cb pAnnounceKeypadEvent_cb);
+// true if the hardware tells when there are new events. Like the TCA8418, the simulator does.
+bool keys_canSignalEvents_HAL(void);
+// true if keys_getEvents_HAL() would get new events
+bool keys_isEventPending_HAL(void);
+#if (ENABLE_SELFTESTS == 1)
+// For the self tests: a click on the keypad window at capturedAt (clock_millis_HAL()), without the window. Returns false for an unknown key.
+bool keys_pushEvent_HAL(char keyChar, bool pressed, uint32_t capturedAt);
+#endif
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include "clock_hal_windows_linux.h"
+#include "ledFade_hal_windows_linux.h"
+
+#define LEDFADE_CHANNEL_COUNT 2
+// number of fade curves kept per channel
+#define LEDFADE_HISTORY_SIZE 16
+
+struct t_ledFadeChannel {
+  // ring buffer of the last fades
+  ledFadeCurve curves[LEDFADE_HISTORY_SIZE];
+  uint8_t curveCount;
+  uint8_t nextCurve;
+};
+t_ledFadeChannel ledFadeChannels[LEDFADE_CHANNEL_COUNT] = {};
+const char *ledFadeChannelNames[LEDFADE_CHANNEL_COUNT] = {"backlight", "keyboard"};
+
+// the most recent fade of a channel, NULL if there was none
+static const ledFadeCurve* lastCurve(uint8_t fadeChannel) {
+  t_ledFadeChannel *ch = &ledFadeChannels[fadeChannel];
+  if (ch->curveCount == 0) {
+    return NULL;
+  }
+  return &ch->curves[(ch->nextCurve + LEDFADE_HISTORY_SIZE - 1) % LEDFADE_HISTORY_SIZE];
+}
+
+static uint8_t dutyOfCurveAt(const ledFadeCurve *curve, uint32_t time_ms) {
+  uint32_t elapsed = time_ms - curve->start_ms;
+  if ((curve->fadeTime_ms == 0) || (elapsed >= curve->fadeTime_ms)) {
+    return curve->toDuty;
+  }
+  // the same linear fade as done by the LEDC hardware
+  return curve->fromDuty + ((int32_t)curve->toDuty - curve->fromDuty) * (int32_t)elapsed / (int32_t)curve->fadeTime_ms;
+}
+
+void init_ledFade_HAL(void) {}
+
+void ledFade_setTarget_HAL(uint8_t fadeChannel, uint8_t targetDuty, uint32_t fadeTime_ms) {
+  if (fadeChannel >= LEDFADE_CHANNEL_COUNT) {
+    return;
+  }
+  uint32_t now = clock_millis_HAL();
+  const ledFadeCurve *last = lastCurve(fadeChannel);
+  uint8_t currentDuty = 0;
+  if (last != NULL) {
+    if (targetDuty == last->toDuty) {
+      return;
+    }
+    if (now - last->start_ms < last->fadeTime_ms) {
+      // still fading, the LEDC hardware would not accept a new fade either
+      return;
+    }
+    currentDuty = last->toDuty;
+  } else if (targetDuty == 0) {
+    return;
+  }
+
+  t_ledFadeChannel *ch = &ledFadeChannels[fadeChannel];
+  ch->curves[ch->nextCurve] = ledFadeCurve{now, currentDuty, targetDuty, fadeTime_ms};
+  ch->nextCurve = (ch->nextCurve + 1) % LEDFADE_HISTORY_SIZE;
+  if (ch->curveCount < LEDFADE_HISTORY_SIZE) {
+    ch->curveCount++;
+  }
+  printf("%s fades from %u to %u in %u ms\r\n", ledFadeChannelNames[fadeChannel], currentDuty, targetDuty, fadeTime_ms);
+}
+
+uint8_t ledFade_getTarget_HAL(uint8_t fadeChannel) {
+  if (fadeChannel >= LEDFADE_CHANNEL_COUNT) {
+    return 0;
+  }
+  const ledFadeCurve *last = lastCurve(fadeChannel);
+  return (last != NULL) ? last->toDuty : 0;
+}
+
+uint8_t ledFade_getDutyAt_HAL(uint8_t fadeChannel, uint32_t time_ms) {
+  if (fadeChannel >= LEDFADE_CHANNEL_COUNT) {
+    return 0;
+  }
+  t_ledFadeChannel *ch = &ledFadeChannels[fadeChannel];
+  // search the last curve which started before time_ms
+  for (uint8_t i = 1; i <= ch->curveCount; i++) {
+    const ledFadeCurve *curve = &ch->curves[(ch->nextCurve + LEDFADE_HISTORY_SIZE - i) % LEDFADE_HISTORY_SIZE];
+    if ((int32_t)(time_ms - curve->start_ms) >= 0) {
+      return dutyOfCurveAt(curve, time_ms);
+    }
+  }
+  // before the first recorded curve
+  return (ch->curveCount > 0) ? ch->curves[(ch->nextCurve + LEDFADE_HISTORY_SIZE - ch->curveCount) % LEDFADE_HISTORY_SIZE].fromDuty : 0;
+}
+
+uint8_t ledFade_getCurves_HAL(uint8_t fadeChannel, ledFadeCurve *curves, uint8_t maxCurves) {
+  if (fadeChannel >= LEDFADE_CHANNEL_COUNT) {
+    return 0;
+  }
+  t_ledFadeChannel *ch = &ledFadeChannels[fadeChannel];
+  uint8_t count = (ch->curveCount < maxCurves) ? ch->curveCount : maxCurves;
+  for (uint8_t i = 0; i < count; i++) {
+    curves[i] = ch->curves[(ch->nextCurve + LEDFADE_HISTORY_SIZE - count + i) % LEDFADE_HISTORY_SIZE];
+  }
+  return count;
+}
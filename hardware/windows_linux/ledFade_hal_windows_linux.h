@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fade engine for the display and keyboard backlight. Same contract as on the ESP32, where a fade runs in the LEDC hardware.
+// Here it is only a software model: every fade is recorded as a linear curve, so that the duty at any time can be calculated.
+#define LEDFADE_CHANNEL_BACKLIGHT 0
+#define LEDFADE_CHANNEL_KEYBOARD  1
+
+void init_ledFade_HAL(void);
+// Fades the channel from its current duty to targetDuty in fadeTime_ms. Does nothing if this is already the target.
+// If the channel is still fading to another target, the new target is ignored. Call it again later, e.g. on every update.
+void ledFade_setTarget_HAL(uint8_t fadeChannel, uint8_t targetDuty, uint32_t fadeTime_ms);
+// the duty the channel is fading to, or has reached
+uint8_t ledFade_getTarget_HAL(uint8_t fadeChannel);
+
+// only in the software model
+struct ledFadeCurve {
+  uint32_t start_ms;
+  uint8_t fromDuty;
+  uint8_t toDuty;
+  uint32_t fadeTime_ms;
+};
+// the duty the channel had at time_ms (clock_millis_HAL), calculated from the recorded fade curves
+uint8_t ledFade_getDutyAt_HAL(uint8_t fadeChannel, uint32_t time_ms);
+// the last fade curves of a channel, oldest first. Returns the number of curves copied into curves.
+uint8_t ledFade_getCurves_HAL(uint8_t fadeChannel, ledFadeCurve *curves, uint8_t maxCurves);
@@ -1,34 +1,67 @@
 #include <stdlib.h>
 #include <sys/time.h>
 #include <lvgl.h>
-#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_timer.h>
 #include "sdl/sdl.h"
 #include "SDL2/SDL_events.h"
 
 #include "keypad_gui/keypad_gui.h"
-
-/**
- * A task to measure the elapsed time for LittlevGL
- * @param data unused
- * @return never return
- */
-static int tick_thread(void * data)
+#if (SIMULATOR_HEADLESS == 1)
+#include "headless/headless.h"
+#endif
+#include "clock_hal_windows_linux.h"
+#include "lvgl_hal_windows_linux.h"
+
+// Tells lvgl how much time has elapsed. Called every LVGL_TICK_PERIOD_MS by the SDL timer thread, which sleeps in between.
+// The interval of an SDL timer is not exact, so the elapsed time is taken from the SDL clock.
+#define LVGL_TICK_PERIOD_MS 5
+static Uint64 lastTickTimestamp = 0;
+static Uint32 tick_timer_cb(Uint32 interval, void *param)
 {
-    Uint64 lastTimestamp = SDL_GetTicks64();
-    Uint64 newTimestamp = 0;
-    while(1) {
-        // we don't use this blackbox
-        // SDL_Delay(5);   /*Sleep for 5 millisecond*/
-        // lv_tick_inc(5); /*Tell lvgl that 5 milliseconds were elapsed*/
-
-        newTimestamp = SDL_GetTicks64();
-        if ((newTimestamp - lastTimestamp) > 5) {
-          lv_tick_inc(newTimestamp - lastTimestamp);
-          lastTimestamp = newTimestamp;
-        }
-    }
-
-    return 0;
+    Uint64 newTimestamp = SDL_GetTicks64();
+    lv_tick_inc(newTimestamp - lastTickTimestamp);
+    lastTickTimestamp = newTimestamp;
+
+    return interval;
+}
+
+tAnnounceFrameTiming_cb thisAnnounceFrameTiming_cb = NULL;
+void set_announceFrameTiming_cb_HAL(tAnnounceFrameTiming_cb pAnnounceFrameTiming_cb) {
+  thisAnnounceFrameTiming_cb = pAnnounceFrameTiming_cb;
+}
+
+// timing of the frame currently refreshed, the same way as it is done for the ESP32
+static Uint64 frameStart = 0;
+static Uint64 frameFlush = 0;
+static uint32_t framePixels = 0;
+
+static uint32_t performanceCounter_to_us(Uint64 counter) {
+  return counter * 1000000 / SDL_GetPerformanceFrequency();
+}
+
+static void render_start(lv_disp_drv_t *disp) {
+  frameStart = SDL_GetPerformanceCounter();
+  frameFlush = 0;
+  framePixels = 0;
+}
+
+// The SDL driver (and the headless framebuffer) copies the band synchronously into the window texture, so there is no overlap of rendering and flushing
+static void disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+  Uint64 flushStart = SDL_GetPerformanceCounter();
+  framePixels += (area->x2 - area->x1 + 1) * (area->y2 - area->y1 + 1);
+  bool isLast = lv_disp_flush_is_last(disp);
+
+  #if (SIMULATOR_HEADLESS == 1)
+  headless_display_flush(disp, area, color_p);
+  #else
+  sdl_display_flush(disp, area, color_p);
+  #endif
+
+  Uint64 now = SDL_GetPerformanceCounter();
+  frameFlush += now - flushStart;
+  if (isLast && (thisAnnounceFrameTiming_cb != NULL)) {
+    thisAnnounceFrameTiming_cb(performanceCounter_to_us(now - frameStart - frameFlush), performanceCounter_to_us(frameFlush), framePixels);
+  }
 }
 
 static lv_disp_draw_buf_t draw_buf;
@@ -54,12 +87,23 @@ void init_lvgl_HAL() {
   lv_disp_drv_init( &disp_drv );
   disp_drv.hor_res = SDL_HOR_RES;
   disp_drv.ver_res = SDL_VER_RES;
-  disp_drv.flush_cb = sdl_display_flush;    /*Used when `LV_VDB_SIZE != 0` in lv_conf.h (buffered drawing)*/
+  disp_drv.flush_cb = disp_flush;           /*Used when `LV_VDB_SIZE != 0` in lv_conf.h (buffered drawing)*/
+  disp_drv.render_start_cb = render_start;
   disp_drv.draw_buf = &draw_buf;
   //disp_drv.disp_fill = monitor_fill;      /*Used when `LV_VDB_SIZE == 0` in lv_conf.h (unbuffered drawing)*/
   //disp_drv.disp_map = monitor_map;        /*Used when `LV_VDB_SIZE == 0` in lv_conf.h (unbuffered drawing)*/
   lv_disp_drv_register( &disp_drv );
 
+  #if (SIMULATOR_HEADLESS == 1)
+  // No SDL window and no mouse. Touch and keypad input come from a script.
+  static lv_indev_drv_t indev_drv_script;
+  lv_indev_drv_init( &indev_drv_script );
+  indev_drv_script.type = LV_INDEV_TYPE_POINTER;
+  indev_drv_script.read_cb = headless_pointer_read;
+  lv_indev_drv_register( &indev_drv_script );
+
+  headless_init();
+  #else
   /* Add the mouse as input device
    * Use the 'mouse' driver which reads the PC's mouse*/
   static lv_indev_drv_t indev_drv_mouse;
@@ -106,9 +150,13 @@ void init_lvgl_HAL() {
   SDL_GetWindowPosition(keypadWindow, &x, &y);
   SDL_SetWindowPosition(mSimWindow, x - (SDL_HOR_RES * SDL_ZOOM) / 2 - 10, y);
   SDL_SetWindowPosition(keypadWindow, x + (SDL_HOR_RES * SDL_ZOOM) / 2 + 10, y);
+  #endif
 
   /* Tick init.
    * You have to call 'lv_tick_inc()' in periodically to inform lvgl about how much time were elapsed
-   * Create an SDL thread to do this*/
-  SDL_CreateThread(tick_thread, "tick", NULL);
+   * Create an SDL timer to do this. The virtual clock does this on its own.*/
+  if (!clock_isVirtual_HAL()) {
+    lastTickTimestamp = SDL_GetTicks64();
+    SDL_AddTimer(LVGL_TICK_PERIOD_MS, tick_timer_cb, NULL);
+  }
 }
@@ -1,3 +1,8 @@
 #pragma once
 
+#include <stdint.h>
+
 void init_lvgl_HAL();
+// Timing of every frame refreshed by lvgl, in microseconds. render_us: time lvgl was rendering, flush_us: time lvgl was sending to or waiting for the display.
+typedef void (*tAnnounceFrameTiming_cb)(uint32_t render_us, uint32_t flush_us, uint32_t pixels);
+void set_announceFrameTiming_cb_HAL(tAnnounceFrameTiming_cb pAnnounceFrameTiming_cb);
@@ -142,7 +142,18 @@ std::string getMACaddress() {
 }
 #endif
 
+#if (ENABLE_SELFTESTS == 1)
+#include <atomic>
+std::atomic<uint32_t> publishedMQTTMessageCount(0);
+uint32_t get_publishedMQTTMessageCount_HAL(void) {
+  return publishedMQTTMessageCount.load();
+}
+#endif
+
 void init_mqtt_HAL(void) {
+  #if (ENABLE_SELFTESTS == 1)
+  return;
+  #endif
   #if defined(WIN32)
     WSADATA wsaData;
     int iResult = WSAStartup(MAKEWORD(2, 2), &wsaData);
@@ -196,6 +207,10 @@ void mqtt_loop_HAL() {
 }
 
 bool publishMQTTMessage_HAL(const char *topic, const char *payload) {
+    #if (ENABLE_SELFTESTS == 1)
+    publishedMQTTMessageCount++;
+    return true;
+    #endif
 
     if (sockfd == -1) {
       init_mqtt_HAL();
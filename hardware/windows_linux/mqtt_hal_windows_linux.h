@@ -1,12 +1,18 @@
 #pragma once
 
 #if (ENABLE_WIFI_AND_MQTT == 1)
+#include <stdint.h>
+#include <string>
 
 void init_mqtt_HAL(void);
 bool getIsWifiConnected_HAL();
 void mqtt_loop_HAL();
 bool publishMQTTMessage_HAL(const char *topic, const char *payload);
 void wifi_shutdown_HAL();
+#if (ENABLE_SELFTESTS == 1)
+// For the self tests, no broker is contacted, so that they do not depend on the network. Messages are only counted.
+uint32_t get_publishedMQTTMessageCount_HAL(void);
+#endif
 
 typedef void (*tAnnounceWiFiconnected_cb)(bool connected);
 void set_announceWiFiconnected_cb_HAL(tAnnounceWiFiconnected_cb pAnnounceWiFiconnected_cb);
@@ -1,5 +1,9 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
+#include "clock_hal_windows_linux.h"
+#include "sleep_hal_windows_linux.h"
 
 // is "lift to wake" enabled
 bool wakeupByIMUEnabled = true;
@@ -8,10 +12,75 @@ uint32_t sleepTimeout;
 // threshold for motion detection
 uint8_t motionThreshold;
 
-void init_sleep_HAL() {}
+static uint8_t rtcMemory[RTC_MEMORY_SIZE];
+static bool wakeupFromDeepSleep = false;
+static tAnnounceGoingToSleep_cb thisAnnounceGoingToSleep_cb = NULL;
+void set_announceGoingToSleep_cb_HAL(tAnnounceGoingToSleep_cb pAnnounceGoingToSleep_cb) {
+  thisAnnounceGoingToSleep_cb = pAnnounceGoingToSleep_cb;
+}
+uint8_t *get_rtcMemory_HAL() {
+  return rtcMemory;
+}
+bool get_wakeupFromDeepSleep_HAL() {
+  return wakeupFromDeepSleep;
+}
+
+// called by exit(), which is also used when the window is closed and at the end of a headless script
+static void simulateDeepSleep() {
+  const char *filename = getenv("OMOTE_RTC_MEMORY_FILE");
+  if (thisAnnounceGoingToSleep_cb != NULL) {
+    thisAnnounceGoingToSleep_cb();
+  }
+  FILE *file = fopen(filename, "wb");
+  if ((file == NULL) || (fwrite(rtcMemory, 1, RTC_MEMORY_SIZE, file) != RTC_MEMORY_SIZE)) {
+    printf("cannot save RTC memory to %s\r\n", filename);
+  } else {
+    printf("RTC memory saved to %s\r\n", filename);
+  }
+  if (file != NULL) {
+    fclose(file);
+  }
+}
+
+void init_sleep_HAL() {
+  const char *filename = getenv("OMOTE_RTC_MEMORY_FILE");
+  if (filename == NULL) {
+    return;
+  }
+  // no file yet: like power on
+  FILE *file = fopen(filename, "rb");
+  if (file != NULL) {
+    wakeupFromDeepSleep = (fread(rtcMemory, 1, RTC_MEMORY_SIZE, file) == RTC_MEMORY_SIZE);
+    fclose(file);
+    if (wakeupFromDeepSleep) {
+      printf("RTC memory loaded from %s, simulating wakeup from deep sleep\r\n", filename);
+    } else {
+      memset(rtcMemory, 0, RTC_MEMORY_SIZE);
+    }
+  }
+  atexit(&simulateDeepSleep);
+}
 void init_IMU_HAL(void) {}
 void check_activity_HAL() {}
-void setLastActivityTimestamp_HAL() {}
+// the simulator never goes to sleep, the timestamp is only kept for the energy model
+uint32_t lastActivityTimestamp = 0;
+void setLastActivityTimestamp_HAL() {
+  lastActivityTimestamp = clock_millis_HAL();
+}
+uint32_t get_lastActivityTimestamp_HAL() {
+  return lastActivityTimestamp;
+}
+
+// there is no light sleep in the simulator, the host sleeps instead
+void idle_HAL(uint32_t timeTillNextDeadline_ms) {
+  clock_idle_HAL(timeTillNextDeadline_ms);
+}
+void wakeIdle_HAL(void) {
+  clock_wakeIdle_HAL();
+}
+uint64_t get_idleSleepTime_us_HAL() {
+  return clock_getIdleSleepTime_us_HAL();
+}
 
 uint32_t get_sleepTimeout_HAL() {
   return sleepTimeout;
@@ -1,9 +1,23 @@
 #pragma once
 
+#include <stdint.h>
+
 void init_sleep_HAL();
+// Simulates the RTC memory of the ESP32, which keeps its content in deep sleep.
+// The simulator never sleeps. If the environment variable OMOTE_RTC_MEMORY_FILE is set, the RTC memory is saved to this file when the simulator ends,
+// as if it went to deep sleep. On the next start, it is loaded from there and the simulator behaves as after a wakeup from deep sleep.
+bool get_wakeupFromDeepSleep_HAL();
+#define RTC_MEMORY_SIZE 128
+uint8_t *get_rtcMemory_HAL();
+typedef void (*tAnnounceGoingToSleep_cb)(void);
+void set_announceGoingToSleep_cb_HAL(tAnnounceGoingToSleep_cb pAnnounceGoingToSleep_cb);
 void init_IMU_HAL();
 void check_activity_HAL();
 void setLastActivityTimestamp_HAL();
+uint32_t get_lastActivityTimestamp_HAL();
+void idle_HAL(uint32_t timeTillNextDeadline_ms);
+void wakeIdle_HAL(void);
+uint64_t get_idleSleepTime_us_HAL();
 
 uint32_t get_sleepTimeout_HAL();
 void set_sleepTimeout_HAL(uint32_t aSleepTimeout);
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_timer.h>
+#include "clock_hal_windows_linux.h"
+#include "tasks_hal_windows_linux.h"
+
+struct t_task {
+  const char *name;
+  tTaskLoop_cb loop_cb;
+  SDL_Thread *thread;
+  SDL_sem *wakeupSemaphore;
+  uint64_t start_us;
+  // written by the thread itself, read by the statistics
+  std::atomic<uint64_t> sleepTime_us;
+  std::atomic<bool> stopRequested;
+};
+static t_task tasks[TASKS_MAX];
+static std::atomic<uint8_t> taskCount(0);
+
+static uint64_t now_us() {
+  return SDL_GetPerformanceCounter() * 1000000 / SDL_GetPerformanceFrequency();
+}
+
+// the main thread is registered when the first task is started
+static void registerMainLoop() {
+  if (taskCount > 0) {
+    return;
+  }
+  // atexit() calls in reverse order, so this is before the simulated deep sleep, which was registered by init_sleep_HAL()
+  atexit(&tasks_stop_HAL);
+  t_task *t = &tasks[0];
+  t->name = "gui (loop)";
+  t->loop_cb = NULL;
+  t->thread = NULL;
+  t->wakeupSemaphore = NULL;
+  t->start_us = now_us();
+  t->sleepTime_us = 0;
+  taskCount = 1;
+}
+
+static int taskThreadFunction(void *data) {
+  t_task *t = (t_task *)data;
+  while (!t->stopRequested) {
+    uint32_t sleep_ms = t->loop_cb();
+    if ((sleep_ms == 0) || t->stopRequested) {
+      continue;
+    }
+    uint64_t start = now_us();
+    if (sleep_ms == UINT32_MAX) {
+      SDL_SemWait(t->wakeupSemaphore);
+    } else {
+      SDL_SemWaitTimeout(t->wakeupSemaphore, sleep_ms);
+    }
+    // several wakeups are merged into one
+    while (SDL_SemTryWait(t->wakeupSemaphore) == 0) {}
+    t->sleepTime_us += now_us() - start;
+  }
+  return 0;
+}
+
+uint8_t tasks_start_HAL(const char *name, tTaskLoop_cb pTaskLoop_cb, uint32_t stackSize, int8_t core, uint8_t priority) {
+  registerMainLoop();
+  if (taskCount >= TASKS_MAX) {
+    printf("cannot start task %s, increase TASKS_MAX\r\n", name);
+    return UINT8_MAX;
+  }
+  uint8_t taskId = taskCount;
+  t_task *t = &tasks[taskId];
+  t->name = name;
+  t->loop_cb = pTaskLoop_cb;
+  t->wakeupSemaphore = SDL_CreateSemaphore(0);
+  t->start_us = now_us();
+  t->sleepTime_us = 0;
+  t->stopRequested = false;
+  t->thread = SDL_CreateThread(taskThreadFunction, name, t);
+  // only now the task is complete for tasks_wake_HAL()
+  taskCount = taskId + 1;
+  return taskId;
+}
+
+void tasks_wake_HAL(uint8_t taskId) {
+  if (taskId >= taskCount) {
+    return;
+  }
+  if (taskId == 0) {
+    clock_wakeIdle_HAL();
+  } else {
+    SDL_SemPost(tasks[taskId].wakeupSemaphore);
+  }
+}
+
+void tasks_stop_HAL(void) {
+  // task 0 is the main thread, which calls this
+  for (uint8_t i = 1; i < taskCount; i++) {
+    tasks[i].stopRequested = true;
+    SDL_SemPost(tasks[i].wakeupSemaphore);
+  }
+  for (uint8_t i = 1; i < taskCount; i++) {
+    SDL_WaitThread(tasks[i].thread, NULL);
+    tasks[i].thread = NULL;
+  }
+}
+
+uint8_t tasks_getCount_HAL(void) {
+  return taskCount;
+}
+
+taskStatistics_HAL tasks_getStatistics_HAL(uint8_t taskId) {
+  if (taskId >= taskCount) {
+    return taskStatistics_HAL{"", TASKS_NO_CORE, 0, 0, 0};
+  }
+  t_task *t = &tasks[taskId];
+  uint64_t lifeTime_us = now_us() - t->start_us;
+  // the main thread sleeps in clock_idle_HAL(). Only read by the main thread itself.
+  uint64_t sleepTime_us = (taskId == 0) ? clock_getIdleSleepTime_us_HAL() : t->sleepTime_us.load();
+  return taskStatistics_HAL{t->name, TASKS_NO_CORE, (sleepTime_us < lifeTime_us) ? lifeTime_us - sleepTime_us : 0, lifeTime_us, 0};
+}
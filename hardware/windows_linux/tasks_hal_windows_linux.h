@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// Same task layout as on the ESP32 (ENABLE_TASK_SPLIT=1), but with SDL threads instead of FreeRTOS tasks. env:linux_64bit_selftest_tsan checks it with ThreadSanitizer.
+// Each task calls its callback in a loop. The callback returns the ms until it has to run again, the task sleeps until then or until tasks_wake_HAL() is called.
+// The main thread, which runs loop(), is counted as task 0. It sleeps in clock_idle_HAL().
+#define TASKS_MAX 4
+#define TASKS_NO_CORE -1
+typedef uint32_t (*tTaskLoop_cb)(void);
+// returns the id of the new task. There is no core affinity and no priority in the simulator.
+uint8_t tasks_start_HAL(const char *name, tTaskLoop_cb pTaskLoop_cb, uint32_t stackSize, int8_t core, uint8_t priority);
+// lets the task run as soon as possible. Can be called from any thread.
+void tasks_wake_HAL(uint8_t taskId);
+// Each task finishes the pass of its callback, then its thread ends. Returns when all threads have ended.
+// Called at exit, before the simulated deep sleep, like enterSleep() on the ESP32 does it before the radios are shut down.
+void tasks_stop_HAL(void);
+
+struct taskStatistics_HAL {
+  const char *name;
+  int8_t core;
+  // time the task was not sleeping, since it was started
+  uint64_t awakeTime_us;
+  uint64_t lifeTime_us;
+  // bytes of the stack that were never used. Not known in the simulator, always 0.
+  uint32_t stackHighWaterMark;
+};
+uint8_t tasks_getCount_HAL(void);
+taskStatistics_HAL tasks_getStatistics_HAL(uint8_t taskId);
@@ -1,11 +1,15 @@
 #include <stdio.h>
 #include <stdint.h>
+#include "ledFade_hal_windows_linux.h"
 
 uint8_t backlightBrightness = 255;
+// same as on the ESP32
+#define BACKLIGHT_FADE_TIME_MS 200
 
 void update_backlightBrightness_HAL(void) {
-  // nothing to do, we don't want to dim the simulator
-
+  // we don't want to dim the simulator. Only the fade in and changes of the brightness are recorded by the fade model.
+  uint32_t fadeTime = (ledFade_getTarget_HAL(LEDFADE_CHANNEL_BACKLIGHT) == 0) ? backlightBrightness : BACKLIGHT_FADE_TIME_MS;
+  ledFade_setTarget_HAL(LEDFADE_CHANNEL_BACKLIGHT, backlightBrightness, fadeTime);
 };
 uint8_t get_backlightBrightness_HAL() {
   return backlightBrightness;
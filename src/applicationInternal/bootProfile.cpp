@@ -0,0 +1,58 @@
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/bootProfile.h"
+#include "applicationInternal/omote_log.h"
+
+static bootPhase bootPhases[BOOT_PROFILE_MAX_PHASES];
+static uint8_t bootPhaseCount = 0;
+// micros() when the last phase of setup() was done
+static unsigned long lastPhaseDone_us = 0;
+
+static void addPhase(const char *name, unsigned long start_us, unsigned long end_us, bool deferred) {
+  if (bootPhaseCount == BOOT_PROFILE_MAX_PHASES) {
+    omote_log_w("bootProfile: more than %d phases, phase %s is not recorded\r\n", BOOT_PROFILE_MAX_PHASES, name);
+    return;
+  }
+  bootPhases[bootPhaseCount] = bootPhase{name, (uint32_t)start_us, (uint32_t)(end_us - start_us), deferred};
+  bootPhaseCount++;
+}
+
+void bootProfile_start(void) {
+  lastPhaseDone_us = micros();
+  addPhase("before setup()", 0, lastPhaseDone_us, false);
+}
+
+void bootProfile_phaseDone(const char *name) {
+  unsigned long now = micros();
+  addPhase(name, lastPhaseDone_us, now, false);
+  lastPhaseDone_us = now;
+}
+
+void bootProfile_deferredPhaseDone(const char *name, unsigned long start_us) {
+  addPhase(name, start_us, micros(), true);
+}
+
+void bootProfile_print(void) {
+  uint32_t setup_us = 0;
+  uint32_t deferred_us = 0;
+  omote_log_i("bootProfile:   start ms  duration ms  phase\r\n");
+  for (uint8_t i = 0; i < bootPhaseCount; i++) {
+    const bootPhase &phase = bootPhases[i];
+    omote_log_i("bootProfile: %10.1f %12.1f  %s%s\r\n", phase.start_us / 1000.0f, phase.duration_us / 1000.0f, phase.deferred ? "*" : "", phase.name);
+    if (phase.deferred) {
+      deferred_us += phase.duration_us;
+    } else {
+      setup_us += phase.duration_us;
+    }
+  }
+  omote_log_i("bootProfile: setup() until first frame and keys %.1f ms, deferred (*) %.1f ms\r\n", setup_us / 1000.0f, deferred_us / 1000.0f);
+}
+
+uint8_t bootProfile_getPhaseCount(void) {
+  return bootPhaseCount;
+}
+bootPhase bootProfile_getPhase(uint8_t index) {
+  if (index >= bootPhaseCount) {
+    return bootPhase{"", 0, 0, false};
+  }
+  return bootPhases[index];
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// How long each phase of the startup takes.
+// setup() only brings up what the first frame and the first key press need. Everything else (BLE keyboard, WiFi) is done afterwards by the
+// "deferredInit" task of the scheduler, one phase per pass, so that keys and GUI already work in between. Deferred phases are marked with '*'.
+// The profile is logged with omote_log_i when the last deferred phase is done. Times are real time, also with the virtual clock of the simulator.
+#define BOOT_PROFILE_MAX_PHASES 24
+
+struct bootPhase {
+  const char *name;
+  // start of the phase, in us since the start of the application
+  uint32_t start_us;
+  uint32_t duration_us;
+  // done by the deferredInit task instead of setup()
+  bool deferred;
+};
+
+// first thing in setup(). The time before is logged as phase "before setup()".
+void bootProfile_start(void);
+// a phase of setup() is done. It started when the previous one was done.
+void bootProfile_phaseDone(const char *name);
+// a phase of the deferredInit task is done. start_us: micros() when it started.
+void bootProfile_deferredPhaseDone(const char *name, unsigned long start_us);
+// logs all phases
+void bootProfile_print(void);
+uint8_t bootProfile_getPhaseCount(void);
+bootPhase bootProfile_getPhase(uint8_t index);
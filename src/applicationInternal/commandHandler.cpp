@@ -1,12 +1,17 @@
 #include <string>
 #include <list>
+#include <vector>
+#include <atomic>
 #include <sstream>
 #include <algorithm>
 #include <stdexcept>
+#include <stdlib.h>
 #include "applicationInternal/commandHandler.h"
 #include "applicationInternal/scenes/sceneHandler.h"
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "applicationInternal/omote_log.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/wakeLatency.h"
 #include "devices/misc/device_specialCommands.h"
 // show WiFi status
 #include "applicationInternal/gui/guiBase.h"
@@ -57,7 +62,32 @@ uint16_t KEYBOARD_MUTE                      ; //PPCAT(KEYBOARD_PREFIX, MUTE)
 uint16_t KEYBOARD_VOLUME_INCREMENT          ; //PPCAT(KEYBOARD_PREFIX, VOLUME_INCREMENT)
 uint16_t KEYBOARD_VOLUME_DECREMENT          ; //PPCAT(KEYBOARD_PREFIX, VOLUME_DECREMENT)
 
-std::map<uint16_t, commandData> commands;
+// All commands are stored in a dense table. The command id is the index into this table.
+// This works because register_command() and get_uniqueCommandID() hand out the ids strictly in sequence.
+// IDs only reserved by get_uniqueCommandID() get an entry too, but it is marked as not registered.
+// Compared to a std::map, looking up a command on every key press is only an array access.
+// An entry is kept small, it only says where the command is stored:
+// - commands registered with register_command() have their commandData in commandDatas
+// - IR commands registered with register_command() have their parsed IR code in irCodes. The payload strings are not kept.
+// - IR commands of a const table only point to their entry of the table, which stays in flash. It is decoded when the command is sent.
+enum commandTableEntryType : uint8_t {
+  COMMAND_RESERVED,
+  COMMAND_DATA,
+  COMMAND_IR,
+  COMMAND_IR_TABLE,
+};
+struct commandTableEntry {
+  commandTableEntryType type;
+  // COMMAND_DATA: index into commandDatas, COMMAND_IR: index into irCodes
+  uint16_t index;
+  // COMMAND_IR_TABLE only
+  const IRcommandTableEntry *irTableEntry;
+};
+std::vector<commandTableEntry> commands;
+std::vector<commandData> commandDatas;
+std::vector<IRcode> irCodes;
+// the commandData of all IR commands. IR commands have no payloads anymore after registration.
+const commandData irCommandData = {IR, {}};
 
 uint16_t uniqueCommandID = 0;
 
@@ -66,14 +96,91 @@ void register_command(uint16_t *command, commandData aCommandData) {
   *command = uniqueCommandID;
   uniqueCommandID++;
 
-  commands[*command] = aCommandData;
+  if (aCommandData.commandHandler == IR) {
+    // IR commands are parsed only once, here. Sending them later needs no string handling at all.
+    // The first payload is the IR protocol, the second (if any) is the data to be sent.
+    // If there is no data, it has to be provided as additionalPayload when executing the command.
+    std::list<std::string> &payloads = aCommandData.commandPayloads;
+    int protocol = payloads.empty() ? -1 : atoi(payloads.front().c_str());
+    IRcode irCode = {(int16_t)protocol, false, 0, kNoRepeat, 0, 0, NULL};
+    if (payloads.size() >= 2) {
+      parseIRcode(protocol, *std::next(payloads.begin(), 1), &irCode);
+    }
+    omote_log_v("register_command: IR command %u, protocol %d, hasData %d, data 0x%llx, nbits %u, repeat %u, timingsLength %u\r\n",
+      *command, irCode.protocol, irCode.hasData, (unsigned long long)irCode.data, irCode.nbits, irCode.repeat, irCode.timingsLength);
+    irCodes.push_back(irCode);
+    commands.push_back(commandTableEntry{COMMAND_IR, (uint16_t)(irCodes.size() - 1), NULL});
+    return;
+  }
+
+  commandDatas.push_back(aCommandData);
+  commands.push_back(commandTableEntry{COMMAND_DATA, (uint16_t)(commandDatas.size() - 1), NULL});
+}
+
+// Decodes an entry of a const IR table. Cheap enough to be done each time the command is sent: no strings, no allocation.
+static void decodeIRcommandTableEntry(const IRcommandTableEntry &entry, IRcode *irCode) {
+  *irCode = IRcode{entry.protocol, true, entry.nbits, entry.repeat, entry.data, entry.timingsLength, entry.timings};
+  if (entry.protocol == IR_PROTOCOL_GLOBALCACHE) {
+    irCode->hasData = (entry.timings != NULL) && (entry.timingsLength > 0);
+  } else if ((entry.nbits == 0) && !getProtocolDefaultBitsAndRepeat(entry.protocol, &irCode->nbits, &irCode->repeat)) {
+    irCode->hasData = false;
+  }
+}
+
+void register_IRcommandTable(const IRcommandTableEntry *table, size_t tableSize) {
+  commands.reserve(commands.size() + tableSize);
+
+  for (size_t i = 0; i < tableSize; i++) {
+    const IRcommandTableEntry &entry = table[i];
+    *entry.command = uniqueCommandID;
+    uniqueCommandID++;
+
+    // only decoded here to warn early. What is sent is decoded again from the table.
+    IRcode irCode;
+    decodeIRcommandTableEntry(entry, &irCode);
+    if (!irCode.hasData) {
+      omote_log_w("register_IRcommandTable: IR command %u with protocol %d is incomplete and will not be sent\r\n", *entry.command, entry.protocol);
+    }
+
+    commands.push_back(commandTableEntry{COMMAND_IR_TABLE, 0, &entry});
+  }
 }
 // only get a unique ID. used by KEYBOARD_DUMMY and COMMAND_UNKNOWN
 void get_uniqueCommandID(uint16_t *command) {
   *command = uniqueCommandID;
   uniqueCommandID++;
+
+  commands.push_back(commandTableEntry{COMMAND_RESERVED, 0, NULL});
+}
+
+// NULL if the command does not exist or the id is only reserved
+static const commandData *findCommandData(uint16_t command) {
+  if (command >= commands.size()) {
+    return NULL;
+  }
+  switch (commands[command].type) {
+    case COMMAND_DATA:     return &commandDatas[commands[command].index];
+    case COMMAND_IR:
+    case COMMAND_IR_TABLE: return &irCommandData;
+    default:               return NULL;
+  }
 }
 
+#if (ENABLE_SELFTESTS == 1)
+uint16_t get_commandCount(void) {
+  return uniqueCommandID;
+}
+const commandData *get_commandData(uint16_t command) {
+  return findCommandData(command);
+}
+const IRcommandTableEntry *get_IRcommandTableEntry(uint16_t command) {
+  if ((command >= commands.size()) || (commands[command].type != COMMAND_IR_TABLE)) {
+    return NULL;
+  }
+  return commands[command].irTableEntry;
+}
+#endif
+
 void register_keyboardCommands() {
   get_uniqueCommandID(&KEYBOARD_DUMMY_UP                  );
   get_uniqueCommandID(&KEYBOARD_DUMMY_DOWN                );
@@ -175,34 +282,55 @@ std::string convertStringListToString(std::list<std::string> listOfStrings) {
   return result;
 }
 
-void executeCommandWithData(uint16_t command, commandData commandData, std::string additionalPayload = "") {
+// The command data is only referenced, never copied. Executing a registered command does not allocate memory on its own.
+#if (ENABLE_SELFTESTS == 1)
+tCommandExecuted_cb thisCommandExecuted_cb = NULL;
+void set_commandExecuted_cb(tCommandExecuted_cb pCommandExecuted_cb) {
+  thisCommandExecuted_cb = pCommandExecuted_cb;
+}
+#endif
+
+void executeCommandWithData(uint16_t command, const commandData &commandData, const std::string &additionalPayload) {
+  wakeLatency_commandExecuted();
+  #if (ENABLE_SELFTESTS == 1)
+  if (thisCommandExecuted_cb != NULL) {
+    thisCommandExecuted_cb(command, additionalPayload);
+  }
+  #endif
   switch (commandData.commandHandler) {
     case IR: {
-      omote_log_v("  generic IR, payloads %s\r\n", convertStringListToString(commandData.commandPayloads).c_str());
-
-      // we received a comma separated list of strings
-      // the first string is the IR protocol, the second is the payload to be sent
-      std::list<std::string>::iterator it = commandData.commandPayloads.begin();
-      // get protocol and erase first element in list
-      std::string protocol = *it;
-      it = commandData.commandPayloads.erase(it);
-      omote_log_v("  protocol %s, payload %s\r\n", protocol.c_str(), convertStringListToString(commandData.commandPayloads).c_str());
-      
-      sendIRcode(std::stoi(protocol), commandData.commandPayloads, additionalPayload);
+      // The IR code was already parsed in register_command(). Only an additionalPayload has to be parsed now.
+      // If an additionalPayload is provided, it is used instead of the data of the command.
+      // Commands of a const IR table are decoded from flash now. Others were parsed when they were registered.
+      IRcode irCodeFromTable;
+      const IRcode *irCode;
+      if (commands[command].type == COMMAND_IR_TABLE) {
+        decodeIRcommandTableEntry(*commands[command].irTableEntry, &irCodeFromTable);
+        irCode = &irCodeFromTable;
+      } else {
+        irCode = &irCodes[commands[command].index];
+      }
+      if (additionalPayload != "") {
+        omote_log_v("  generic IR, protocol %d, additionalPayload %s\r\n", irCode->protocol, additionalPayload.c_str());
+        IRcode irCodeFromPayload;
+        if (parseIRcode(irCode->protocol, additionalPayload, &irCodeFromPayload)) {
+          sendIRcode(irCodeFromPayload);
+          freeIRcode(&irCodeFromPayload);
+        }
+      } else if (irCode->hasData) {
+        omote_log_v("  generic IR, protocol %d, data 0x%llx\r\n", irCode->protocol, (unsigned long long)irCode->data);
+        sendIRcode(*irCode);
+      } else {
+        omote_log_w("execute: cannot send IR command, because both data and payload are empty or invalid\r\n");
+      }
       break;
     }
 
     #if (ENABLE_WIFI_AND_MQTT == 1)
     case MQTT: {
-      auto current = commandData.commandPayloads.begin();
-      std::string topic = *current;
-      std::string payload;
-      if (additionalPayload == "") {
-        current = std::next(current, 1);
-        payload = *current;
-      } else {
-        payload = additionalPayload;
-      }
+      // the first payload is the topic, the second one (or the additionalPayload) is the payload to be sent
+      const std::string &topic = commandData.commandPayloads.front();
+      const std::string &payload = (additionalPayload == "") ? *std::next(commandData.commandPayloads.begin(), 1) : additionalPayload;
       omote_log_d("execute: will send MQTT, topic '%s', payload '%s'\r\n", topic.c_str(), payload.c_str());
       publishMQTTMessage(topic.c_str(), payload.c_str());
       break;
@@ -242,11 +370,203 @@ void executeCommandWithData(uint16_t command, commandData commandData, std::stri
   }
 }
 
-void executeCommand(uint16_t command, std::string additionalPayload) {
+// Bounded queue of all commands which could not be executed inline, in the order of executeCommand(). The main loop is the only producer.
+// There are two consumers, the command worker and the "commands" task of the main loop. The oldest command decides which one executes it:
+// the consumer executes commands as long as the oldest one is its own, then hands over to the other one. So they never run at the same time,
+// and the tail is only written by one of them at a time. It is advanced after the command was executed, and published with release/acquire.
+// The indices always increase, the slot is (index % COMMAND_QUEUE_SIZE).
+const uint32_t COMMAND_QUEUE_SIZE = 32;
+struct queuedCommand {
+  uint16_t command;
+  std::atomic<bool> executedByCommandWorker;
+  std::string additionalPayload;
+  unsigned long enqueuedAt;
+};
+queuedCommand commandQueue[COMMAND_QUEUE_SIZE];
+std::atomic<uint32_t> commandQueue_head(0); // written by the producer
+std::atomic<uint32_t> commandQueue_tail(0); // written by the consumer which executed the oldest command
+bool commandQueue_started = false;
+// true while the main loop executes a command of the queue. A command may execute other commands, see enqueueCommand().
+bool commandQueue_mainLoopIsExecuting = false;
+// metrics. The first ones are written by the producer, the others by the consumers
+uint16_t commandQueue_maxDepth = 0;
+uint32_t commandQueue_blocked = 0;
+unsigned long commandQueue_blocked_ms = 0;
+std::atomic<uint32_t> commandQueue_executed(0);
+std::atomic<unsigned long> commandQueue_lastWait_ms(0);
+std::atomic<unsigned long> commandQueue_maxWait_ms(0);
+std::atomic<unsigned long> commandQueue_totalWait_ms(0);
+
+bool isExecutedByCommandWorker(commandHandlers commandHandler) {
+  if (commandHandler == IR) {return true;}
+  #if (ENABLE_KEYBOARD_BLE == 1)
+  if (commandHandler == BLE_KEYBOARD) {return true;}
+  #endif
+  return false;
+}
+
+// The oldest command and its index, if there is one and it belongs to the caller. Used by the consumers only.
+// While the oldest command belongs to the other consumer, it can be executed and its slot reused by the producer at any time.
+// So the tail is read again after the type: only if it did not change, the type was the one of the oldest command.
+queuedCommand *getOldestQueuedCommand(bool executedByCommandWorker, uint32_t *tail) {
+  while (true) {
+    *tail = commandQueue_tail.load(std::memory_order_acquire);
+    if (*tail == commandQueue_head.load(std::memory_order_acquire)) {
+      return NULL;
+    }
+    queuedCommand *slot = &commandQueue[*tail % COMMAND_QUEUE_SIZE];
+    bool slotIsExecutedByCommandWorker = slot->executedByCommandWorker.load(std::memory_order_acquire);
+    if (*tail == commandQueue_tail.load(std::memory_order_acquire)) {
+      return (slotIsExecutedByCommandWorker == executedByCommandWorker) ? slot : NULL;
+    }
+  }
+}
+
+void executeQueuedCommand(queuedCommand &slot, const char *consumer) {
+  unsigned long wait = millis() - slot.enqueuedAt;
+  commandQueue_lastWait_ms.store(wait, std::memory_order_relaxed);
+  commandQueue_totalWait_ms.fetch_add(wait, std::memory_order_relaxed);
+  if (wait > commandQueue_maxWait_ms.load(std::memory_order_relaxed)) {
+    commandQueue_maxWait_ms.store(wait, std::memory_order_relaxed);
+  }
+  omote_log_v("command: %s will execute command '%u', waited %lu ms in queue\r\n", consumer, slot.command, wait);
+
+  // the command table is not changed anymore after the worker has been started, so it can be read without locking
+  try {
+    executeCommandWithData(slot.command, *findCommandData(slot.command), slot.additionalPayload);
+  }
+  catch (const std::exception& e) {
+    omote_log_e("command: %s failed to execute command '%u'\r\n", consumer, slot.command);
+  }
+  commandQueue_executed.fetch_add(1, std::memory_order_relaxed);
+}
+
+// the commands of the worker, until the oldest one is for the main loop or the queue is empty
+void executeQueuedCommands_cb() {
+  uint32_t tail;
+  queuedCommand *slot;
+  while ((slot = getOldestQueuedCommand(true, &tail)) != NULL) {
+    executeQueuedCommand(*slot, "worker");
+    commandQueue_tail.store(tail + 1, std::memory_order_release);
+  }
+  if (getOldestQueuedCommand(false, &tail) != NULL) {
+    // the "commands" task is due now, see commandQueue_timeTillNextCommand()
+    wake_idle();
+  }
+
+  uint32_t executed = commandQueue_executed.load(std::memory_order_relaxed);
+  omote_log_d("command: worker is done. executed %u, blocked %u, max depth %u, avg wait %lu ms, max wait %lu ms\r\n",
+    executed, commandQueue_blocked, commandQueue_maxDepth,
+    (executed > 0) ? commandQueue_totalWait_ms.load(std::memory_order_relaxed) / executed : 0, commandQueue_maxWait_ms.load(std::memory_order_relaxed));
+}
+
+// the commands of the main loop, until the oldest one is for the worker or the queue is empty
+void commandQueue_loop() {
+  if (commandQueue_mainLoopIsExecuting) {
+    // called by enqueueCommand(), from a command which is executed right now
+    return;
+  }
+  commandQueue_mainLoopIsExecuting = true;
+  uint32_t tail;
+  queuedCommand *slot;
+  while ((slot = getOldestQueuedCommand(false, &tail)) != NULL) {
+    executeQueuedCommand(*slot, "main loop");
+    commandQueue_tail.store(tail + 1, std::memory_order_release);
+  }
+  commandQueue_mainLoopIsExecuting = false;
+  if (getOldestQueuedCommand(true, &tail) != NULL) {
+    notify_commandWorker();
+  }
+}
+
+uint32_t commandQueue_timeTillNextCommand() {
+  uint32_t tail;
+  return (getOldestQueuedCommand(false, &tail) != NULL) ? 0 : SCHEDULER_NO_DEADLINE;
+}
+
+bool commandQueue_hasCommands_cb() {
+  return commandQueue_head.load(std::memory_order_acquire) != commandQueue_tail.load(std::memory_order_acquire);
+}
+
+void init_commandQueue() {
+  // runs the commands of the main loop which had to be queued, as soon as the worker has handed over
+  scheduler_addTask("commands", &commandQueue_loop, SCHEDULER_NO_PERIOD, &commandQueue_timeTillNextCommand);
+  init_commandWorker();
+  commandQueue_started = true;
+}
+
+// Returns false if the command could not be queued and has to be executed inline.
+bool enqueueCommand(uint16_t command, bool executedByCommandWorker, const std::string &additionalPayload) {
+  uint32_t head = commandQueue_head.load(std::memory_order_relaxed);
+  uint32_t depth = head - commandQueue_tail.load(std::memory_order_acquire);
+  if (depth >= COMMAND_QUEUE_SIZE) {
+    // Wait for the worker. If the oldest command is for the main loop, execute it now.
+    // A command of the main loop that executes more commands than fit into the queue cannot wait for itself. Its commands are executed inline then, out of order.
+    omote_log_w("command: queue is full, will wait until command '%u' can be queued\r\n", command);
+    unsigned long start = millis();
+    commandQueue_blocked++;
+    do {
+      uint32_t tail;
+      if (getOldestQueuedCommand(false, &tail) != NULL) {
+        if (commandQueue_mainLoopIsExecuting) {
+          commandQueue_blocked_ms += millis() - start;
+          omote_log_w("command: queue is full of commands executed by a command, command '%u' is executed inline\r\n", command);
+          return false;
+        }
+        commandQueue_loop();
+      } else {
+        delay(1);
+      }
+      depth = head - commandQueue_tail.load(std::memory_order_acquire);
+    } while (depth >= COMMAND_QUEUE_SIZE);
+    commandQueue_blocked_ms += millis() - start;
+  }
+
+  queuedCommand &slot = commandQueue[head % COMMAND_QUEUE_SIZE];
+  slot.command = command;
+  slot.executedByCommandWorker.store(executedByCommandWorker, std::memory_order_release);
+  slot.additionalPayload = additionalPayload;
+  slot.enqueuedAt = millis();
+  commandQueue_head.store(head + 1, std::memory_order_release);
+
+  if (depth + 1 > commandQueue_maxDepth) {
+    commandQueue_maxDepth = depth + 1;
+  }
+  // If the queue was not empty, the consumer of the oldest command hands over when it is done. But it could have been done right now.
+  if (executedByCommandWorker) {
+    notify_commandWorker();
+  }
+  // commands of the main loop are found by commandQueue_timeTillNextCommand()
+  return true;
+}
+
+void get_commandQueueMetrics(commandQueueMetrics *metrics) {
+  metrics->depth        = commandQueue_head.load(std::memory_order_relaxed) - commandQueue_tail.load(std::memory_order_relaxed);
+  metrics->maxDepth     = commandQueue_maxDepth;
+  metrics->executed     = commandQueue_executed.load(std::memory_order_relaxed);
+  metrics->blocked      = commandQueue_blocked;
+  metrics->blocked_ms   = commandQueue_blocked_ms;
+  metrics->lastWait_ms  = commandQueue_lastWait_ms.load(std::memory_order_relaxed);
+  metrics->maxWait_ms   = commandQueue_maxWait_ms.load(std::memory_order_relaxed);
+  metrics->totalWait_ms = commandQueue_totalWait_ms.load(std::memory_order_relaxed);
+}
+
+void executeCommand(uint16_t command, const std::string &additionalPayload) {
   try {
-    if (commands.count(command) > 0) {
+    const commandData *data = findCommandData(command);
+    if (data != NULL) {
+      if (commandQueue_started) {
+        bool executedByCommandWorker = isExecutedByCommandWorker(data->commandHandler);
+        // commands of the main loop are only executed inline if no command before them is still waiting
+        if (executedByCommandWorker || commandQueue_hasCommands_cb()) {
+          omote_log_d("command: will queue command '%u' with additionalPayload '%s'\r\n", command, additionalPayload.c_str());
+          if (enqueueCommand(command, executedByCommandWorker, additionalPayload)) {
+            return;
+          }
+        }
+      }
       omote_log_d("command: will execute command '%u' with additionalPayload '%s'\r\n", command, additionalPayload.c_str());
-      executeCommandWithData(command, commands.at(command), additionalPayload);
+      executeCommandWithData(command, *data, additionalPayload);
     } else {
       omote_log_w("command: command '%u' not found\r\n", command);
     }
@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 
+#include "applicationInternal/hardware/IRremoteProtocols.h"
 #include "devices/keyboard/device_keyboard_mqtt/device_keyboard_mqtt.h"
 #include "devices/keyboard/device_keyboard_ble/device_keyboard_ble.h"
 
@@ -114,9 +115,65 @@ void register_command(uint16_t *command, commandData aCommandData);
 // only get a unique ID. used by KEYBOARD_DUMMY and COMMAND_UNKNOWN
 void get_uniqueCommandID(uint16_t *command);
 
+// An entry of a compile time table of IR commands. Declare such a table as const, then it is placed in flash and not in RAM.
+// No strings are created and nothing has to be parsed when registering the table.
+// If nbits is 0, the defaults of the protocol are used for nbits and repeat.
+// For IR_PROTOCOL_GLOBALCACHE, provide a const array of timings instead of data.
+struct IRcommandTableEntry {
+  uint16_t *command;
+  int16_t protocol;
+  uint64_t data;
+  uint16_t nbits;
+  uint16_t repeat;
+  const uint16_t *timings;
+  uint16_t timingsLength;
+};
+// register all commands of a table and give each of them a command id
+void register_IRcommandTable(const IRcommandTableEntry *table, size_t tableSize);
+
 void register_keyboardCommands();
 commandData makeCommandData(commandHandlers a, std::list<std::string> b);
-void executeCommand(uint16_t command, std::string additionalPayload = "");
+void executeCommand(uint16_t command, const std::string &additionalPayload = "");
+
+#if (ENABLE_SELFTESTS == 1)
+// for the self tests: number of command ids given out so far, and the data of a command. NULL if the id is only reserved.
+uint16_t get_commandCount(void);
+const commandData *get_commandData(uint16_t command);
+// the entry of a command registered with register_IRcommandTable(), NULL for all other commands
+const IRcommandTableEntry *get_IRcommandTableEntry(uint16_t command);
+// executes the command data directly on the calling thread, without looking up the command and without the queue
+void executeCommandWithData(uint16_t command, const commandData &commandData, const std::string &additionalPayload);
+#endif
+
+// Commands which only talk to a transport (IR, BLE keyboard) are not executed inline, but put into a queue and executed by a separate worker.
+// So executeCommand() returns immediately, and the main loop keeps rendering and scanning keys while e.g. an IR code is sent.
+// SCENE, GUI and SPECIAL commands use LVGL and are always executed by the main loop. MQTT as well, because the MQTT client is also serviced by mqtt_loop() in the main loop and is not thread safe. With ENABLE_TASK_SPLIT=1, publishMQTTMessage() only queues the message for the connectivity task, which owns the MQTT client. The worker queues its BLE keyboard calls there as well.
+// All commands are executed in the order of executeCommand(). A command for the main loop is executed inline only if the queue is empty.
+// Otherwise it is queued as well, and executed by the "commands" task of the scheduler when all commands before it are done.
+// If the queue is full, executeCommand() waits until there is space again. Commands are never dropped.
+// executeCommand() must only be called from the main loop (single producer), and no commands must be registered after the worker has been started.
+// Until init_commandQueue() is called, all commands are executed inline.
+void init_commandQueue();
+struct commandQueueMetrics {
+  uint16_t depth;           // commands currently waiting in the queue, or being executed
+  uint16_t maxDepth;        // highest depth seen so far
+  uint32_t executed;        // commands executed from the queue, by the worker or by the main loop
+  uint32_t blocked;         // calls of executeCommand() that had to wait because the queue was full
+  unsigned long blocked_ms;   // the time they waited, in total
+  unsigned long lastWait_ms;  // time between enqueueing and start of execution, of the last executed command
+  unsigned long maxWait_ms;   // the same, highest value seen so far
+  unsigned long totalWait_ms; // sum of all waits. Divide by 'executed' to get the average
+};
+void get_commandQueueMetrics(commandQueueMetrics *metrics);
+// used as callbacks from hardware. The first one is called by the worker whenever it has been notified.
+// The second one tells if there are commands in the queue, so that the ESP32 does not go to light sleep before they are done.
+void executeQueuedCommands_cb();
+bool commandQueue_hasCommands_cb();
+#if (ENABLE_SELFTESTS == 1)
+// called before each command is executed, on the thread which executes it. Never called by two threads at the same time.
+typedef void (*tCommandExecuted_cb)(uint16_t command, const std::string &additionalPayload);
+void set_commandExecuted_cb(tCommandExecuted_cb pCommandExecuted_cb);
+#endif
 
 void receiveNewIRmessage_cb(std::string message);
 #if (ENABLE_KEYBOARD_BLE == 1)
@@ -0,0 +1,108 @@
+#include <math.h>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/energyModel.h"
+#include "applicationInternal/omote_log.h"
+
+// the counters at the start of an interval
+struct energyModelSnapshot {
+  unsigned long start_us;
+  uint64_t busy_us;
+  uint64_t idleSleep_us;
+};
+static energyModelSnapshot getEnergyModelSnapshot;
+#if defined(SHOW_ENERGY_MODEL_ON_SERIAL)
+static energyModelSnapshot serialLogSnapshot;
+#endif
+#if (ENABLE_WIFI_AND_MQTT == 1)
+static energyModelSnapshot publishMQTTSnapshot;
+#endif
+
+// time spent in all tasks of the scheduler
+static uint64_t getBusyTime_us() {
+  uint64_t busy_us = 0;
+  for (uint8_t i = 0; i < scheduler_getTaskCount(); i++) {
+    busy_us += scheduler_getTaskStatistics(i).totalRunTime_us;
+  }
+  return busy_us;
+}
+
+// the model from the snapshot until now. The snapshot is set to now.
+static energyModel calculateEnergyModel(energyModelSnapshot *snapshot) {
+  energyModelSnapshot now = {micros(), getBusyTime_us(), get_idleSleepTime_us()};
+  if (now.busy_us < snapshot->busy_us) {
+    // the task statistics have been reset
+    snapshot->busy_us = 0;
+  }
+  uint32_t interval_us = now.start_us - snapshot->start_us;
+  uint64_t busy_us = now.busy_us - snapshot->busy_us;
+  uint64_t idleSleep_us = now.idleSleep_us - snapshot->idleSleep_us;
+  uint64_t awakeIdle_us = (busy_us + idleSleep_us < interval_us) ? interval_us - busy_us - idleSleep_us : 0;
+  *snapshot = now;
+
+  energyModel model;
+  model.interval_ms = interval_us / 1000;
+  if (interval_us == 0) {
+    interval_us = 1;
+  }
+  model.busy_percent      = (float)busy_us * 100 / interval_us;
+  model.awakeIdle_percent = (float)awakeIdle_us * 100 / interval_us;
+  model.idleSleep_percent = (float)idleSleep_us * 100 / interval_us;
+  model.estimatedCurrent_mA = (model.busy_percent      * ENERGY_MODEL_CURRENT_BUSY_MA +
+                               model.awakeIdle_percent * ENERGY_MODEL_CURRENT_AWAKE_IDLE_MA +
+                               model.idleSleep_percent * ENERGY_MODEL_CURRENT_IDLE_SLEEP_MA) / 100;
+
+  int battery_voltage;
+  int battery_percentage;
+  bool battery_ischarging;
+  get_battery_status(&battery_voltage, &battery_percentage, &battery_ischarging);
+  float chargeRate = get_battery_chargeRate();
+  if (isnan(chargeRate) || battery_ischarging || (chargeRate >= 0)) {
+    model.measuredAverageCurrent_mA = NAN;
+  } else {
+    model.measuredAverageCurrent_mA = -chargeRate * ENERGY_MODEL_BATTERY_CAPACITY_MAH / 100;
+  }
+  model.idleFor_ms = millis() - get_lastActivityTimestamp();
+  model.measuredIdleCurrent_mA = (model.idleFor_ms >= ENERGY_MODEL_IDLE_SETTLE_MS) ? model.measuredAverageCurrent_mA : NAN;
+  return model;
+}
+
+energyModel get_energyModel(void) {
+  return calculateEnergyModel(&getEnergyModelSnapshot);
+}
+
+// called every second
+void doLogEnergyModel(void) {
+  omote_log_v("inside doLogEnergyModel\r\n");
+
+  #if defined(SHOW_ENERGY_MODEL_ON_SERIAL)
+  // Serial log every 10 sec
+  if (micros() - serialLogSnapshot.start_us >= 10000000UL) {
+    energyModel model = calculateEnergyModel(&serialLogSnapshot);
+    omote_log_d("energy: busy %.1f%%, awake idle %.1f%%, idle sleep %.1f%% of %lu ms. Estimated %.1f mA, measured average %.1f mA, measured idle %.1f mA (no activity for %lu s)\r\n",
+      model.busy_percent, model.awakeIdle_percent, model.idleSleep_percent, (unsigned long)model.interval_ms, model.estimatedCurrent_mA,
+      model.measuredAverageCurrent_mA, model.measuredIdleCurrent_mA, (unsigned long)(model.idleFor_ms / 1000));
+  }
+  #endif
+
+  #if (ENABLE_WIFI_AND_MQTT == 1)
+  if ((micros() - publishMQTTSnapshot.start_us >= ENERGY_MODEL_MQTT_INTERVAL_MS * 1000UL) && getIsWifiConnected()) {
+    energyModel model = calculateEnergyModel(&publishMQTTSnapshot);
+    char payload[300];
+    // JSON has no NAN
+    char measuredAverageCurrent[16] = "null";
+    if (!isnan(model.measuredAverageCurrent_mA)) {
+      snprintf(measuredAverageCurrent, sizeof(measuredAverageCurrent), "%.1f", model.measuredAverageCurrent_mA);
+    }
+    char measuredIdleCurrent[16] = "null";
+    if (!isnan(model.measuredIdleCurrent_mA)) {
+      snprintf(measuredIdleCurrent, sizeof(measuredIdleCurrent), "%.1f", model.measuredIdleCurrent_mA);
+    }
+    snprintf(payload, sizeof(payload), "{\"interval_ms\":%lu,\"busy_percent\":%.1f,\"awakeIdle_percent\":%.1f,\"idleSleep_percent\":%.1f,\"estimatedCurrent_mA\":%.1f,"
+      "\"measuredAverageCurrent_mA\":%s,\"measuredIdleCurrent_mA\":%s,\"idleFor_ms\":%lu}",
+      (unsigned long)model.interval_ms, model.busy_percent, model.awakeIdle_percent, model.idleSleep_percent, model.estimatedCurrent_mA,
+      measuredAverageCurrent, measuredIdleCurrent, (unsigned long)model.idleFor_ms);
+    publishMQTTMessage(ENERGY_MODEL_MQTT_TOPIC, payload);
+  }
+  #endif
+}
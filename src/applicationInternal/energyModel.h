@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// activate log on serial output, every 10 s
+//#define SHOW_ENERGY_MODEL_ON_SERIAL
+
+// Where the time of the main loop goes while the remote is awake:
+//   busy:        a task of the scheduler is running
+//   awake idle:  no task is due, but the CPU keeps running, e.g. because light sleep is not possible right now
+//   idle sleep:  no task is due and idle() sleeps until the next one is. ESP32: light sleep (ENABLE_LIGHT_SLEEP=1). Simulator: the host sleeps.
+// Weighted with the current of each state, this gives an estimate of the average current while awake.
+// The currents are ballpark values of the ESP32 alone, without display, backlight and radio. Replace them with measurements of your board.
+#define ENERGY_MODEL_CURRENT_BUSY_MA        50.0f
+#define ENERGY_MODEL_CURRENT_AWAKE_IDLE_MA  40.0f
+#define ENERGY_MODEL_CURRENT_IDLE_SLEEP_MA   1.0f
+// The fuel gauge (OMOTE_HARDWARE_REV >= 4) measures how fast the battery discharges (CRATE of the MAX17048). With the capacity of your battery,
+// this gives the measured current. It is an average over the last minutes, of everything the remote did: busy, idle, display, backlight and radio.
+#define ENERGY_MODEL_BATTERY_CAPACITY_MAH 2000.0f
+// To measure the awake idle current, leave the remote alone, awake (sleep timeout of 10 min or more) and on battery. After this time without any
+// key press, touch or motion, the average is taken as the idle current. The time the fuel gauge needs to settle is a guess, not measured yet.
+#define ENERGY_MODEL_IDLE_SETTLE_MS 300000
+// when WiFi is enabled and connected, the model is published to this topic every ENERGY_MODEL_MQTT_INTERVAL_MS
+#define ENERGY_MODEL_MQTT_TOPIC       "omote/energyModel"
+#define ENERGY_MODEL_MQTT_INTERVAL_MS 60000
+
+struct energyModel {
+  // the interval the shares are calculated from
+  uint32_t interval_ms;
+  float busy_percent;
+  float awakeIdle_percent;
+  float idleSleep_percent;
+  float estimatedCurrent_mA;
+  // Average current from the fuel gauge, see above. NAN while charging or without fuel gauge, e.g. in the simulator.
+  float measuredAverageCurrent_mA;
+  // the same average, but only after ENERGY_MODEL_IDLE_SETTLE_MS without activity. Otherwise NAN.
+  float measuredIdleCurrent_mA;
+  // time since the last key press, touch or motion
+  uint32_t idleFor_ms;
+};
+
+// the model since the last call of get_energyModel(). Call it at least once an hour, micros() wraps after 71 minutes.
+energyModel get_energyModel(void);
+// called every second
+void doLogEnergyModel(void);
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <string.h>
+#include <lvgl.h>
+#include "applicationInternal/gui/guiBase.h"
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/frameStatistics.h"
+#include "applicationInternal/omote_log.h"
+
+bool showFrameStatistics = 0;
+
+// ring buffer with one sample per frame
+struct frameSample {
+  uint32_t timerHandler_us;
+  uint32_t render_us;
+  uint32_t flush_us;
+  uint32_t pixels;
+};
+static frameSample frameSamples[FRAME_STATISTICS_WINDOW];
+static uint16_t frameSamplesCount = 0;
+static uint16_t frameSamplesNext = 0;
+
+static unsigned long timerHandlerStart;
+static uint32_t lastSeenFrameCount = 0;
+
+static unsigned long fpsTimer = 0;
+static uint32_t fpsFrameCount = 0;
+static float lastFps = 0;
+
+static unsigned long updateSerialLogTimer = 0;
+#if (ENABLE_WIFI_AND_MQTT == 1)
+static unsigned long publishMQTTTimer = 0;
+static uint32_t publishMQTTFrameCount = 0;
+#endif
+
+bool getShowFrameStatistics() {
+  return showFrameStatistics;
+}
+void setShowFrameStatistics(bool aShowFrameStatistics) {
+  showFrameStatistics = aShowFrameStatistics;
+  showMemoryUsageBar(showFrameStatistics);
+  doLogFrameStatistics();
+}
+
+void frameStatistics_timerHandlerStart(void) {
+  timerHandlerStart = micros();
+}
+
+void frameStatistics_timerHandlerEnd(void) {
+  uint32_t duration = micros() - timerHandlerStart;
+  lvglFrameTiming frameTiming = get_lastFrameTiming();
+  // Most calls of lv_timer_handler() only run timers and don't refresh the display. They would hide the frames in the statistics.
+  if (frameTiming.frameCount == lastSeenFrameCount) {
+    return;
+  }
+  lastSeenFrameCount = frameTiming.frameCount;
+
+  frameSamples[frameSamplesNext] = frameSample{duration, frameTiming.render_us, frameTiming.flush_us, frameTiming.pixels};
+  frameSamplesNext = (frameSamplesNext + 1) % FRAME_STATISTICS_WINDOW;
+  if (frameSamplesCount < FRAME_STATISTICS_WINDOW) {
+    frameSamplesCount++;
+  }
+}
+
+// nearest-rank p99, values is reordered
+static frameStatistic calculateFrameStatistic(uint32_t *values, uint16_t count) {
+  if (count == 0) {
+    return frameStatistic{0, 0, 0, 0};
+  }
+  uint64_t sum = 0;
+  uint32_t min = values[0];
+  uint32_t max = values[0];
+  for (uint16_t i = 0; i < count; i++) {
+    sum += values[i];
+    min = std::min(min, values[i]);
+    max = std::max(max, values[i]);
+  }
+  uint16_t p99index = (count * 99 + 99) / 100 - 1;
+  std::nth_element(values, values + p99index, values + count);
+  return frameStatistic{min, (uint32_t)(sum / count), max, values[p99index]};
+}
+
+frameStatistics get_frameStatistics(void) {
+  frameStatistics stats;
+  stats.samples = frameSamplesCount;
+  stats.fps = lastFps;
+
+  uint32_t values[FRAME_STATISTICS_WINDOW];
+  for (uint16_t i = 0; i < frameSamplesCount; i++) {values[i] = frameSamples[i].timerHandler_us;}
+  stats.timerHandler_us = calculateFrameStatistic(values, frameSamplesCount);
+  for (uint16_t i = 0; i < frameSamplesCount; i++) {values[i] = frameSamples[i].render_us;}
+  stats.render_us = calculateFrameStatistic(values, frameSamplesCount);
+  for (uint16_t i = 0; i < frameSamplesCount; i++) {values[i] = frameSamples[i].flush_us;}
+  stats.flush_us = calculateFrameStatistic(values, frameSamplesCount);
+  for (uint16_t i = 0; i < frameSamplesCount; i++) {values[i] = frameSamples[i].pixels;}
+  stats.pixels = calculateFrameStatistic(values, frameSamplesCount);
+
+  return stats;
+}
+
+#if (ENABLE_WIFI_AND_MQTT == 1)
+static void publishFrameStatistic(char *buffer, size_t size, const char *name, const frameStatistic &statistic, bool last = false) {
+  size_t len = strlen(buffer);
+  snprintf(buffer + len, size - len, "\"%s\":{\"min\":%lu,\"avg\":%lu,\"max\":%lu,\"p99\":%lu}%s",
+    name, (unsigned long)statistic.min, (unsigned long)statistic.avg, (unsigned long)statistic.max, (unsigned long)statistic.p99, last ? "}" : ",");
+}
+#endif
+
+// called every second
+void doLogFrameStatistics() {
+  omote_log_v("inside doLogFrameStatistics\r\n");
+
+  lvglFrameTiming frameTiming = get_lastFrameTiming();
+  // also called when the GUI toggle is switched. Don't calculate fps from such a short interval.
+  unsigned long elapsed = millis() - fpsTimer;
+  if (elapsed >= 1000) {
+    lastFps = (float)(frameTiming.frameCount - fpsFrameCount) * 1000 / elapsed;
+    fpsTimer = millis();
+    fpsFrameCount = frameTiming.frameCount;
+  }
+
+  bool doSerialLog = false;
+  #if defined(SHOW_FRAME_STATISTICS_ON_SERIAL)
+  // Serial log every 5 sec
+  doSerialLog = (millis() - updateSerialLogTimer >= 5000);
+  #endif
+  bool doPublish = false;
+  #if (ENABLE_WIFI_AND_MQTT == 1)
+  doPublish = (millis() - publishMQTTTimer >= FRAME_STATISTICS_MQTT_INTERVAL_MS) && (frameTiming.frameCount != publishMQTTFrameCount) && getIsWifiConnected();
+  #endif
+  if (!showFrameStatistics && !doSerialLog && !doPublish) {
+    if (FrameStatisticsLabel != NULL) {
+      lv_label_set_text(FrameStatisticsLabel, "");
+    }
+    return;
+  }
+
+  frameStatistics stats = get_frameStatistics();
+
+  if (doSerialLog) {
+    updateSerialLogTimer = millis();
+    omote_log_d("frames: %u samples, %.1f fps\r\n", stats.samples, stats.fps);
+    omote_log_d("  lv_timer_handler: min %6lu, avg %6lu, max %6lu, p99 %6lu us\r\n", (unsigned long)stats.timerHandler_us.min, (unsigned long)stats.timerHandler_us.avg, (unsigned long)stats.timerHandler_us.max, (unsigned long)stats.timerHandler_us.p99);
+    omote_log_d("  render:           min %6lu, avg %6lu, max %6lu, p99 %6lu us\r\n", (unsigned long)stats.render_us.min,       (unsigned long)stats.render_us.avg,       (unsigned long)stats.render_us.max,       (unsigned long)stats.render_us.p99);
+    omote_log_d("  flush:            min %6lu, avg %6lu, max %6lu, p99 %6lu us\r\n", (unsigned long)stats.flush_us.min,        (unsigned long)stats.flush_us.avg,        (unsigned long)stats.flush_us.max,        (unsigned long)stats.flush_us.p99);
+    omote_log_d("  invalidated area: min %6lu, avg %6lu, max %6lu, p99 %6lu pixels\r\n", (unsigned long)stats.pixels.min,      (unsigned long)stats.pixels.avg,          (unsigned long)stats.pixels.max,          (unsigned long)stats.pixels.p99);
+  }
+
+  #if (ENABLE_WIFI_AND_MQTT == 1)
+  if (doPublish) {
+    publishMQTTTimer = millis();
+    publishMQTTFrameCount = frameTiming.frameCount;
+    char payload[400];
+    snprintf(payload, sizeof(payload), "{\"samples\":%u,\"fps\":%.1f,", stats.samples, stats.fps);
+    publishFrameStatistic(payload, sizeof(payload), "timerHandler_us", stats.timerHandler_us);
+    publishFrameStatistic(payload, sizeof(payload), "render_us",       stats.render_us);
+    publishFrameStatistic(payload, sizeof(payload), "flush_us",        stats.flush_us);
+    publishFrameStatistic(payload, sizeof(payload), "pixels",          stats.pixels, true);
+    publishMQTTMessage(FRAME_STATISTICS_MQTT_TOPIC, payload);
+  }
+  #endif
+
+  if (showFrameStatistics) {
+    char buffer[80];
+    snprintf(buffer, sizeof(buffer), "%.0f fps, lvgl avg %.1f p99 %.1f max %.1f ms",
+      stats.fps, (float)stats.timerHandler_us.avg / 1000, (float)stats.timerHandler_us.p99 / 1000, (float)stats.timerHandler_us.max / 1000);
+    for (int i=0; i<strlen(buffer); i++) {
+      if (buffer[i] == '.') {
+        buffer[i] = ',';
+      }
+    }
+    if (FrameStatisticsLabel != NULL) {
+      lv_label_set_text(FrameStatisticsLabel, buffer);
+    }
+  } else {
+    if (FrameStatisticsLabel != NULL) {
+      lv_label_set_text(FrameStatisticsLabel, "");
+    }
+  }
+}
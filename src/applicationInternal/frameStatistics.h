@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// activate log on serial output
+// log on GUI is activated by button on GUI
+//#define SHOW_FRAME_STATISTICS_ON_SERIAL
+
+// number of frames the rolling statistics are calculated from
+#define FRAME_STATISTICS_WINDOW 100
+// when WiFi is enabled and connected, statistics are published to this topic every FRAME_STATISTICS_MQTT_INTERVAL_MS, but only if frames were rendered
+#define FRAME_STATISTICS_MQTT_TOPIC       "omote/frameStatistics"
+#define FRAME_STATISTICS_MQTT_INTERVAL_MS 10000
+
+// min/avg/max/p99 over the last FRAME_STATISTICS_WINDOW frames
+struct frameStatistic {
+  uint32_t min;
+  uint32_t avg;
+  uint32_t max;
+  uint32_t p99;
+};
+struct frameStatistics {
+  uint16_t samples;
+  // frames per second since the last call of doLogFrameStatistics()
+  float fps;
+  // time spent in lv_timer_handler() in gui_loop(), in us. Only calls that refreshed the display are counted.
+  frameStatistic timerHandler_us;
+  frameStatistic render_us;
+  frameStatistic flush_us;
+  // invalidated area, in pixels
+  frameStatistic pixels;
+};
+
+bool getShowFrameStatistics();
+void setShowFrameStatistics(bool aShowFrameStatistics);
+// used by gui_loop() to measure lv_timer_handler()
+void frameStatistics_timerHandlerStart(void);
+void frameStatistics_timerHandlerEnd(void);
+frameStatistics get_frameStatistics(void);
+void doLogFrameStatistics(void);
@@ -3,6 +3,8 @@
 #include "guis/gui_BLEpairing.h"
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "applicationInternal/memoryUsage.h"
+#include "applicationInternal/frameStatistics.h"
+#include "applicationInternal/wakeLatency.h"
 #include "applicationInternal/gui/guiMemoryOptimizer.h"
 // for changing to scene Selection gui
 #include "applicationInternal/commandHandler.h"
@@ -11,6 +13,7 @@
 
 lv_color_t color_primary = lv_color_hex(0x303030); // gray
 lv_obj_t* MemoryUsageLabel = NULL;
+lv_obj_t* FrameStatisticsLabel = NULL;
 lv_obj_t* WifiLabel = NULL;
 lv_obj_t* BluetoothLabel = NULL;
 lv_obj_t* BattPercentageLabel = NULL;
@@ -82,8 +85,9 @@ void tabview_content_is_scrolling_event_cb(lv_event_t* e){
   // Get the x coordinate of object and scroll panel accordingly
   int16_t tabviewX = lv_obj_get_scroll_x(tabviewContent);
   // the last events we receive are 0, 238 and 476. But should be 0, 240 and 480. Otherwise page indicator jumps a litte bit after recreation of tabs.
-  if ((tabviewX >= 237) && (tabviewX <= 240)) {tabviewX = 240;}
-  if ((tabviewX >= 475) && (tabviewX <= 480)) {tabviewX = 480;}
+  // With more tabs in memory, the difference grows by 2 for each tab.
+  int16_t tabX = ((tabviewX + SCR_WIDTH / 2) / SCR_WIDTH) * SCR_WIDTH;
+  if ((tabviewX <= tabX) && (tabviewX >= tabX - 1 - 2 * (tabX / SCR_WIDTH))) {tabviewX = tabX;}
   // we need 158 more (the size of one page indicator), because we always have one more page indicator at the beginning and at the end (so normally 5 when having 3 tabs)
   int16_t panelX = tabviewX * bias - offset + 158;
   omote_log_v("scroll %d to %d\r\n", tabviewX, panelX);
@@ -91,6 +95,35 @@ void tabview_content_is_scrolling_event_cb(lv_event_t* e){
   // lv_obj_scroll_to_x(panel, lv_obj_get_scroll_x(tabviewContent) * bias - offset, LV_ANIM_OFF);
 }
 
+// Frames per second and bytes sent to the display during a swipe, to compare different draw buffer layouts on the hardware.
+// The simulator has no draw buffer layouts and no dirty area merge, so its numbers don't tell anything about them.
+static bool swipeIsMeasured = false;
+static unsigned long swipeStart;
+static lvglFrameTiming swipeStartFrameTiming;
+// this is a callback if the CONTENT of the tabview starts or stops scrolling (LV_EVENT_SCROLL_BEGIN, LV_EVENT_SCROLL_END)
+void tabview_content_scroll_begin_end_event_cb(lv_event_t* e) {
+  if (lv_event_get_code(e) == LV_EVENT_SCROLL_BEGIN) {
+    if (!swipeIsMeasured) {
+      swipeIsMeasured = true;
+      swipeStart = millis();
+      swipeStartFrameTiming = get_lastFrameTiming();
+    }
+
+  } else if (lv_event_get_code(e) == LV_EVENT_SCROLL_END) {
+    // when the finger is released, the swipe is continued by an animation
+    if (!swipeIsMeasured || (lv_anim_get(lv_event_get_target(e), NULL) != NULL)) {
+      return;
+    }
+    swipeIsMeasured = false;
+    unsigned long duration = millis() - swipeStart;
+    lvglFrameTiming swipeEndFrameTiming = get_lastFrameTiming();
+    uint32_t frames = swipeEndFrameTiming.frameCount - swipeStartFrameTiming.frameCount;
+    uint32_t bytes = (swipeEndFrameTiming.pixelsTotal - swipeStartFrameTiming.pixelsTotal) * sizeof(lv_color_t);
+    omote_log_d("Swipe: %lu frames in %lu ms (%lu fps), %lu bytes sent to display\r\n",
+      (unsigned long)frames, duration, (duration > 0) ? (unsigned long)(frames * 1000 / duration) : 0UL, (unsigned long)bytes);
+  }
+}
+
 // -----------------------
 static bool waitBeforeActionAfterSlidingAnimationEnded = false;
 static unsigned long waitBeforeActionAfterSlidingAnimationEnded_timerStart;
@@ -186,7 +219,8 @@ int labelsPositionTop;
 void setMainWidgetsHeightAndPosition() {
   panelHeight          = 30;
   memoryUsageBarTop    = 0;
-  memoryUsageBarHeight = getShowMemoryUsage() ? 14 : 0;
+  // one line for memory usage, one line for frame statistics
+  memoryUsageBarHeight = (getShowMemoryUsage() ? 14 : 0) + (getShowFrameStatistics() ? 14 : 0);
   statusbarTop         = memoryUsageBarTop + memoryUsageBarHeight;
   statusbarHeight      = 20;
   tabviewTop           = statusbarTop + statusbarHeight;
@@ -206,6 +240,7 @@ void showMemoryUsageBar(bool showBar) {
   lv_obj_align(statusbar, LV_ALIGN_TOP_MID, 0, statusbarTop);
   lv_obj_set_size(tabview, SCR_WIDTH, tabviewHeight);
   lv_obj_align(tabview, LV_ALIGN_TOP_MID, 0, tabviewTop);
+  lv_obj_align(FrameStatisticsLabel, LV_ALIGN_TOP_LEFT, 0 +2, labelsPositionTop +2 + (getShowMemoryUsage() ? 14 : 0));
 
   return;
 
@@ -241,6 +276,11 @@ void init_gui_memoryUsage_bar() {
   lv_obj_align(MemoryUsageLabel, LV_ALIGN_TOP_LEFT, 0 +2, labelsPositionTop +2);
   lv_obj_set_style_text_font(MemoryUsageLabel, &lv_font_montserrat_10, LV_PART_MAIN);
   lv_label_set_recolor(MemoryUsageLabel, true);
+
+  FrameStatisticsLabel = lv_label_create(memoryUsageBar);
+  lv_label_set_text(FrameStatisticsLabel, "");
+  lv_obj_align(FrameStatisticsLabel, LV_ALIGN_TOP_LEFT, 0 +2, labelsPositionTop +2 + (getShowMemoryUsage() ? 14 : 0));
+  lv_obj_set_style_text_font(FrameStatisticsLabel, &lv_font_montserrat_10, LV_PART_MAIN);
 }
 
 void init_gui_status_bar() {
@@ -290,6 +330,16 @@ void init_gui_status_bar() {
 }
 
 static bool waitOneLoop = false;
+// millis() when lvgl has to run again
+static unsigned long nextTimerDue = 0;
+static bool noTimerReady = false;
+uint32_t gui_getTimeTillNextTimer(void) {
+  if (noTimerReady) {
+    return UINT32_MAX;
+  }
+  long diff = (long)(nextTimerDue - millis());
+  return (diff <= 0) ? 0 : diff;
+}
 void gui_loop(void) {
   // after the sliding animation ended, we have to wait one cycle of gui_loop() before we can do the recreation of the tabs
   if (waitBeforeActionAfterSlidingAnimationEnded) {
@@ -307,7 +357,12 @@ void gui_loop(void) {
   //   }
   // }
 
-  lv_timer_handler();
+  frameStatistics_timerHandlerStart();
+  uint32_t timeTillNextTimer = lv_timer_handler();
+  frameStatistics_timerHandlerEnd();
+  wakeLatency_frameRendered();
+  noTimerReady = (timeTillNextTimer == LV_NO_TIMER_READY);
+  nextTimerDue = millis() + timeTillNextTimer;
 
   // flush texts that might have been added from callbacks from other threads
   // has to be done in a thread safe way in the main thread
@@ -5,6 +5,8 @@
 
 // used by memoryUsage.cpp
 extern lv_obj_t* MemoryUsageLabel;
+// used by frameStatistics.cpp
+extern lv_obj_t* FrameStatisticsLabel;
 // used by guiStatusUpdate.cpp
 extern lv_obj_t* BluetoothLabel;
 extern lv_obj_t* BattPercentageLabel;
@@ -28,8 +30,11 @@ extern lv_style_t style_red_border;
 void init_gui(void);
 // used by main.cpp and sceneHandler.cpp
 void gui_loop(void);
+// used by main.cpp for the scheduler: ms until lvgl has to run again, according to the last lv_timer_handler()
+uint32_t gui_getTimeTillNextTimer(void);
 // used by guiMemoryOptimizer.cpp
 void tabview_content_is_scrolling_event_cb(lv_event_t* e);
+void tabview_content_scroll_begin_end_event_cb(lv_event_t* e);
 void tabview_tab_changed_event_cb(lv_event_t* e);
 void sceneLabel_or_pageIndicator_event_cb(lv_event_t* e);
 void pageIndicator_navigate_event_cb(lv_event_t* e);
@@ -39,7 +44,7 @@ void guis_doTabCreationForSpecificGUI(GUIlists GUIlist, int gui_list_index);
 void guis_doTabCreationForNavigateToLastActiveGUIofPreviousGUIlist();
 // used by guiMemoryOptimizer.cpp and sceneHandler.cpp
 void setActiveTab(uint32_t index, lv_anim_enable_t anim_en, bool send_tab_changed_event = false);
-// used by memoryUsage.cpp
+// used by memoryUsage.cpp and frameStatistics.cpp
 void showMemoryUsageBar(bool showBar);
 // used by commandHandler to show WiFi status
 void showWiFiConnected(bool connected);
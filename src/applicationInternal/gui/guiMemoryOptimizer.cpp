@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <list>
+#include <vector>
 #include <lvgl.h>
 #include "applicationInternal/gui/guiBase.h"
 #include "applicationInternal/gui/guiMemoryOptimizer.h"
@@ -6,11 +9,31 @@
 #include "applicationInternal/scenes/sceneRegistry.h"
 #include "applicationInternal/omote_log.h"
 
+#ifndef GUI_TAB_WINDOW_SIZE
+#define GUI_TAB_WINDOW_SIZE 0
+#endif
+// the active tab is in the middle of the window, so there have to be as many neighbours on the left as on the right
+#if (GUI_TAB_WINDOW_SIZE != 0) && (GUI_TAB_WINDOW_SIZE != GUI_TAB_WINDOW_WHOLE_LIST) && ((GUI_TAB_WINDOW_SIZE < 3) || (GUI_TAB_WINDOW_SIZE % 2 == 0))
+#error "GUI_TAB_WINDOW_SIZE has to be 0, an odd number of at least 3, or 255 (GUI_TAB_WINDOW_WHOLE_LIST)"
+#endif
+// Neighbour tabs are only shown as an image (lv_snapshot) of the gui. The real widgets are created when the tab gets active.
+#ifndef GUI_SNAPSHOT_NEIGHBOUR_TABS
+#define GUI_SNAPSHOT_NEIGHBOUR_TABS 0
+#endif
+#if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0) && (LV_USE_SNAPSHOT == 0)
+#error "GUI_SNAPSHOT_NEIGHBOUR_TABS needs -D LV_USE_SNAPSHOT=1"
+#endif
+// number of images of guis kept, also of guis not in memory anymore
+#ifndef GUI_SNAPSHOT_CACHE_SIZE
+#define GUI_SNAPSHOT_CACHE_SIZE 8
+#endif
+
 struct t_gui_on_tab {
   lv_obj_t* tab;
   std::string GUIname;
   int gui_list_index;
-  int gui_list_index_previous;
+  // true if the tab only shows an image of the gui and the gui has no widgets in memory
+  bool isSnapshot;
 };
 struct t_gui_state {
   // the next three and the last are saved in the preferenceStorage every time they change
@@ -18,14 +41,19 @@ struct t_gui_state {
   std::string activeGUIname_internalDontUse;
   GUIlists activeGUIlist_internalDontUse;
   // ---
-  int activeTabID = -1;      // id of the active tab (one of 0,1,2)
-  int oldTabID = -1;         // id of the tab before swiping (one of 0,1,2)
-  t_gui_on_tab gui_on_tab[3] = {{NULL, "", -1, -1}, {NULL, "", -1, -1}, {NULL, "", -1, -1}};
+  int activeTabID = -1;      // id of the active tab (index in gui_on_tab)
+  int oldTabID = -1;         // id of the tab before swiping (index in gui_on_tab)
+  // the guis currently in memory, one per tab, in the order of the gui list. Never more than tabWindowSize.
+  std::vector<t_gui_on_tab> gui_on_tab;
   // the last active gui of scene. Will be stored to easily navigate back to it with guis_doTabCreationForNavigateToLastActiveGUIofPreviousGUIlist()
   GUIlists last_active_gui_list = (GUIlists)-1;
   int last_active_gui_list_index_internalDontUse = -1;
 };
 t_gui_state gui_state;
+// Number of tabs kept in memory: the active tab and (tabWindowSize-1)/2 neighbours on each side, or all guis of the gui list.
+// 0 means not yet chosen. Then it is chosen on startup from the memory available for lvgl.
+uint8_t tabWindowSize = GUI_TAB_WINDOW_SIZE;
+tabSlideMetrics slideMetrics = {0, 0, 0, 0};
 
 // Both the gui_state and the preferenceStorage should know at any time the current state (scene, GUIname, and GUIlist)
 // preferenceStorage should know it because when going to sleep, it should persist the state in NVM.
@@ -38,6 +66,7 @@ std::string gui_memoryOptimizer_getActiveSceneName() {
 void gui_memoryOptimizer_setActiveSceneName(std::string aSceneName) {
   gui_state.activeScene_internalDontUse = aSceneName;
   set_activeScene(aSceneName);
+  invalidate_keyBindings();
 }
 std::string gui_memoryOptimizer_getActiveGUIname() {
   gui_state.activeGUIname_internalDontUse = get_activeGUIname();
@@ -46,6 +75,7 @@ std::string gui_memoryOptimizer_getActiveGUIname() {
 void gui_memoryOptimizer_setActiveGUIname(std::string aGUIname) {
   gui_state.activeGUIname_internalDontUse = aGUIname;
   set_activeGUIname(aGUIname);
+  invalidate_keyBindings();
 }
 GUIlists gui_memoryOptimizer_getActiveGUIlist() {
   gui_state.activeGUIlist_internalDontUse = (GUIlists)get_activeGUIlist();
@@ -70,14 +100,11 @@ int gui_memoryOptimizer_getActiveTabID() {
 
 bool gui_memoryOptimizer_isTabIDInMemory(int tabID) {
   // range check
-  if ((tabID < 0) || (tabID >= 3)) {
-    return false;
-  }
-  return (gui_state.gui_on_tab[tabID].gui_list_index != -1);
+  return (tabID >= 0) && (tabID < (int)gui_state.gui_on_tab.size());
 }
 
 bool gui_memoryOptimizer_isGUInameInMemory(std::string GUIname) {
-  for (uint8_t index=0; index <= 2; index++) {
+  for (uint8_t index=0; index < gui_state.gui_on_tab.size(); index++) {
     if (gui_state.gui_on_tab[index].GUIname == GUIname) {
       return true;
     }
@@ -85,26 +112,80 @@ bool gui_memoryOptimizer_isGUInameInMemory(std::string GUIname) {
   return false;
 }
 
+void gui_memoryOptimizer_getSlideMetrics(tabSlideMetrics *metrics) {
+  *metrics = slideMetrics;
+}
+
+uint8_t gui_memoryOptimizer_getTabWindowSize() {
+  return tabWindowSize;
+}
+bool gui_memoryOptimizer_setTabWindowSize(uint8_t aTabWindowSize) {
+  if ((aTabWindowSize != GUI_TAB_WINDOW_WHOLE_LIST) && ((aTabWindowSize < 3) || (aTabWindowSize % 2 == 0))) {
+    omote_log_w("gui: tab window size %u is not possible, it has to be an odd number of at least 3 or %u. Keeping %u\r\n", aTabWindowSize, GUI_TAB_WINDOW_WHOLE_LIST, tabWindowSize);
+    return false;
+  }
+  // takes effect with the next navigation. A smaller window leads to a recreation of all tabs.
+  tabWindowSize = aTabWindowSize;
+  return true;
+}
+
+// On rev1 to rev4, lvgl has only 32 KB, so only the active tab and its direct neighbours can be kept in memory.
+// With PSRAM (rev5), lvgl has at least 128 KB, which is enough for two more neighbours. Then quick swipes over several tabs don't need a recreation of the tabs.
+// The self test "guiTabWindowSizes" compares the time after a swipe and the memory used for 3, 5 and all tabs over 12 guis.
+// Its numbers are not in yet: this default is still the estimate from above, not a measured result.
+void chooseTabWindowSize() {
+  if (tabWindowSize != 0) {
+    return;
+  }
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  if (mon.total_size >= 128 * 1024) {
+    tabWindowSize = 5;
+  } else {
+    tabWindowSize = 3;
+  }
+  omote_log_i("Startup: lvgl has %lu bytes of memory, will keep %u tabs in memory\r\n", (unsigned long)mon.total_size, tabWindowSize);
+}
+
+// the gui_list_index of the active tab, -1 if there is none
+int get_gui_list_index_of_activeTab(t_gui_state *gui_state) {
+  if ((gui_state->activeTabID < 0) || (gui_state->activeTabID >= (int)gui_state->gui_on_tab.size())) {
+    return -1;
+  }
+  return gui_state->gui_on_tab[gui_state->activeTabID].gui_list_index;
+}
+
+bool gui_memoryOptimizer_isGUIshown(GUIlists GUIlist, int gui_list_index) {
+  return (gui_memoryOptimizer_getActiveGUIlist() == GUIlist) && (get_gui_list_index_of_activeTab(&gui_state) == gui_list_index);
+}
+
+void notify_singleTab_before_delete(t_gui_on_tab *gui_on_tab, int index) {
+  if (gui_on_tab->gui_list_index == -1) {
+    omote_log_d("    Will not notify tab %d about deletion because it does not exist\r\n", index);
+    return;
+  }
+  if (gui_on_tab->isSnapshot) {
+    // the gui was already notified when its widgets were replaced by the image
+    return;
+  }
+
+  // For deletion, do not use the gui_list_index, but the name of the gui.
+  // The gui_list might have changed (when switching from a scene specific list to the main list or vice versa), so index could have changed as well.
+  std::string nameOfTab = gui_on_tab->GUIname;
+  if (nameOfTab == "") {
+    omote_log_w("    Will not notify tab %d about deletion because it is not set\r\n", index);
+  } else if (registered_guis_byName_map.count(nameOfTab) == 0) {
+    omote_log_w("    Can not notify tab %d about deletion because name \"%s\" was not found in registry\r\n", index, nameOfTab.c_str());
+  } else {
+    omote_log_d("    Will notify tab %d with name \"%s\" about deletion\r\n", index, nameOfTab.c_str());
+    registered_guis_byName_map.at(nameOfTab).this_notify_tab_before_delete();
+  }
+}
+
 void notify_active_tabs_before_delete(t_gui_state *gui_state) {
   omote_log_d("  Will notify tabs about deletion\r\n");
-  std::string nameOfTab;
-  for (int index=0; index <= 2; index++) {
-    if (gui_state->gui_on_tab[index].gui_list_index == -1) {
-      omote_log_d("    Will not notify tab %d about deletion because it does not exist\r\n", index);
-      continue;
-    }
-
-    // For deletion, do not use the gui_list_index, but the name of the gui.
-    // The gui_list might have changed (when switching from a scene specific list to the main list or vice versa), so index could have changed as well.
-    nameOfTab = gui_state->gui_on_tab[index].GUIname;
-    if (nameOfTab == "") {
-      omote_log_w("    Will not notify tab %d about deletion because it is not set\r\n", index);
-    } else if (registered_guis_byName_map.count(nameOfTab) == 0) {
-      omote_log_w("    Can not notify tab %d about deletion because name \"%s\" was not found in registry\r\n", index, nameOfTab.c_str());
-    } else {
-      omote_log_d("    Will notify tab %d with name \"%s\" about deletion\r\n", index, nameOfTab.c_str());
-      registered_guis_byName_map.at(nameOfTab).this_notify_tab_before_delete();
-    }
+  for (int index=0; index < gui_state->gui_on_tab.size(); index++) {
+    notify_singleTab_before_delete(&gui_state->gui_on_tab[index], index);
   }
 }
 
@@ -138,10 +219,7 @@ void clear_tabview(lv_obj_t* tabview, t_gui_state *gui_state) {
   lv_obj_del(tabview);
   tabview = NULL;
 
-  // the gui_list_index_previous is needed for setGUIlistIndicesToBeShown_afterSlide();
-  gui_state->gui_on_tab[0] = {NULL, "", -1, gui_state->gui_on_tab[0].gui_list_index};
-  gui_state->gui_on_tab[1] = {NULL, "", -1, gui_state->gui_on_tab[1].gui_list_index};
-  gui_state->gui_on_tab[2] = {NULL, "", -1, gui_state->gui_on_tab[2].gui_list_index};
+  gui_state->gui_on_tab.clear();
 
 }
 
@@ -151,9 +229,14 @@ void clear_panel(lv_obj_t* panel, lv_obj_t* img1, lv_obj_t* img2) {
   safe_delete_lv_obj(img2, "img2");
 }
 
+// Number of tab buttons of the tabview, i.e. how often lv_tabview_add_tab() was called since the tabview was created.
+// lvgl has no public getter for it, see create_tab_page().
+uint32_t tabviewTabButtonCount = 0;
+
 lv_obj_t* create_tabview() {
   // Setup a scrollable tabview for devices and settings ----------------------------------------------------
   lv_obj_t* tabview = lv_tabview_create(lv_scr_act(), LV_DIR_TOP, 0); // Hide tab labels by setting their height to 0
+  tabviewTabButtonCount = 0;
   #ifdef drawRedBorderAroundMainWidgets
   lv_obj_add_style(tabview, &style_red_border, LV_PART_MAIN);
   #endif
@@ -186,7 +269,195 @@ std::string get_name_of_gui_to_be_shown(int index) {
   }
 }
 
-void create_new_tab(lv_obj_t* tabview, t_gui_on_tab *gui_on_tab) {
+// Creates a new, empty page in the tabview.
+// If a page of the tabview was deleted before (see recycleTabsAfterSliding), the tabview still has a tab button for it.
+// In that case, the page is created the same way as lv_tabview_add_tab() does, but without adding one more tab button.
+lv_obj_t* create_tab_page(lv_obj_t* tabview, const char* name) {
+  lv_obj_t* content = lv_tabview_get_content(tabview);
+  if (lv_obj_get_child_cnt(content) >= tabviewTabButtonCount) {
+    tabviewTabButtonCount++;
+    return lv_tabview_add_tab(tabview, name);
+  }
+  lv_obj_t* page = lv_obj_create(content);
+  lv_obj_set_size(page, lv_pct(100), lv_pct(100));
+  lv_obj_clear_flag(page, LV_OBJ_FLAG_CLICK_FOCUSABLE);
+  return page;
+}
+
+#if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+// Images of guis, shown on the neighbour tabs instead of the real widgets. Showing an image is much faster than creating all widgets of a gui.
+// An image is taken when the gui is created as a neighbour, and again whenever the gui stops being the active tab, so it shows what was seen last.
+// Images stay in the cache after their gui left the tabview, so a gui coming back as neighbour does not need to be created at all.
+// One image takes about SCR_WIDTH * tabviewHeight * 2 bytes. The buffers are allocated with malloc_largeBuffer(), so they are in PSRAM if available.
+// std::list, because the tabs keep pointers to the image descriptors
+struct t_tabSnapshot {
+  std::string GUIname;
+  lv_img_dsc_t dsc;
+  void* buf;
+  uint32_t bufSize;
+  uint32_t lastUsed;
+};
+std::list<t_tabSnapshot> tabSnapshotCache;
+uint32_t tabSnapshotUseCounter = 0;
+// switched off, neighbour tabs get their widgets like without GUI_SNAPSHOT_NEIGHBOUR_TABS
+bool snapshotNeighbourTabs = true;
+
+t_tabSnapshot* find_tabSnapshot(const std::string &GUIname) {
+  for (std::list<t_tabSnapshot>::iterator it = tabSnapshotCache.begin(); it != tabSnapshotCache.end(); it++) {
+    if (it->GUIname == GUIname) {
+      it->lastUsed = ++tabSnapshotUseCounter;
+      return &(*it);
+    }
+  }
+  return NULL;
+}
+
+bool is_tabSnapshot_shown(const std::string &GUIname) {
+  for (int i=0; i < gui_state.gui_on_tab.size(); i++) {
+    if (gui_state.gui_on_tab[i].isSnapshot && (gui_state.gui_on_tab[i].GUIname == GUIname)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void remove_tabSnapshot(t_tabSnapshot* snapshot) {
+  for (std::list<t_tabSnapshot>::iterator it = tabSnapshotCache.begin(); it != tabSnapshotCache.end(); it++) {
+    if (&(*it) == snapshot) {
+      free_largeBuffer(it->buf);
+      tabSnapshotCache.erase(it);
+      return;
+    }
+  }
+}
+
+// Removes the least recently used image which is not shown on a tab. Returns false if every image is in use.
+bool evict_tabSnapshot() {
+  t_tabSnapshot* oldest = NULL;
+  for (std::list<t_tabSnapshot>::iterator it = tabSnapshotCache.begin(); it != tabSnapshotCache.end(); it++) {
+    if (!is_tabSnapshot_shown(it->GUIname) && ((oldest == NULL) || (it->lastUsed < oldest->lastUsed))) {
+      oldest = &(*it);
+    }
+  }
+  if (oldest == NULL) {
+    return false;
+  }
+  omote_log_d("    Will remove image of \"%s\" from cache\r\n", oldest->GUIname.c_str());
+  remove_tabSnapshot(oldest);
+  return true;
+}
+
+// Removes all images not shown on a tab, e.g. because a new scene could change what the guis show
+void clear_tabSnapshots() {
+  while (evict_tabSnapshot()) {}
+}
+
+// Renders the tab with all its widgets into an image and puts it into the cache. Returns NULL if this was not possible.
+t_tabSnapshot* take_tabSnapshot(lv_obj_t* tab, const std::string &GUIname) {
+  unsigned long startTime = millis();
+
+  lv_obj_update_layout(tab);
+  uint32_t bufSize = lv_snapshot_buf_size_needed(tab, LV_IMG_CF_TRUE_COLOR);
+
+  t_tabSnapshot* snapshot = find_tabSnapshot(GUIname);
+  if ((snapshot != NULL) && (snapshot->bufSize != bufSize)) {
+    free_largeBuffer(snapshot->buf);
+    snapshot->buf = NULL;
+    snapshot->bufSize = 0;
+  }
+  if (snapshot == NULL) {
+    while ((tabSnapshotCache.size() >= GUI_SNAPSHOT_CACHE_SIZE) && evict_tabSnapshot()) {}
+    tabSnapshotCache.push_back(t_tabSnapshot());
+    snapshot = &tabSnapshotCache.back();
+    snapshot->GUIname = GUIname;
+    snapshot->buf = NULL;
+    snapshot->bufSize = 0;
+    snapshot->lastUsed = ++tabSnapshotUseCounter;
+  }
+  if (snapshot->buf == NULL) {
+    snapshot->buf = malloc_largeBuffer(bufSize);
+    if (snapshot->buf == NULL) {
+      omote_log_w("    Could not allocate %lu bytes for image of \"%s\", will keep the widgets\r\n", (unsigned long)bufSize, GUIname.c_str());
+      remove_tabSnapshot(snapshot);
+      return NULL;
+    }
+    snapshot->bufSize = bufSize;
+  }
+
+  if (lv_snapshot_take_to_buf(tab, LV_IMG_CF_TRUE_COLOR, &snapshot->dsc, snapshot->buf, snapshot->bufSize) != LV_RES_OK) {
+    omote_log_w("    Could not take image of \"%s\", will keep the widgets\r\n", GUIname.c_str());
+    remove_tabSnapshot(snapshot);
+    return NULL;
+  }
+  // lvgl might still have the old image with the same address in its image cache
+  lv_img_cache_invalidate_src(&snapshot->dsc);
+
+  unsigned long cacheBytes = 0;
+  for (std::list<t_tabSnapshot>::iterator it = tabSnapshotCache.begin(); it != tabSnapshotCache.end(); it++) {
+    cacheBytes += it->bufSize;
+  }
+  omote_log_d("    Took image of \"%s\" in %lu ms, %lu bytes. Cache has %u images with %lu bytes\r\n", GUIname.c_str(), millis() - startTime, (unsigned long)snapshot->bufSize, (unsigned int)tabSnapshotCache.size(), cacheBytes);
+  return snapshot;
+}
+
+// The image has exactly the size of the tab, so it is used as background image of the tab. Padding and scrolling of the tab don't matter then.
+void show_tabSnapshot(t_gui_on_tab *gui_on_tab, t_tabSnapshot* snapshot) {
+  lv_obj_set_style_bg_img_src(gui_on_tab->tab, &snapshot->dsc, LV_PART_MAIN);
+  gui_on_tab->isSnapshot = true;
+}
+
+// Replaces the widgets of a gui by an image of them. If no image could be taken, the widgets are kept.
+void replace_widgets_by_tabSnapshot(t_gui_on_tab *gui_on_tab, int index) {
+  t_tabSnapshot* snapshot = take_tabSnapshot(gui_on_tab->tab, gui_on_tab->GUIname);
+  if (snapshot == NULL) {
+    return;
+  }
+  notify_singleTab_before_delete(gui_on_tab, index);
+  lv_obj_clean(gui_on_tab->tab);
+  show_tabSnapshot(gui_on_tab, snapshot);
+}
+
+// Creates the real widgets of a gui which was only shown as image
+void replace_tabSnapshot_by_widgets(t_gui_on_tab *gui_on_tab) {
+  omote_log_d("    Will create widgets of tab \"%s\" \r\n", gui_on_tab->GUIname.c_str());
+  lv_obj_remove_local_style_prop(gui_on_tab->tab, LV_STYLE_BG_IMG_SRC, LV_PART_MAIN);
+  gui_on_tab->isSnapshot = false;
+  registered_guis_byName_map.at(gui_on_tab->GUIname).this_create_tab_content(gui_on_tab->tab);
+}
+#endif
+
+bool gui_memoryOptimizer_setSnapshotNeighbourTabs(bool aSnapshotNeighbourTabs) {
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  snapshotNeighbourTabs = aSnapshotNeighbourTabs;
+  if (!snapshotNeighbourTabs) {
+    // the images still shown on a tab are removed with the next navigation
+    clear_tabSnapshots();
+  }
+  return true;
+  #else
+  return false;
+  #endif
+}
+bool gui_memoryOptimizer_getSnapshotNeighbourTabs() {
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  return snapshotNeighbourTabs;
+  #else
+  return false;
+  #endif
+}
+void gui_memoryOptimizer_getSnapshotCacheInfo(tabSnapshotCacheInfo *info) {
+  *info = {0, 0, 0};
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  for (std::list<t_tabSnapshot>::iterator it = tabSnapshotCache.begin(); it != tabSnapshotCache.end(); it++) {
+    info->images++;
+    info->bytes += it->bufSize;
+  }
+  info->maxImages = GUI_SNAPSHOT_CACHE_SIZE;
+  #endif
+}
+
+// asSnapshot: only show an image of the gui, if GUI_SNAPSHOT_NEIGHBOUR_TABS is enabled
+void create_new_tab(lv_obj_t* tabview, t_gui_on_tab *gui_on_tab, bool asSnapshot) {
   std::string nameOfTab = get_name_of_gui_to_be_shown(gui_on_tab->gui_list_index);
 
   if (nameOfTab == "") {
@@ -198,113 +469,78 @@ void create_new_tab(lv_obj_t* tabview, t_gui_on_tab *gui_on_tab) {
     // save name of tab for deletion later
     gui_on_tab->GUIname = nameOfTab;
     // create tab and save pointer to tab in gui_on_tab
-    gui_on_tab->tab = lv_tabview_add_tab(tabview, nameOfTab.c_str());
+    gui_on_tab->tab = create_tab_page(tabview, nameOfTab.c_str());
+    gui_on_tab->isSnapshot = false;
+    #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+    asSnapshot = asSnapshot && snapshotNeighbourTabs;
+    t_tabSnapshot* snapshot = asSnapshot ? find_tabSnapshot(nameOfTab) : NULL;
+    if (snapshot != NULL) {
+      // the gui does not need to be created at all
+      show_tabSnapshot(gui_on_tab, snapshot);
+      return;
+    }
+    #endif
     // let the gui create it's content
     registered_guis_byName_map.at(nameOfTab).this_create_tab_content(gui_on_tab->tab);
+    #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+    if (asSnapshot) {
+      replace_widgets_by_tabSnapshot(gui_on_tab, -1);
+    }
+    #endif
   }
 }
 
-// create up to three tabs and the content of the tabs
+// create up to tabWindowSize tabs and the content of the tabs
 /*
-example: gui_list: 0 1 2 3 4
+example: gui_list: 0 1 2 3 4, tabWindowSize 3
 in memory  active
-0 1 -1     0 <- first state, special case - also the initial state
+0 1        0 <- first state, special case - also the initial state
 0 1 2      1
 1 2 3      1
 2 3 4      1
-3 4 -1     1 <- last state, special case
+3 4        1 <- last state, special case
+With a larger window, there are more neighbours on each side of the active tab, as far as the gui list reaches.
 */
 void setGUIlistIndicesToBeShown_forSpecificGUIlistIndex(int gui_list_index, t_gui_state *gui_state) {
   // Set the gui_list_indeces to be shown for a specific gui_list_index
-  if (gui_list_index == 0) {
-    // first state
-    omote_log_d("  GUIlistIndices: will resume at specific index with \"first state\"\r\n");
-    gui_state->gui_on_tab[0] = {NULL, "", 0};
-    // take care if there is only one gui in list
-    gui_state->gui_on_tab[1] = {NULL, "", get_gui_list_active_withFallback()->size() >= 2 ? 1 : -1};
-    gui_state->gui_on_tab[2] = {NULL, "", -1};
-    gui_state->activeTabID = 0;
-  } else if (gui_list_index == get_gui_list_active_withFallback()->size() -1) {
-    // last state
-    omote_log_d("  GUIlistIndices: will resume at specific index with \"last state\"\r\n");
-    gui_state->gui_on_tab[0] = {NULL, "", gui_list_index -1};
-    gui_state->gui_on_tab[1] = {NULL, "", gui_list_index};
-    gui_state->gui_on_tab[2] = {NULL, "", -1};
-    gui_state->activeTabID = 1;
-  } else {
-    // any other state
-    omote_log_d("  GUIlistIndices: will resume at specific index with \"state between\"\r\n");
-    gui_state->gui_on_tab[0] = {NULL, "", gui_list_index -1};
-    gui_state->gui_on_tab[1] = {NULL, "", gui_list_index};
-    gui_state->gui_on_tab[2] = {NULL, "", gui_list_index +1};
-    gui_state->activeTabID = 1;
+  int gui_list_size = get_gui_list_active_withFallback()->size();
+  int neighbours = (tabWindowSize == GUI_TAB_WINDOW_WHOLE_LIST) ? gui_list_size : std::max((tabWindowSize -1) / 2, 1);
+  int first = std::max(gui_list_index - neighbours, 0);
+  int last  = std::min(gui_list_index + neighbours, gui_list_size -1);
+  omote_log_d("  GUIlistIndices: will resume at specific index %d with tabs for the indices %d to %d\r\n", gui_list_index, first, last);
+
+  gui_state->gui_on_tab.clear();
+  for (int index = first; index <= last; index++) {
+    gui_state->gui_on_tab.push_back({NULL, "", index, false});
   }
+  gui_state->activeTabID = gui_list_index - first;
 }
 
 void setGUIlistIndicesToBeShown_forFirstGUIinGUIlist(t_gui_state *gui_state) {
   omote_log_d("  GUIlistIndices: will show the first gui from \"gui_list\" as initial state\r\n");
   // take care if there is no gui in list
-  gui_state->gui_on_tab[0] = {NULL, "", get_gui_list_active_withFallback()->size() != 0 ? 0 : -1};
-  // take care if there is only one gui in list
-  gui_state->gui_on_tab[1] = {NULL, "", get_gui_list_active_withFallback()->size() >= 2 ? 1 : -1};
-  gui_state->gui_on_tab[2] = {NULL, "", -1};
-  gui_state->activeTabID = 0;
+  setGUIlistIndicesToBeShown_forSpecificGUIlistIndex(0, gui_state);
 }
 
-void setGUIlistIndicesToBeShown_afterSlide(t_gui_state *gui_state) {
-  int oldListIndex = -1;
- 
+void setGUIlistIndicesToBeShown_afterSlide(int newActiveGUIlistIndex, t_gui_state *gui_state) {
   if (gui_state->oldTabID > gui_state->activeTabID) {
-    // swipe to previous item in list
     omote_log_d("  Will swipe to previous item in list\r\n");
-    oldListIndex = gui_state->gui_on_tab[1].gui_list_index_previous;
-    if (oldListIndex == 1) {
-      // next state is the "first state"
-      gui_state->gui_on_tab[0] = {NULL, "", 0};
-      gui_state->gui_on_tab[1] = {NULL, "", 1};
-      gui_state->gui_on_tab[2] = {NULL, "", -1};
-      gui_state->activeTabID = 0;
-    } else {
-      gui_state->gui_on_tab[0] = {NULL, "", oldListIndex -2};
-      gui_state->gui_on_tab[1] = {NULL, "", oldListIndex -1};
-      gui_state->gui_on_tab[2] = {NULL, "", oldListIndex};
-      gui_state->activeTabID = 1;
-    }
   } else {
-    // swipe to next item in list
     omote_log_d("  Will swipe to next item in list\r\n");
-    if (gui_state->gui_on_tab[2].gui_list_index_previous == -1) {
-      // last state was the first state
-      oldListIndex = gui_state->gui_on_tab[0].gui_list_index_previous; // is always 0
-    } else {
-      oldListIndex = gui_state->gui_on_tab[1].gui_list_index_previous;
-    }
-    if (oldListIndex == get_gui_list_active_withFallback()->size() -2) {
-      // next state is the "last state"
-      gui_state->gui_on_tab[0] = {NULL, "", oldListIndex};
-      gui_state->gui_on_tab[1] = {NULL, "", oldListIndex +1};
-      gui_state->gui_on_tab[2] = {NULL, "", -1};
-      gui_state->activeTabID = 1;
-    } else {
-      gui_state->gui_on_tab[0] = {NULL, "", oldListIndex};
-      gui_state->gui_on_tab[1] = {NULL, "", oldListIndex +1};
-      gui_state->gui_on_tab[2] = {NULL, "", oldListIndex +2};
-      gui_state->activeTabID = 1;
-    }
   }
- 
+  setGUIlistIndicesToBeShown_forSpecificGUIlistIndex(newActiveGUIlistIndex, gui_state);
 }
 
-void doTabCreation_strategyMax3(lv_obj_t* tabview, t_gui_state *gui_state) {
+void doTabCreation_strategyTabWindow(lv_obj_t* tabview, t_gui_state *gui_state) {
   
   // create the tabs
-  omote_log_d("  Will create tabs. List indices of the three tabs are %d, %d, %d, tab nr %d will be activated\r\n", gui_state->gui_on_tab[0].gui_list_index, gui_state->gui_on_tab[1].gui_list_index, gui_state->gui_on_tab[2].gui_list_index, gui_state->activeTabID);
-  for (int i=0; i<3; i++) {
-    create_new_tab(tabview, &gui_state->gui_on_tab[i]);
+  omote_log_d("  Will create %d tabs, starting with list index %d, tab nr %d will be activated\r\n", (int)gui_state->gui_on_tab.size(), gui_state->gui_on_tab.empty() ? -1 : gui_state->gui_on_tab[0].gui_list_index, gui_state->activeTabID);
+  for (int i=0; i<gui_state->gui_on_tab.size(); i++) {
+    create_new_tab(tabview, &gui_state->gui_on_tab[i], i != gui_state->activeTabID);
   }
 
   if (get_gui_list_active_withFallback()->size() > 0) {
-    std::string nameOfNewActiveTab = get_gui_list_active_withFallback()->at(gui_state->gui_on_tab[gui_state->activeTabID].gui_list_index);
+    std::string nameOfNewActiveTab = get_gui_list_active_withFallback()->at(get_gui_list_index_of_activeTab(gui_state));
     omote_log_d("  New visible tab is \"%s\"\r\n", nameOfNewActiveTab.c_str());
 
     // set active tab
@@ -313,12 +549,235 @@ void doTabCreation_strategyMax3(lv_obj_t* tabview, t_gui_state *gui_state) {
   }
 }
 
+// After sliding, most of the tabs are still needed, only at another position. Instead of recreating all tabs,
+// keep the lvgl objects of the tabs still needed, delete the ones not needed anymore and only create the newly exposed neighbours.
+// Never more than tabWindowSize guis are in memory: the tabs not needed anymore are deleted before the new ones are created.
+// Returns false without changing anything if recycling is not possible. Then all tabs have to be recreated.
+bool recycleTabsAfterSliding(lv_obj_t* tabview, int newActiveGUIlistIndex, t_gui_state *gui_state) {
+  if ((tabview == NULL) || !lv_obj_is_valid(tabview)) {
+    return false;
+  }
+
+  // calculate the new gui_list_indices on a copy, so that the current state is untouched if recycling is not possible
+  t_gui_state newState = *gui_state;
+  setGUIlistIndicesToBeShown_afterSlide(newActiveGUIlistIndex, &newState);
+
+  int oldTabCount = gui_state->gui_on_tab.size();
+  int newTabCount = newState.gui_on_tab.size();
+  std::vector<bool> isReused(oldTabCount, false);
+  for (int j=0; j<newTabCount; j++) {
+    // keep the tab if it is already in memory
+    for (int i=0; i<oldTabCount; i++) {
+      if (!isReused[i] && (gui_state->gui_on_tab[i].tab != NULL) && (gui_state->gui_on_tab[i].gui_list_index == newState.gui_on_tab[j].gui_list_index)) {
+        newState.gui_on_tab[j].tab = gui_state->gui_on_tab[i].tab;
+        newState.gui_on_tab[j].GUIname = gui_state->gui_on_tab[i].GUIname;
+        newState.gui_on_tab[j].isSnapshot = gui_state->gui_on_tab[i].isSnapshot;
+        isReused[i] = true;
+        break;
+      }
+    }
+    // a tab which has to be created must exist in the registry, otherwise the positions of the tabs would not fit
+    if ((newState.gui_on_tab[j].tab == NULL) && (registered_guis_byName_map.count(get_name_of_gui_to_be_shown(newState.gui_on_tab[j].gui_list_index)) == 0)) {
+      return false;
+    }
+  }
+  // lvgl cannot remove a tab button from a tabview. When there are less tabs than before, the whole tabview has to be recreated.
+  if ((newTabCount < oldTabCount) || (lv_obj_get_child_cnt(lv_tabview_get_content(tabview)) != oldTabCount)) {
+    return false;
+  }
+
+  omote_log_d("  Will recycle tabs. Will have %d tabs, starting with list index %d, tab nr %d will be activated\r\n", newTabCount, newState.gui_on_tab[0].gui_list_index, newState.activeTabID);
+
+  // 1. notify and delete the tabs not needed anymore
+  for (int i=0; i<oldTabCount; i++) {
+    if ((gui_state->gui_on_tab[i].tab != NULL) && !isReused[i]) {
+      notify_singleTab_before_delete(&gui_state->gui_on_tab[i], i);
+      safe_delete_lv_obj(gui_state->gui_on_tab[i].tab, "tab");
+    }
+  }
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  // the tab we slid away from is only a neighbour now
+  for (int j=0; j<newTabCount; j++) {
+    if (snapshotNeighbourTabs && (newState.gui_on_tab[j].tab != NULL) && !newState.gui_on_tab[j].isSnapshot && (j != newState.activeTabID)) {
+      replace_widgets_by_tabSnapshot(&newState.gui_on_tab[j], j);
+    }
+  }
+  #endif
+  // 2. create the new tabs and put all tabs at their new position
+  for (int j=0; j<newTabCount; j++) {
+    if (newState.gui_on_tab[j].tab == NULL) {
+      create_new_tab(tabview, &newState.gui_on_tab[j], j != newState.activeTabID);
+    }
+    lv_obj_move_to_index(newState.gui_on_tab[j].tab, j);
+    lv_tabview_rename_tab(tabview, j, newState.gui_on_tab[j].GUIname.c_str());
+  }
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  // the tab we slid to was only shown as image during the animation
+  if (newState.gui_on_tab[newState.activeTabID].isSnapshot) {
+    replace_tabSnapshot_by_widgets(&newState.gui_on_tab[newState.activeTabID]);
+  }
+  #endif
+
+  *gui_state = newState;
+
+  std::string nameOfNewActiveTab = gui_state->gui_on_tab[gui_state->activeTabID].GUIname;
+  omote_log_d("  New visible tab is \"%s\"\r\n", nameOfNewActiveTab.c_str());
+  setActiveTab(gui_state->activeTabID, LV_ANIM_OFF);
+  gui_memoryOptimizer_setActiveGUIname(nameOfNewActiveTab);
+
+  return true;
+}
+
 LV_IMG_DECLARE(gradientLeft);
 LV_IMG_DECLARE(gradientRight);
 
-void fillPanelWithPageIndicator_strategyMax3(lv_obj_t* panel, lv_obj_t* img1, lv_obj_t* img2, t_gui_state *gui_state) {
+// The page indicator is created only once for a certain layout and then updated in place on every navigation.
+// It only has to be recreated if one of these values changes.
+struct t_pageIndicator_layout {
+  int tabCount;
+  uint8_t mainGuiListLength;
+  uint8_t sceneGuiListLength;
+  bool show_scene_gui_list;
+};
+struct t_pageIndicator {
+  // false if the page indicator has not been created completely (no gui available, low memory), so it cannot be updated in place
+  bool isComplete = false;
+  t_pageIndicator_layout layout;
+  lv_obj_t* firstIndicator = NULL;
+  lv_obj_t* lastIndicator = NULL;
+  // the indicator for each tab in memory. Its children are the breadcrump dots for the main_gui_list, then for the scene gui list, and the label as last child
+  std::vector<lv_obj_t*> tabIndicator;
+};
+t_pageIndicator pageIndicator;
+
+t_pageIndicator_layout get_pageIndicator_layout(t_gui_state *gui_state) {
+  t_pageIndicator_layout layout;
+  layout.tabCount = gui_state->gui_on_tab.size();
+  layout.mainGuiListLength = get_gui_list_withFallback(MAIN_GUI_LIST)->size();
+  layout.sceneGuiListLength = get_gui_list_withFallback(SCENE_GUI_LIST)->size();
+  #if (USE_SCENE_SPECIFIC_GUI_LIST != 0)
+  layout.show_scene_gui_list = get_scene_has_gui_list(gui_memoryOptimizer_getActiveSceneName());
+  #else
+  layout.show_scene_gui_list = false;
+  #endif
+  return layout;
+}
+
+bool isSame_pageIndicator_layout(const t_pageIndicator_layout &a, const t_pageIndicator_layout &b) {
+  return (a.tabCount == b.tabCount) && (a.mainGuiListLength == b.mainGuiListLength) && (a.sceneGuiListLength == b.sceneGuiListLength) && (a.show_scene_gui_list == b.show_scene_gui_list);
+}
+
+// Sets everything in the page indicator which depends on the guis currently in memory: colors, labels and what happens when clicking on it.
+// Only changes properties of already existing objects, nothing is created here.
+void updatePanelWithPageIndicator_strategyTabWindow(t_gui_state *gui_state) {
+/*
+  There needs to be two more screen indicators because of their different size (158 for page indicator, 240 for whole tab)
+  In some cases they need to have color black, if they are before the first tab or after the last tab.
+  In all other cases, they have color "color_primary". See this list:
+  example: gui_list: 0 1 2 3 4, tabWindowSize 3
+  in memory  color         active
+  0 1        b p p p       0 <- first state, special case - also the initial state
+  0 1 2      b p p p p     1
+  1 2 3      p p p p p     1
+  2 3 4      p p p p b     1
+  3 4        p p p b       1 <- last state, special case
+*/
+  // first page indicator before the first tab
+  if (gui_state->gui_on_tab.front().gui_list_index == 0) {
+    lv_obj_set_style_bg_color(pageIndicator.firstIndicator, lv_color_black(), LV_PART_MAIN);
+  } else {
+    lv_obj_set_style_bg_color(pageIndicator.firstIndicator, color_primary,    LV_PART_MAIN);
+  }
+
+  uint8_t breadcrumpMainGuiListLength = pageIndicator.layout.mainGuiListLength;
+  uint8_t breadcrumpSceneGuiListLength = pageIndicator.layout.sceneGuiListLength;
+  GUIlists activeGUIlist = gui_memoryOptimizer_getActiveGUIlist();
+  int lastActiveGUIlistIndex = gui_memoryOptimizer_getLastActiveGUIlistIndex();
+
+  // update the panel content for the guis which are currently in memory
+  uint8_t breadcrumpPosition;
+  for (int i=0; i<pageIndicator.layout.tabCount; i++) {
+    lv_obj_t* btn = pageIndicator.tabIndicator[i];
+    breadcrumpPosition = gui_state->gui_on_tab[i].gui_list_index +1;
+
+    lv_obj_remove_event_cb(btn, sceneLabel_or_pageIndicator_event_cb);
+    lv_obj_remove_event_cb(btn, pageIndicator_navigate_event_cb);
+    if (i == gui_state->activeTabID) {
+      // only if this is the button for the currently active tab, make it clickable to get to scene selection gui
+      lv_obj_set_user_data(btn,(void *)(intptr_t)2);
+      lv_obj_add_event_cb(btn, sceneLabel_or_pageIndicator_event_cb, LV_EVENT_CLICKED, NULL);
+
+    } else if (i < gui_state->activeTabID) {
+      // this is the button on the previous tab, which can be seen on the active tab
+      // activate click to prev tab
+      lv_obj_set_user_data(btn,(void *)(intptr_t)0);
+      lv_obj_add_event_cb(btn, pageIndicator_navigate_event_cb, LV_EVENT_CLICKED, NULL);
+
+    } else {
+      // this is the button on the next tab, which can be seen on the active tab
+      // activate click to next tab
+      lv_obj_set_user_data(btn,(void *)(intptr_t)1);
+      lv_obj_add_event_cb(btn, pageIndicator_navigate_event_cb, LV_EVENT_CLICKED, NULL);
+
+    }
+
+    // the label for nameOfGUI is the last child
+    lv_label_set_text(lv_obj_get_child(btn, -1), gui_state->gui_on_tab[i].GUIname.c_str());
+
+    uint32_t dotCount = breadcrumpMainGuiListLength + (pageIndicator.layout.show_scene_gui_list ? breadcrumpSceneGuiListLength : 0);
+    if (lv_obj_get_child_cnt(btn) != dotCount + 1) {
+      // not all dots could be created
+      continue;
+    }
+
+    // the breadcrump dots for the main_gui_list are the first children of the button
+    for (int j=0; j<breadcrumpMainGuiListLength; j++) {
+      lv_obj_t* dot = lv_obj_get_child(btn, j);
+      // hightlight dot if it is the one for the currently active tab
+      if ( ((activeGUIlist == MAIN_GUI_LIST) || !pageIndicator.layout.show_scene_gui_list)
+           && (j == (breadcrumpPosition-1))) {
+        lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 255), LV_PART_MAIN);
+      } else if ((activeGUIlist == SCENE_GUI_LIST) && pageIndicator.layout.show_scene_gui_list && (j == lastActiveGUIlistIndex)) {
+        // hightlight dot a little bit if it is at least the one which was last active in the other gui list
+        lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 140), LV_PART_MAIN);
+      } else {
+        lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 30), LV_PART_MAIN);
+      }
+    }
+
+    // followed by the breadcrump dots for the scene gui list, if there is one
+    if (pageIndicator.layout.show_scene_gui_list) {
+      for (int j=0; j<breadcrumpSceneGuiListLength; j++) {
+        lv_obj_t* dot = lv_obj_get_child(btn, breadcrumpMainGuiListLength + j);
+        if ((activeGUIlist == SCENE_GUI_LIST) && (j == (breadcrumpPosition-1))) {
+          // hightlight dot if it is the one for the currently active tab
+          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 255), LV_PART_MAIN);
+        } else if ((activeGUIlist == MAIN_GUI_LIST) && (j == lastActiveGUIlistIndex)) {
+          // hightlight dot a little bit if it is at least the one which was last active in the other gui list
+          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 140), LV_PART_MAIN);
+        } else {
+          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 30), LV_PART_MAIN);
+        }
+      }
+    }
+  }
+
+  // last page indicator after the last tab
+  // black if the last tab in memory is the last gui in the list
+  if (gui_state->gui_on_tab.back().gui_list_index == get_gui_list_active_withFallback()->size()-1) {
+    lv_obj_set_style_bg_color(pageIndicator.lastIndicator, lv_color_black(), LV_PART_MAIN);
+  } else {
+    lv_obj_set_style_bg_color(pageIndicator.lastIndicator, color_primary,    LV_PART_MAIN);
+  }
+}
+
+// Creates all objects of the page indicator. Everything depending on the guis currently in memory is set afterwards by updatePanelWithPageIndicator_strategyTabWindow()
+void fillPanelWithPageIndicator_strategyTabWindow(lv_obj_t* panel, lv_obj_t* img1, lv_obj_t* img2, t_gui_state *gui_state) {
   omote_log_d("  Will fill panel with page indicators\r\n");
 
+  pageIndicator.isComplete = false;
+  pageIndicator.layout = get_pageIndicator_layout(gui_state);
+
   if (get_gui_list_active_withFallback()->size() == 0) {
     omote_log_d("    no tab available, so no page indicators\r\n");
     // at least add the style
@@ -341,45 +800,27 @@ void fillPanelWithPageIndicator_strategyMax3(lv_obj_t* panel, lv_obj_t* img1, lv
     return;
   }
 
+  bool isComplete = true;
+
   // This small hidden button enables the page indicator to scroll further
   lv_obj_t* btn = lv_btn_create(panel);
   lv_obj_set_size(btn, 50, lv_pct(100));
   lv_obj_set_style_shadow_width(btn, 0, LV_PART_MAIN);
   lv_obj_set_style_opa(btn, LV_OPA_TRANSP, LV_PART_MAIN);
 
-/*
-  There needs to be two more screen indicators because of their different size (158 for page indicator, 240 for whole tab)
-  In some cases they need to have color black, if they are before the first tab or after the last tab.
-  In all other cases, they have color "color_primary". See this list:
-  example: gui_list: 0 1 2 3 4
-  in memory  color         active
-  0 1 -1     b p p p       0 <- first state, special case - also the initial state
-  0 1 2      b p p p p     1
-  1 2 3      p p p p p     1
-  2 3 4      p p p p b     1
-  3 4 -1     p p p b       1 <- last state, special case
-*/
   // first page indicator before the first tab
   btn = lv_btn_create(panel);
   lv_obj_clear_flag(btn, LV_OBJ_FLAG_CLICKABLE);
   lv_obj_set_size(btn, 150, lv_pct(100));
-  if (gui_state->gui_on_tab[0].gui_list_index == 0) {
-    lv_obj_set_style_bg_color(btn, lv_color_black(), LV_PART_MAIN);
-  } else {
-    lv_obj_set_style_bg_color(btn, color_primary,    LV_PART_MAIN);
-  }
+  pageIndicator.firstIndicator = btn;
 
   uint8_t breadcrumpDotSize     = 8; // should be an even number
   uint8_t breadcrumpDotDistance = 2; // should be an even number
-  uint8_t breadcrumpMainGuiListLength = get_gui_list_withFallback(MAIN_GUI_LIST)->size();
+  uint8_t breadcrumpMainGuiListLength = pageIndicator.layout.mainGuiListLength;
   int8_t  breadcrumpMainGuiListStartPositionX = (-1) * (breadcrumpMainGuiListLength -1) * (breadcrumpDotSize + breadcrumpDotDistance) / 2;
-  uint8_t breadcrumpSceneGuiListLength = get_gui_list_withFallback(SCENE_GUI_LIST)->size();
+  uint8_t breadcrumpSceneGuiListLength = pageIndicator.layout.sceneGuiListLength;
   int8_t  breadcrumpSceneGuiListStartPositionX = (-1) * (breadcrumpSceneGuiListLength -1) * (breadcrumpDotSize + breadcrumpDotDistance) / 2;
-  #if (USE_SCENE_SPECIFIC_GUI_LIST != 0)
-  bool show_scene_gui_list = get_scene_has_gui_list(gui_memoryOptimizer_getActiveSceneName());
-  #else
-  bool show_scene_gui_list = false;
-  #endif
+  bool show_scene_gui_list = pageIndicator.layout.show_scene_gui_list;
   int8_t breadcrumpMainGuiList_yPos;
   int8_t breadcrumpSceneGuiList_yPos;
   int8_t nameOfGUI_yPos;
@@ -392,124 +833,68 @@ void fillPanelWithPageIndicator_strategyMax3(lv_obj_t* panel, lv_obj_t* img1, lv
     nameOfGUI_yPos = 8;
   }
 
-  // create the panel content for the three guis (or less) which are currently in memory
-  std::string nameOfGUI;
-  uint8_t breadcrumpPosition;
-  for (int i=0; i<3; i++) {
-    if (gui_state->gui_on_tab[i].gui_list_index != -1) {
-      nameOfGUI = gui_state->gui_on_tab[i].GUIname;
-      breadcrumpPosition = gui_state->gui_on_tab[i].gui_list_index +1;
-
-      // Create actual buttons for every tab
-      lv_obj_t* btn = lv_btn_create(panel);
-      if (i == gui_state->activeTabID) {
-        // only if this is the button for the currently active tab, make it clickable to get to scene selection gui
-        lv_obj_add_flag(btn, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_set_user_data(btn,(void *)(intptr_t)2);
-        lv_obj_add_event_cb(btn, sceneLabel_or_pageIndicator_event_cb, LV_EVENT_CLICKED, NULL);
-
-      } else if ((i==0 || i==1) && (gui_state->gui_on_tab[i+1].gui_list_index != -1)) {
-        // this is the button on the previous tab, which can be seen on the active tab
-        // activate click to prev tab
-        lv_obj_add_flag(btn, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_set_user_data(btn,(void *)(intptr_t)0);
-        lv_obj_add_event_cb(btn, pageIndicator_navigate_event_cb, LV_EVENT_CLICKED, NULL);
-
-      } else if (i==1 || i==2) {
-        // this is the button on the next tab, which can be seen on the active tab
-        // activate click to next tab
-        lv_obj_add_flag(btn, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_set_user_data(btn,(void *)(intptr_t)1);
-        lv_obj_add_event_cb(btn, pageIndicator_navigate_event_cb, LV_EVENT_CLICKED, NULL);
-
-      }
-      lv_obj_set_size(btn, 150, lv_pct(100));
-      lv_obj_remove_style(btn, NULL, LV_STATE_PRESSED);
-      lv_obj_set_style_shadow_width(btn, 0, LV_PART_MAIN);
-      lv_obj_set_style_bg_color(btn, color_primary, LV_PART_MAIN);
-
-      // create a breadcrump dot for each gui in the main_gui_list
-      for (int j=0; j<breadcrumpMainGuiListLength; j++) {
-        lv_obj_t* dot = lv_obj_create(btn);
-        if (dot == NULL) {
-          omote_log_e("fillPanelWithPageIndicator: Failed to create dot object, out of memory\n");
-          continue;
-        }
-        
-        lv_obj_set_size(dot, breadcrumpDotSize, breadcrumpDotSize);
-        lv_obj_set_style_radius(dot, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-        
-        // hightlight dot if it is the one for the currently active tab
-        #if (USE_SCENE_SPECIFIC_GUI_LIST != 0)
-        if ( ((gui_memoryOptimizer_getActiveGUIlist() == MAIN_GUI_LIST) || !get_scene_has_gui_list(gui_memoryOptimizer_getActiveSceneName()))
-        #else
-        if ( true
-        #endif
-             && (j == (breadcrumpPosition-1))) {
-          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 255), LV_PART_MAIN);
-        } else if ((gui_memoryOptimizer_getActiveGUIlist() == SCENE_GUI_LIST) && get_scene_has_gui_list(gui_memoryOptimizer_getActiveSceneName()) && (j == gui_memoryOptimizer_getLastActiveGUIlistIndex())) {
-          // hightlight dot a little bit if it is at least the one which was last active in the other gui list
-          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 140), LV_PART_MAIN);
-        } else {
-          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 30), LV_PART_MAIN);
-        }
-        
-        lv_obj_align(dot, LV_ALIGN_TOP_MID, breadcrumpMainGuiListStartPositionX +j*(breadcrumpDotSize + breadcrumpDotDistance), breadcrumpMainGuiList_yPos);
-        // this dot needs to get clickable again
-        lv_obj_set_user_data(dot,(void *)(intptr_t)1);
-        lv_obj_add_flag(dot, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_add_flag(dot, LV_OBJ_FLAG_EVENT_BUBBLE);
+  // create the panel content for the guis which are currently in memory
+  pageIndicator.tabIndicator.clear();
+  for (int i=0; i<gui_state->gui_on_tab.size(); i++) {
+    // Create actual buttons for every tab
+    lv_obj_t* btn = lv_btn_create(panel);
+    lv_obj_set_size(btn, 150, lv_pct(100));
+    lv_obj_remove_style(btn, NULL, LV_STATE_PRESSED);
+    lv_obj_set_style_shadow_width(btn, 0, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(btn, color_primary, LV_PART_MAIN);
+    pageIndicator.tabIndicator.push_back(btn);
+
+    // create a breadcrump dot for each gui in the main_gui_list
+    for (int j=0; j<breadcrumpMainGuiListLength; j++) {
+      lv_obj_t* dot = lv_obj_create(btn);
+      if (dot == NULL) {
+        omote_log_e("fillPanelWithPageIndicator: Failed to create dot object, out of memory\n");
+        isComplete = false;
+        continue;
       }
+      
+      lv_obj_set_size(dot, breadcrumpDotSize, breadcrumpDotSize);
+      lv_obj_set_style_radius(dot, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+      lv_obj_align(dot, LV_ALIGN_TOP_MID, breadcrumpMainGuiListStartPositionX +j*(breadcrumpDotSize + breadcrumpDotDistance), breadcrumpMainGuiList_yPos);
+      // this dot needs to get clickable again
+      lv_obj_set_user_data(dot,(void *)(intptr_t)1);
+      lv_obj_add_flag(dot, LV_OBJ_FLAG_CLICKABLE);
+      lv_obj_add_flag(dot, LV_OBJ_FLAG_EVENT_BUBBLE);
+    }
 
-      // create a breadcrump dot for each gui in the scene gui list, if there is one
-      if (show_scene_gui_list) {
-      for (int j=0; j<breadcrumpSceneGuiListLength; j++) {
-        lv_obj_t* dot = lv_obj_create(btn);
-        if (dot == NULL) {
-          omote_log_e("fillPanelWithPageIndicator: Failed to create scene dot object, out of memory\n");
-          continue;
-        }
-        
-        lv_obj_set_size(dot, breadcrumpDotSize, breadcrumpDotSize);
-        lv_obj_set_style_radius(dot, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-        if ((gui_memoryOptimizer_getActiveGUIlist() == SCENE_GUI_LIST) && (j == (breadcrumpPosition-1))) {
-          // hightlight dot if it is the one for the currently active tab
-          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 255), LV_PART_MAIN);
-        } else if ((gui_memoryOptimizer_getActiveGUIlist() == MAIN_GUI_LIST) && (j == gui_memoryOptimizer_getLastActiveGUIlistIndex())) {
-          // hightlight dot a little bit if it is at least the one which was last active in the other gui list
-          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 140), LV_PART_MAIN);
-        } else {
-          lv_obj_set_style_bg_color(dot, lv_color_lighten(color_primary, 30), LV_PART_MAIN);
-        }
-        
-        lv_obj_align(dot, LV_ALIGN_TOP_MID, breadcrumpSceneGuiListStartPositionX +j*(breadcrumpDotSize + breadcrumpDotDistance), breadcrumpSceneGuiList_yPos);
-        // this dot needs to get clickable again
-        lv_obj_set_user_data(dot,(void *)(intptr_t)1);
-        lv_obj_add_flag(dot, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_add_flag(dot, LV_OBJ_FLAG_EVENT_BUBBLE);
-      }
+    // create a breadcrump dot for each gui in the scene gui list, if there is one
+    if (show_scene_gui_list) {
+    for (int j=0; j<breadcrumpSceneGuiListLength; j++) {
+      lv_obj_t* dot = lv_obj_create(btn);
+      if (dot == NULL) {
+        omote_log_e("fillPanelWithPageIndicator: Failed to create scene dot object, out of memory\n");
+        isComplete = false;
+        continue;
       }
+      
+      lv_obj_set_size(dot, breadcrumpDotSize, breadcrumpDotSize);
+      lv_obj_set_style_radius(dot, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+      lv_obj_align(dot, LV_ALIGN_TOP_MID, breadcrumpSceneGuiListStartPositionX +j*(breadcrumpDotSize + breadcrumpDotDistance), breadcrumpSceneGuiList_yPos);
+      // this dot needs to get clickable again
+      lv_obj_set_user_data(dot,(void *)(intptr_t)1);
+      lv_obj_add_flag(dot, LV_OBJ_FLAG_CLICKABLE);
+      lv_obj_add_flag(dot, LV_OBJ_FLAG_EVENT_BUBBLE);
+    }
+    }
 
 
-      // create a label for nameOfGUI
-      lv_obj_t* label = lv_label_create(btn);
-      lv_obj_set_style_text_font(label, &lv_font_montserrat_10, LV_PART_MAIN);
-      lv_label_set_text_fmt(label, "%s", nameOfGUI.c_str());
-      lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, nameOfGUI_yPos);
+    // create a label for nameOfGUI
+    lv_obj_t* label = lv_label_create(btn);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_10, LV_PART_MAIN);
+    lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, nameOfGUI_yPos);
 
-    }
   }
 
   // last page indicator after the last tab
   btn = lv_btn_create(panel);
   lv_obj_clear_flag(btn, LV_OBJ_FLAG_CLICKABLE);
   lv_obj_set_size(btn, 150, lv_pct(100));
-  //   4 at last position                                                                         4 at middle position                                                                          only one tab available overall
-  if ((gui_state->gui_on_tab[2].gui_list_index == get_gui_list_active_withFallback()->size()-1) || (gui_state->gui_on_tab[1].gui_list_index == get_gui_list_active_withFallback()->size()-1) || (gui_state->gui_on_tab[1].gui_list_index == -1)) {
-    lv_obj_set_style_bg_color(btn, lv_color_black(), LV_PART_MAIN);
-  } else {
-    lv_obj_set_style_bg_color(btn, color_primary,    LV_PART_MAIN);
-  }
+  pageIndicator.lastIndicator = btn;
 
   // This small hidden button enables the page indicator to scroll further
   btn = lv_btn_create(panel);
@@ -544,20 +929,37 @@ void fillPanelWithPageIndicator_strategyMax3(lv_obj_t* panel, lv_obj_t* img1, lv
   lv_obj_add_style(img2, &style_red_border, LV_PART_MAIN);
   #endif
 
+  updatePanelWithPageIndicator_strategyTabWindow(gui_state);
+  pageIndicator.isComplete = isComplete;
+
 }
 
 void gui_memoryOptimizer_notifyAndClear(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_t** img1, lv_obj_t** img2, t_gui_state *gui_state) {
 
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  // keep an image of what was seen last, for the next time the gui is a neighbour
+  for (int index=0; index < gui_state->gui_on_tab.size(); index++) {
+    if (snapshotNeighbourTabs && (gui_state->gui_on_tab[index].tab != NULL) && !gui_state->gui_on_tab[index].isSnapshot) {
+      take_tabSnapshot(gui_state->gui_on_tab[index].tab, gui_state->gui_on_tab[index].GUIname);
+    }
+  }
+  #endif
   // 1. notify old guis that they will be deleted so that they can persist their state if needed
   notify_active_tabs_before_delete(gui_state);
   // 2. clear current tabview and save gui_list_index_previous (needed for swipe)
   clear_tabview(*tabview, gui_state);
-  // 3. clear current panel for page indicator
-  clear_panel(*panel, *img1, *img2);
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  if (!snapshotNeighbourTabs) {
+    // images left from before the images were switched off. Now none of them is shown anymore.
+    clear_tabSnapshots();
+  }
+  #endif
+  // the panel for the page indicator is not cleared here. It is updated in place by gui_memoryOptimizer_doPanelCreation(), if possible.
 
 }
 
 void gui_memoryOptimizer_doContentCreation(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_t** img1, lv_obj_t** img2, t_gui_state *gui_state);
+void gui_memoryOptimizer_doPanelCreation(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_t** img1, lv_obj_t** img2, t_gui_state *gui_state);
 
 // 1. tab creation on startup (called by init_gui())
 // find the position of the current GUI in the gui list which was active last (both were automatically saved in the preferences) 
@@ -572,6 +974,8 @@ void gui_memoryOptimizer_onStartup(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_
   gui_memoryOptimizer_getActiveGUIlist();
   gui_memoryOptimizer_getLastActiveGUIlistIndex();
 
+  chooseTabWindowSize();
+
   // 1. find last used gui
   int gui_list_index = -1;
   // find index of gui_memoryOptimizer_getActiveGUIname() in gui_list_active
@@ -607,10 +1011,18 @@ void gui_memoryOptimizer_afterSliding(lv_obj_t** tabview, lv_obj_t** panel, lv_o
   // Here the magic for dynamic creation and deletion of lvgl objects happens to keep memory usage low.
   // The next and previous tab must always be available in the tabview, because they can already been seen during the animation.
   // And you always need 3 tabs, otherwise you even could not slide to the next or previous tab.
-  // So we always have 3 tabs.
-  // After the animation, the tabview and hence all tabs are deleted and recreated.
+  // So we always have at least 3 tabs, or tabWindowSize tabs if more memory is available.
+  // After the animation, the tabs not needed anymore are deleted and the new neighbours are created. The other tabs are kept.
+  // Only if this is not possible, the tabview and hence all tabs are deleted and recreated.
 
   omote_log_d("--- Start of tab deletion and creation\r\n");
+  unsigned long startTime = millis();
+  unsigned long start_us = micros();
+
+  if (!gui_memoryOptimizer_isTabIDInMemory(newTabID) || !gui_memoryOptimizer_isTabIDInMemory(gui_state.activeTabID)) {
+    omote_log_w("  cannot slide to tab %d, because it is not in memory\r\n", newTabID);
+    return;
+  }
 
   gui_state.oldTabID = gui_state.activeTabID;
   gui_state.activeTabID = newTabID;
@@ -619,6 +1031,18 @@ void gui_memoryOptimizer_afterSliding(lv_obj_t** tabview, lv_obj_t** panel, lv_o
     gui_state.oldTabID,    gui_state.gui_on_tab[gui_state.oldTabID].GUIname.c_str(),
     gui_state.activeTabID, gui_state.gui_on_tab[gui_state.activeTabID].GUIname.c_str());
 
+  // the gui we slid to. Has to be saved before the tabs are cleared.
+  int newActiveGUIlistIndex = gui_state.gui_on_tab[newTabID].gui_list_index;
+
+  if (recycleTabsAfterSliding(*tabview, newActiveGUIlistIndex, &gui_state)) {
+    gui_memoryOptimizer_doPanelCreation(tabview, panel, img1, img2, &gui_state);
+    slideMetrics.slides++;
+    slideMetrics.recycled++;
+    slideMetrics.last_us = micros() - start_us;
+    omote_log_d("------------ End of tab recycling after %lu ms\r\n", millis() - startTime);
+    return;
+  }
+
   // 1. notify old guis and clear tabview and panel
   gui_memoryOptimizer_notifyAndClear(tabview, panel, img1, img2, &gui_state);
 
@@ -632,10 +1056,13 @@ void gui_memoryOptimizer_afterSliding(lv_obj_t** tabview, lv_obj_t** panel, lv_o
   // lv_obj_del(oldscr);
 
   // 2. set gui_list_indices and the tab to be activated
-  setGUIlistIndicesToBeShown_afterSlide(&gui_state);
+  setGUIlistIndicesToBeShown_afterSlide(newActiveGUIlistIndex, &gui_state);
 
   // 3. create content
   gui_memoryOptimizer_doContentCreation(tabview, panel, img1, img2, &gui_state);
+  slideMetrics.slides++;
+  slideMetrics.last_us = micros() - start_us;
+  omote_log_d("  Recreation of all tabs took %lu ms\r\n", millis() - startTime);
 
 }
 
@@ -646,11 +1073,15 @@ void gui_memoryOptimizer_afterGUIlistChanged(lv_obj_t** tabview, lv_obj_t** pane
 
   if (gui_state.last_active_gui_list != newGUIlist) {
     // we are changing the gui_list, so save the last_active_gui_list_index
-    gui_memoryOptimizer_setLastActiveGUIlistIndex(gui_state.gui_on_tab[gui_state.activeTabID].gui_list_index);
+    gui_memoryOptimizer_setLastActiveGUIlistIndex(get_gui_list_index_of_activeTab(&gui_state));
   }
   
   // 1. notify old guis and clear tabview and panel
   gui_memoryOptimizer_notifyAndClear(tabview, panel, img1, img2, &gui_state);
+  #if (GUI_SNAPSHOT_NEIGHBOUR_TABS != 0)
+  // a new scene might change what the guis show
+  clear_tabSnapshots();
+  #endif
 
   // 2. set gui_list_indices and the tab to be activated
   gui_memoryOptimizer_setActiveGUIlist(newGUIlist);
@@ -673,7 +1104,7 @@ void gui_memoryOptimizer_navigateToGUI(lv_obj_t** tabview, lv_obj_t** panel, lv_
 
   if (gui_state.last_active_gui_list != GUIlist) {
     // we are changing the gui_list, so save the last_active_gui_list_index
-    gui_memoryOptimizer_setLastActiveGUIlistIndex(gui_state.gui_on_tab[gui_state.activeTabID].gui_list_index);
+    gui_memoryOptimizer_setLastActiveGUIlistIndex(get_gui_list_index_of_activeTab(&gui_state));
   }
 
   // 1. notify old guis and clear tabview and panel
@@ -718,28 +1149,47 @@ void gui_memoryOptimizer_doContentCreation(lv_obj_t** tabview, lv_obj_t** panel,
   lv_obj_t* newTabview = create_tabview();
   *tabview = newTabview;
   
-  // Create the tabs. Use strategy "3 tabs at maximum" to keep memory usage low.
+  // Create the tabs. Use strategy "tabWindowSize tabs at maximum" to keep memory usage low.
   // Set the tab we swiped to as active
-  doTabCreation_strategyMax3(*tabview, gui_state);
-
-  // Create the panel for the page indicator. Panel itself takes about 2136 bytes for three tabs.
-  lv_obj_t* newPanel = create_panel();
-  *panel = newPanel;
-  *img1 = lv_img_create(lv_scr_act());
-  *img2 = lv_img_create(lv_scr_act());
-  fillPanelWithPageIndicator_strategyMax3(*panel, *img1, *img2, gui_state);
+  doTabCreation_strategyTabWindow(*tabview, gui_state);
 
   // now, as the correct tab is active, register again the events for the tabview
   lv_obj_add_event_cb(*tabview, tabview_tab_changed_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
   lv_obj_add_event_cb(lv_tabview_get_content(*tabview), tabview_content_is_scrolling_event_cb, LV_EVENT_SCROLL, NULL);
+  lv_obj_add_event_cb(lv_tabview_get_content(*tabview), tabview_content_scroll_begin_end_event_cb, LV_EVENT_SCROLL_BEGIN, NULL);
+  lv_obj_add_event_cb(lv_tabview_get_content(*tabview), tabview_content_scroll_begin_end_event_cb, LV_EVENT_SCROLL_END, NULL);
+
+  gui_memoryOptimizer_doPanelCreation(tabview, panel, img1, img2, gui_state);
+
+  omote_log_d("------------ End of tab deletion and creation\r\n");
+
+}
+
+// Creates or updates the page indicator for the tabs in the tabview. Called after all tabs were recreated, or after they were recycled.
+void gui_memoryOptimizer_doPanelCreation(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_t** img1, lv_obj_t** img2, t_gui_state *gui_state) {
+  if (pageIndicator.isComplete && (*panel != NULL) && lv_obj_is_valid(*panel) && isSame_pageIndicator_layout(pageIndicator.layout, get_pageIndicator_layout(gui_state))) {
+    // The panel already has all the objects needed, only colors, labels and click actions have to be changed
+    omote_log_d("  Will update page indicators\r\n");
+    updatePanelWithPageIndicator_strategyTabWindow(gui_state);
+
+  } else {
+    // clear current panel for page indicator
+    clear_panel(*panel, *img1, *img2);
+    // Create the panel for the page indicator. Panel itself takes about 2136 bytes for three tabs.
+    lv_obj_t* newPanel = create_panel();
+    *panel = newPanel;
+    *img1 = lv_img_create(lv_scr_act());
+    *img2 = lv_img_create(lv_scr_act());
+    fillPanelWithPageIndicator_strategyTabWindow(*panel, *img1, *img2, gui_state);
+    slideMetrics.pageIndicatorsCreated++;
+  }
+
   // Initialize scroll position of the page indicator
   lv_event_send(lv_tabview_get_content(*tabview), LV_EVENT_SCROLL, NULL);
 
-  // gui_memoryOptimizer_doContentCreation() is called as last step every time the 3 tabs are recreated.
+  // gui_memoryOptimizer_doPanelCreation() is called as last step every time the 3 tabs are recreated or recycled.
   // Save here the last_active_gui_list. If the used list changes in a future navigation, save the last_active_gui_list_index
   // so that we can use SCENE_BACK_TO_PREVIOUS_GUI_LIST
   gui_state->last_active_gui_list = gui_memoryOptimizer_getActiveGUIlist();
 
-  omote_log_d("------------ End of tab deletion and creation\r\n");
-
 }
@@ -15,7 +15,36 @@ void gui_memoryOptimizer_afterGUIlistChanged(lv_obj_t** tabview, lv_obj_t** pane
 void gui_memoryOptimizer_navigateToGUI(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_t** img1, lv_obj_t** img2, GUIlists GUIlist, int gui_list_index);
 void gui_memoryOptimizer_navigateToLastActiveGUIofPreviousGUIlist(lv_obj_t** tabview, lv_obj_t** panel, lv_obj_t** img1, lv_obj_t** img2);
 
+// Number of tabs kept in memory: the active tab and (size-1)/2 neighbours on each side, e.g. 3 or 5. Or all guis of the gui list with GUI_TAB_WINDOW_WHOLE_LIST.
+// Can be set at build time with -D GUI_TAB_WINDOW_SIZE. If not set, it is chosen on startup from the memory available for lvgl.
+// Even sizes are not possible, the active tab is always in the middle. The setter rejects them and keeps the current size, returns false then.
+#define GUI_TAB_WINDOW_WHOLE_LIST 255
+uint8_t gui_memoryOptimizer_getTabWindowSize();
+bool gui_memoryOptimizer_setTabWindowSize(uint8_t aTabWindowSize);
+
+// Tab changes by sliding, and the time needed to delete and create the tabs after them. Used by the self tests.
+struct tabSlideMetrics {
+  uint32_t slides;          // tab changes by sliding so far
+  uint32_t recycled;        // how many of them kept the tabs still needed. The others recreated all tabs.
+  unsigned long last_us;    // time needed after the last one
+  uint32_t pageIndicatorsCreated; // page indicators created anew by any navigation, instead of updated in place
+};
+void gui_memoryOptimizer_getSlideMetrics(tabSlideMetrics *metrics);
+
+// Neighbour tabs only shown as image of the gui, if compiled in with -D GUI_SNAPSHOT_NEIGHBOUR_TABS=1. Then it can be switched off and on again, e.g. by the self tests.
+// Takes effect with the next navigation. The setter returns false if the images are not compiled in.
+bool gui_memoryOptimizer_setSnapshotNeighbourTabs(bool aSnapshotNeighbourTabs);
+bool gui_memoryOptimizer_getSnapshotNeighbourTabs();
+struct tabSnapshotCacheInfo {
+  uint32_t images;          // images in the cache, shown on a tab or not
+  uint32_t bytes;           // bytes of their buffers
+  uint32_t maxImages;       // GUI_SNAPSHOT_CACHE_SIZE
+};
+void gui_memoryOptimizer_getSnapshotCacheInfo(tabSnapshotCacheInfo *info);
+
 int gui_memoryOptimizer_getActiveTabID();
+// true if this gui of this gui list is the one on the active tab
+bool gui_memoryOptimizer_isGUIshown(GUIlists GUIlist, int gui_list_index);
 bool gui_memoryOptimizer_isTabIDInMemory(int tabID);
 bool gui_memoryOptimizer_isGUInameInMemory(std::string GUIname);
 
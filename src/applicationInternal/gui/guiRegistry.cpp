@@ -57,6 +57,8 @@ void setKeysForAllRegisteredGUIsAndScenes() {
   // Whenever a new gui or scene is registered, a new gui or scene command could have been defined in the gui or scene.
   // But this new command could have already been used before in the key definition of another gui or scene. The command at this time was 0, which is undefined.
   // So we have to set the keys again for all guis and scenes that have been registered before.
+  // The key bindings resolved for the active scene and gui are not valid anymore
+  invalidate_keyBindings();
   // 1. set again the defaultKeys
   register_scene_defaultKeys();
   // 2. loop over all registered scenes and call setKeys()
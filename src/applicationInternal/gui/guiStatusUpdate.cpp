@@ -1,6 +1,9 @@
 #include <lvgl.h>
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "applicationInternal/memoryUsage.h"
+#include "applicationInternal/frameStatistics.h"
+#include "applicationInternal/energyModel.h"
+#include "applicationInternal/taskSplit.h"
 #include "guis/gui_settings.h"
 #include "applicationInternal/gui/guiBase.h"
 
@@ -80,7 +83,7 @@ void updateKeyboardBLEstatusOnGUI() {
 }
 #endif
 
-// update user_led, battery, BLE, memoryUsage on GUI
+// update user_led, battery, BLE, memoryUsage, frameStatistics on GUI, log the energy model
 void updateHardwareStatusAndShowOnGUI(void) {
 
   update_userled();
@@ -94,5 +97,10 @@ void updateHardwareStatusAndShowOnGUI(void) {
   #endif
 
   doLogMemoryUsage();
+  doLogFrameStatistics();
+  doLogEnergyModel();
+  #if (ENABLE_TASK_SPLIT == 1)
+  doLogTaskStatistics();
+  #endif
 
 }
@@ -1,6 +1,120 @@
 #include <string>
-#include "applicationInternal/hardware/IRremoteProtocols.h"
+#include <algorithm>
+#include <stdlib.h>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/omote_log.h"
 
 std::string concatenateIRsendParams(std::string data, uint16_t nbits, uint16_t repeat) {
   return data + ":" + std::to_string(nbits) + ":" + std::to_string(repeat);
-}
\ No newline at end of file
+}
+
+bool getProtocolDefaultBitsAndRepeat(int protocol, uint16_t *nbits, uint16_t *repeat) {
+  // for more defaults, see file IRremoteESP8266/src/IRsend.h
+  // Note: some of the AC protocols expect the length of the state in bytes, not in bits
+  switch (protocol) {
+    case IR_PROTOCOL_RC5:          {*nbits = kRC5XBits;              *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_NEC:          {*nbits = kNECBits;               *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SONY:         {*nbits = kSony20Bits;            *repeat = kSonyMinRepeat;          return true;}
+    case IR_PROTOCOL_JVC:          {*nbits = kJvcBits;               *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SAMSUNG:      {*nbits = kSamsungBits;           *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_LG:           {*nbits = kLgBits;                *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SANYO:        {*nbits = kSanyoLC7461Bits;       *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SHARP:        {*nbits = kSharpBits;             *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_DENON:        {*nbits = kDenonBits;             *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SHERWOOD:     {*nbits = kSherwoodBits;          *repeat = kSherwoodMinRepeat;      return true;}
+    case IR_PROTOCOL_SAMSUNG_AC:   {*nbits = kSamsungAcStateLength;  *repeat = kSamsungAcDefaultRepeat; return true;}
+    case IR_PROTOCOL_LG2:          {*nbits = kLgBits;                *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SAMSUNG36:    {*nbits = kSamsung36Bits;         *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SHARP_AC:     {*nbits = kSharpAcStateLength;    *repeat = kSharpAcDefaultRepeat;   return true;}
+    case IR_PROTOCOL_SANYO_AC:     {*nbits = kSanyoAcStateLength;    *repeat = kNoRepeat;               return true;}
+    case IR_PROTOCOL_SANYO_AC88:   {*nbits = kSanyoAc88StateLength;  *repeat = kSanyoAc88MinRepeat;     return true;}
+    case IR_PROTOCOL_SANYO_AC152:  {*nbits = kSanyoAc152StateLength; *repeat = kSanyoAc152MinRepeat;    return true;}
+    case IR_PROTOCOL_WOWWEE:       {*nbits = kWowweeBits;            *repeat = kWowweeDefaultRepeat;    return true;}
+    case IR_PROTOCOL_YORK:         {*nbits = kYorkStateLength;       *repeat = kNoRepeat;               return true;}
+
+    default: {
+      *nbits = 0; *repeat = kNoRepeat; return false;
+    }
+  }
+}
+
+// Parses one unsigned value (decimal, or hex with prefix "0x") which has to be followed by the character 'expectedEnd'.
+// Leading and trailing spaces are ignored. On success, 'str' is moved behind 'expectedEnd'.
+static bool parseIRvalue(const char **str, char expectedEnd, uint64_t *value) {
+  char *end;
+  *value = strtoull(*str, &end, 0);
+  if (end == *str) {
+    return false;
+  }
+  while (*end == ' ') {
+    end++;
+  }
+  if (*end != expectedEnd) {
+    return false;
+  }
+  *str = (expectedEnd == '\0') ? end : end + 1;
+  return true;
+}
+
+bool parseIRcode(int protocol, const std::string &payload, IRcode *irCode) {
+  *irCode = IRcode{(int16_t)protocol, false, 0, kNoRepeat, 0, 0, NULL};
+
+  if (payload == "") {
+    omote_log_w("parseIRcode: IR code for protocol %d has no data\r\n", protocol);
+    return false;
+  }
+
+  const char *current = payload.c_str();
+  uint64_t value;
+
+  if (protocol == IR_PROTOCOL_GLOBALCACHE) {
+    // not a protocol, but an encoding
+    // first create array of needed size
+    uint16_t size = std::count(payload.begin(), payload.end(), ',') + 1;
+    uint16_t *buf = new uint16_t[size];
+    // now get comma separated values and fill array
+    for (uint16_t pos = 0; pos < size; pos++) {
+      if (!parseIRvalue(&current, (pos < size - 1) ? ',' : '\0', &value)) {
+        omote_log_w("parseIRcode: GC value %u of '%s' is not a number. IR code will not be used.\r\n", pos, payload.c_str());
+        delete [] buf;
+        return false;
+      }
+      buf[pos] = value;
+    }
+    irCode->timings = buf;
+    irCode->timingsLength = size;
+
+  } else if ((protocol == IR_PROTOCOL_PRONTO) || (protocol == IR_PROTOCOL_RAW)) {
+    // not a protocol, but an encoding
+    omote_log_w("parseIRcode: protocol %d (IR_PROTOCOL_PRONTO or IR_PROTOCOL_RAW) not yet implemented\r\n", protocol);
+    return false;
+
+  } else {
+    // generic implementation for all other protocols
+    // payload is expected either as 'data' or as 'data:nbits:repeat'
+    uint64_t nbits, repeat;
+    if (parseIRvalue(&current, '\0', &value)) {
+      // no nbits and repeat have been provided in the command. Try to get defaults.
+      if (!getProtocolDefaultBitsAndRepeat(protocol, &irCode->nbits, &irCode->repeat)) {
+        omote_log_w("parseIRcode: no defaults for nbits and repeat available for protocol %d. Payload is expected as 'data:nbits:repeat'. IR code will not be used.\r\n", protocol);
+        return false;
+      }
+    } else if (parseIRvalue(&current, ':', &value) && parseIRvalue(&current, ':', &nbits) && parseIRvalue(&current, '\0', &repeat)) {
+      irCode->nbits = nbits;
+      irCode->repeat = repeat;
+    } else {
+      omote_log_w("parseIRcode: payload '%s' is expected as 'data:nbits:repeat'. IR code will not be used.\r\n", payload.c_str());
+      return false;
+    }
+    irCode->data = value;
+  }
+
+  irCode->hasData = true;
+  return true;
+}
+
+void freeIRcode(IRcode *irCode) {
+  delete [] irCode->timings;
+  irCode->timings = NULL;
+  irCode->timingsLength = 0;
+}
@@ -1,7 +1,10 @@
+#pragma once
+
 // This list is copied from 'IRremoteESP8266/src/IRremoteESP8266.h' (except GC, which was added here)
 // We need to copy the list because in the simulator there is no access to the IRremoteESP8266 library.
 // Copying is not dangerous, because entries will never be removed or changed.
 #include <stdint.h>
+#include <string>
 
 /// Enumerator for defining and numbering of supported IR protocol.
 /// @note Always add to the end of the list and should never remove entries
@@ -436,3 +439,25 @@ const uint16_t kYorkBits = 136;
 const uint16_t kYorkStateLength = 17;
 
 std::string concatenateIRsendParams(std::string data, uint16_t nbits, uint16_t repeat);
+
+// An IR code, already parsed from its string representation into binary values.
+// IR commands are parsed only once when they are registered, so sending them later on needs no string handling at all.
+struct IRcode {
+  int16_t protocol;
+  // false if the command only defines the protocol, and the data is provided as additionalPayload when executing the command
+  bool hasData;
+  uint16_t nbits;
+  uint16_t repeat;
+  uint64_t data;
+  // only used by IR_PROTOCOL_GLOBALCACHE. Either allocated by parseIRcode() or pointing to a const table in flash.
+  uint16_t timingsLength;
+  const uint16_t *timings;
+};
+
+// Gets the default nbits and repeat of a protocol. Returns false if no defaults are known for this protocol.
+bool getProtocolDefaultBitsAndRepeat(int protocol, uint16_t *nbits, uint16_t *repeat);
+// Parses "data", "data:nbits:repeat" or, for IR_PROTOCOL_GLOBALCACHE, a comma separated list of values.
+// Returns false if the payload cannot be parsed. In that case nothing has to be freed.
+bool parseIRcode(int protocol, const std::string &payload, IRcode *irCode);
+// Frees the timings of a GC code. Only needed for IR codes which are not kept for the whole runtime.
+void freeIRcode(IRcode *irCode);
@@ -1,46 +1,43 @@
 #if defined(WIN32) || defined(__linux__) || defined(__APPLE__)
 
 #include "applicationInternal/hardware/arduinoLayer.h"
+#include "applicationInternal/hardware/hardwarePresenter.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <sys/time.h>
 
-long long current_timestamp() {
+long long current_timestamp_us() {
     struct timeval te; 
     gettimeofday(&te, NULL); // get current time
-    long long milliseconds = te.tv_sec*1000LL + te.tv_usec/1000; // calculate milliseconds
-    // printf("milliseconds: %lld\r\n", milliseconds);
-    return milliseconds;
+    return te.tv_sec*1000000LL + te.tv_usec;
 }
 
+// the clock is in the hardware layer, because it is shared with it (lvgl tick, keypad timestamps) and can be a virtual clock
 void delay(uint32_t ms) {
-  unsigned long startTimer = millis();
-  while ((millis() - startTimer) < ms) {
-  }
+  clock_delay(ms);
 }
 
-// we have to simulate millis()
-// the first call sets firstTimestampAtProgramstart and is the reference from that on
-bool millisAlreadyInitialized = false;
-long long firstTimestampAtProgramstart = 0;
 unsigned long millis() {
-  unsigned long res;
-  if (!millisAlreadyInitialized) {
-    firstTimestampAtProgramstart = current_timestamp();
-    millisAlreadyInitialized = true;
-    res = 0;
-  } else {
-    res = current_timestamp() - firstTimestampAtProgramstart;
+  return get_clockMillis();
+}
+
+// micros() is only used for measuring how long code runs, like lv_timer_handler(). So it always uses the real time, even if the virtual clock is active.
+bool microsAlreadyInitialized = false;
+long long firstTimestampAtProgramstart_us = 0;
+unsigned long micros() {
+  if (!microsAlreadyInitialized) {
+    firstTimestampAtProgramstart_us = current_timestamp_us();
+    microsAlreadyInitialized = true;
+    return 0;
   }
-  // printf("millis(): %lu\r\n", res);
-  return res;
+  return current_timestamp_us() - firstTimestampAtProgramstart_us;
 }
 
 SerialClass Serial;
 void SerialClass::begin(unsigned long) {
   // Serial.begin is one of the first methods called in main.cpp
   // So we use this to initialize the timer
-  unsigned long dummy = millis();
+  unsigned long dummy = micros();
 }
 
 size_t SerialClass::printf(const char * format, ...) {
@@ -14,6 +14,7 @@
   // Note: Of course there is a lot more Arduino code in folder "hardware/ESP32/*", but this code is only active in case of esp32, so we don't have to simulate this in the Arduino layer if Windows/Linux is active.
   void delay(uint32_t ms);
   unsigned long millis();
+  unsigned long micros();
   class SerialClass {
   public:
     void begin(unsigned long);
@@ -1,5 +1,7 @@
 #include <string>
 #include <list>
+#include <atomic>
+#include <memory>
 #include "applicationInternal/hardware/hardwarePresenter.h"
 // for registering the callback to show received IR messages
 #include "guis/gui_irReceiver.h"
@@ -7,6 +9,11 @@
 #include "../commandHandler.h"
 // for registering the callback to show WiFi status
 #include "applicationInternal/gui/guiBase.h"
+// for registering the callback before deep sleep
+#include "applicationInternal/wakeSnapshot.h"
+// with ENABLE_TASK_SPLIT=1, the callbacks of WiFi, mqtt and BLE go to the gui task first
+#include "applicationInternal/taskSplit.h"
+#include "applicationInternal/omote_log.h"
 
 // This include of "hardwareLayer.h" is the one and only link to folder "hardware". The file "hardwareLayer.h" does the differentiation between ESP32 and Windows/Linux.
 // "hardwareLayer.h" includes all the other hardware header files as well. So everything from all hardware header files is available here - and only here.
@@ -73,11 +80,22 @@ void init_battery(void) {
 void get_battery_status(int *battery_voltage, int *battery_percentage, bool *battery_ischarging) {
   get_battery_status_HAL(battery_voltage, battery_percentage, battery_ischarging);
 }
+float get_battery_chargeRate(void) {
+  return get_battery_chargeRate_HAL();
+}
 
 // --- sleep / IMU ------------------------------------------------------------
 void init_sleep() {
+  set_announceGoingToSleep_cb_HAL(&wakeSnapshot_save);
   init_sleep_HAL();
 };
+bool get_wakeupFromDeepSleep() {
+  return get_wakeupFromDeepSleep_HAL();
+}
+uint8_t *get_rtcMemory(size_t *size) {
+  *size = RTC_MEMORY_SIZE;
+  return get_rtcMemory_HAL();
+}
 void init_IMU() {
   init_IMU_HAL();
 };
@@ -87,6 +105,9 @@ void check_activity() {
 void setLastActivityTimestamp() {
   setLastActivityTimestamp_HAL();
 };
+uint32_t get_lastActivityTimestamp() {
+  return get_lastActivityTimestamp_HAL();
+}
 uint32_t get_sleepTimeout() {
   return get_sleepTimeout_HAL();
 }
@@ -105,15 +126,89 @@ uint8_t get_motionThreshold() {
 void set_motionThreshold(uint8_t aMotionThreshold) {
   set_motionThreshold_HAL(aMotionThreshold);
 }
+void idle(uint32_t timeTillNextDeadline_ms) {
+  idle_HAL(timeTillNextDeadline_ms);
+}
+void wake_idle(void) {
+  wakeIdle_HAL();
+}
+uint64_t get_idleSleepTime_us(void) {
+  return get_idleSleepTime_us_HAL();
+}
 
 // --- keypad -----------------------------------------------------------------
+// All keypad events announced by the hardware, in the order they were captured.
+// Single producer (the hardware, with ENABLE_TASK_SPLIT=1 in the input task), single consumer (keypad_loop()), like the command queue.
+keypadEvent keypadEventFIFO[KEYPAD_EVENT_FIFO_SIZE];
+std::atomic<uint32_t> keypadEventFIFO_head(0); // written by the producer
+std::atomic<uint32_t> keypadEventFIFO_tail(0); // written by the consumer, next event to read
+std::atomic<uint32_t> keypadEventFIFO_dropped(0); // written by the producer
+
+void announceKeypadEvent_cb(unsigned long timestamp, uint8_t row, uint8_t col, char keyChar, bool pressed) {
+  if ((row >= keypadROWS) || (col >= keypadCOLS)) {
+    omote_log_e("announceKeypadEvent_cb: invalid row %u, col %u for key '%c'\r\n", row, col, keyChar);
+    return;
+  }
+  uint32_t head = keypadEventFIFO_head.load(std::memory_order_relaxed);
+  if (head - keypadEventFIFO_tail.load(std::memory_order_acquire) >= KEYPAD_EVENT_FIFO_SIZE) {
+    omote_log_w("announceKeypadEvent_cb: keypad event FIFO full, event for key '%c' is lost\r\n", keyChar);
+    keypadEventFIFO_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  keypadEventFIFO[head % KEYPAD_EVENT_FIFO_SIZE] = keypadEvent{timestamp, row, col, keyChar, pressed ? PRESSED_RAW : RELEASED_RAW};
+  keypadEventFIFO_head.store(head + 1, std::memory_order_release);
+}
+static bool keypadEventFIFO_isEmpty() {
+  return keypadEventFIFO_head.load(std::memory_order_acquire) == keypadEventFIFO_tail.load(std::memory_order_relaxed);
+}
+
 void init_keys(void) {
+  set_announceKeypadEvent_cb_HAL(&announceKeypadEvent_cb);
   init_keys_HAL();  
 }
+bool getKeypadEvent(keypadEvent *event) {
+  #if (ENABLE_TASK_SPLIT != 1)
+  if (keypadEventFIFO_isEmpty()) {
+    // we need to provide currentMillis to the hardware, because at least in case of the simulator there is no way to access millis()
+    keys_getEvents_HAL(millis());
+  }
+  #endif
+  if (keypadEventFIFO_isEmpty()) {
+    return false;
+  }
+  uint32_t tail = keypadEventFIFO_tail.load(std::memory_order_relaxed);
+  *event = keypadEventFIFO[tail % KEYPAD_EVENT_FIFO_SIZE];
+  keypadEventFIFO_tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+#if (ENABLE_TASK_SPLIT == 1)
+bool keypad_pollHardware(void) {
+  uint32_t head = keypadEventFIFO_head.load(std::memory_order_relaxed);
+  keys_getEvents_HAL(millis());
+  return keypadEventFIFO_head.load(std::memory_order_relaxed) != head;
+}
+#endif
+bool keypadCanSignalEvents(void) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  return true;
+  #else
+  return keys_canSignalEvents_HAL();
+  #endif
+}
+bool keypadEventPending(void) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  // the hardware belongs to the input task
+  return !keypadEventFIFO_isEmpty();
+  #else
+  return !keypadEventFIFO_isEmpty() || keys_isEventPending_HAL();
+  #endif
+}
+uint32_t get_keypadEventsDropped(void) {
+  return keypadEventFIFO_dropped.load(std::memory_order_relaxed);
+}
 // Used in keypad_getRawKeys to save the raw key states.
 // Holds the raw keystates as received from the keypad (OMOTE_HARDWARE_REV <= 4), the TCA8418 (OMOTE_HARDWARE_REV >= 5) or the simulator.
 // We expect only IDLE_PRESSED and IDLE_RELEASED, because this is what all three sources can deliver (only the keypad could also deliver IDLE and HOLD)
-// The whole array is passed as a pointer to the hardware implementation, which fills it with the raw key states.
 rawKey rawKeys[][keypadCOLS] = {
   {{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW}},
   {{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW}},
@@ -121,10 +216,6 @@ rawKey rawKeys[][keypadCOLS] = {
   {{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW}},
   {{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW},{0, NO_KEY, IDLE_RAW}},
 };
-void getKeys(rawKey rawKeys[keypadROWS][keypadCOLS], unsigned long currentMillis) {
-  // we need to provide currentMillis to the hardware, because at least in case of the simulator there is no way to access millis()
-  keys_getKeys_HAL(rawKeys, currentMillis);
-}
 #if(OMOTE_HARDWARE_REV >= 5)
 void update_keyboardBrightness(void) {
   update_keyboardBrightness_HAL();
@@ -140,10 +231,64 @@ void set_keyboardBrightness(uint8_t aKeyboardBrightness){
 void init_infraredSender(void) {
   init_infraredSender_HAL();  
 }
-void sendIRcode(int protocol, std::list<std::string> commandPayloads, std::string additionalPayload) {
-  sendIRcode_HAL(protocol, commandPayloads, additionalPayload);
+void sendIRcode(const IRcode &irCode) {
+  if (irCode.protocol == IR_PROTOCOL_GLOBALCACHE) {
+    sendIRcodeGC_HAL(irCode.timings, irCode.timingsLength);
+  } else {
+    sendIRcode_HAL(irCode.protocol, irCode.data, irCode.nbits, irCode.repeat);
+  }
+}
+
+// --- command worker ---------------------------------------------------------
+void init_commandWorker(void) {
+  start_commandWorker_HAL(&executeQueuedCommands_cb, &commandQueue_hasCommands_cb);
+}
+void notify_commandWorker(void) {
+  notify_commandWorker_HAL();
+}
+
+// --- tasks, only with ENABLE_TASK_SPLIT=1 -----------------------------------
+#if (ENABLE_TASK_SPLIT == 1)
+uint8_t start_task(const char *name, tTaskLoop taskLoop, uint32_t stackSize, int8_t core, uint8_t priority) {
+  return tasks_start_HAL(name, taskLoop, stackSize, core, priority);
+}
+void wake_task(uint8_t taskId) {
+  tasks_wake_HAL(taskId);
+}
+uint8_t get_taskCount(void) {
+  return tasks_getCount_HAL();
+}
+taskStatistics get_taskStatistics(uint8_t taskId) {
+  taskStatistics_HAL statistics = tasks_getStatistics_HAL(taskId);
+  return taskStatistics{statistics.name, statistics.core, statistics.awakeTime_us, statistics.lifeTime_us, statistics.stackHighWaterMark};
 }
 
+// BLE and WiFi status, cached by the connectivity task
+static std::atomic<bool> cachedBLEisAdvertising(false);
+static std::atomic<bool> cachedBLEisConnected(false);
+static std::atomic<bool> cachedWifiIsConnected(false);
+void update_connectivityStatus(void) {
+  #if (ENABLE_KEYBOARD_BLE == 1)
+  cachedBLEisAdvertising = keyboardBLE_isAdvertising_HAL();
+  cachedBLEisConnected = keyboardBLE_isConnected_HAL();
+  #endif
+  #if (ENABLE_WIFI_AND_MQTT == 1)
+  cachedWifiIsConnected = getIsWifiConnected_HAL();
+  #endif
+}
+// enough for forceConnectionToAddress(), which connects to the peer if needed
+#define CONNECTIVITY_CALL_TIMEOUT_MS 5000
+// a call of the BLE or WiFi HAL. Only the connectivity task does it, all others queue it for the connectivity task.
+#define CONNECTIVITY_HAL_CALL(call) \
+  do { \
+    if (!taskSplit_runOnConnectivityTask([=]() {call;})) { \
+      omote_log_w("queue to connectivity is full, %s is dropped\r\n", #call); \
+    } \
+  } while (0)
+#else
+#define CONNECTIVITY_HAL_CALL(call) call
+#endif
+
 // --- IR receiver ------------------------------------------------------------
 void start_infraredReceiver(void) {
   start_infraredReceiver_HAL();
@@ -169,67 +314,111 @@ void set_irReceiverEnabled(bool aIrReceiverEnabled) {
 // --- BLE keyboard -----------------------------------------------------------
 #if (ENABLE_KEYBOARD_BLE == 1)
 void init_keyboardBLE() {
+  #if (ENABLE_TASK_SPLIT == 1)
+  set_announceBLEmessage_cb_HAL(&taskSplit_receiveBLEmessage_cb);
+  #else
   set_announceBLEmessage_cb_HAL(&receiveBLEmessage_cb);
+  #endif
   init_keyboardBLE_HAL();
 }
 // used by "device_keyboard_ble.cpp", "sleep.cpp"
 
 void keyboardBLE_startAdvertisingForAll() {
-  keyboardBLE_startAdvertisingForAll_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_startAdvertisingForAll_HAL());
 }
 void keyboardBLE_startAdvertisingWithWhitelist(std::string peersAllowed) {
-  keyboardBLE_startAdvertisingWithWhitelist_HAL(peersAllowed);
+  CONNECTIVITY_HAL_CALL(keyboardBLE_startAdvertisingWithWhitelist_HAL(peersAllowed));
 }
 void keyboardBLE_startAdvertisingDirected(std::string peerAddress, bool isRandomAddress) {
-  keyboardBLE_startAdvertisingDirected_HAL(peerAddress, isRandomAddress);
+  CONNECTIVITY_HAL_CALL(keyboardBLE_startAdvertisingDirected_HAL(peerAddress, isRandomAddress));
 }
 void keyboardBLE_stopAdvertising() {
-  keyboardBLE_stopAdvertising_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_stopAdvertising_HAL());
 }
 void keyboardBLE_printConnectedClients() {
-  keyboardBLE_printConnectedClients_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_printConnectedClients_HAL());
 }
 void keyboardBLE_disconnectAllClients() {
-  keyboardBLE_disconnectAllClients_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_disconnectAllClients_HAL());
 }
 void keyboardBLE_printBonds() {
-  keyboardBLE_printBonds_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_printBonds_HAL());
 }
 std::string keyboardBLE_getBonds() {
+  #if (ENABLE_TASK_SPLIT == 1)
+  // the result has to outlive this function, in case the call is done after the wait timed out
+  std::shared_ptr<std::string> bonds = std::make_shared<std::string>();
+  if (!taskSplit_runOnConnectivityTaskAndWait([bonds]() {*bonds = keyboardBLE_getBonds_HAL();}, CONNECTIVITY_CALL_TIMEOUT_MS)) {
+    return "";
+  }
+  return *bonds;
+  #else
   return keyboardBLE_getBonds_HAL();
+  #endif
 }
 void keyboardBLE_deleteBonds() {
-  keyboardBLE_deleteBonds_HAL();
-}
-bool keyboardBLE_forceConnectionToAddress(std::string peerAddress) {
+  CONNECTIVITY_HAL_CALL(keyboardBLE_deleteBonds_HAL());
+}
+bool keyboardBLE_forceConnectionToAddress(const std::string &peerAddress) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  std::shared_ptr<bool> connected = std::make_shared<bool>(false);
+  std::string address = peerAddress;
+  if (!taskSplit_runOnConnectivityTaskAndWait([connected, address]() {*connected = keyboardBLE_forceConnectionToAddress_HAL(address);}, CONNECTIVITY_CALL_TIMEOUT_MS)) {
+    return false;
+  }
+  return *connected;
+  #else
   return keyboardBLE_forceConnectionToAddress_HAL(peerAddress);
+  #endif
 }
 bool keyboardBLE_isAdvertising() {
+  #if (ENABLE_TASK_SPLIT == 1)
+  return cachedBLEisAdvertising;
+  #else
   return keyboardBLE_isAdvertising_HAL();
+  #endif
 }
 bool keyboardBLE_isConnected() {
+  #if (ENABLE_TASK_SPLIT == 1)
+  return cachedBLEisConnected;
+  #else
   return keyboardBLE_isConnected_HAL();
+  #endif
 }
 void keyboardBLE_shutdown() {
-  keyboardBLE_shutdown_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_shutdown_HAL());
 }
 void keyboardBLE_write(uint8_t c) {
-  keyboardBLE_write_HAL(c);
+  CONNECTIVITY_HAL_CALL(keyboardBLE_write_HAL(c));
 }
 void keyboardBLE_longpress(uint8_t c) {
-  keyboardBLE_longpress_HAL(c);
+  // with ENABLE_TASK_SPLIT=1 this holds the connectivity task, and with it the mqtt loop, for the 1 s of the longpress
+  CONNECTIVITY_HAL_CALL(keyboardBLE_longpress_HAL(c));
 }
 void keyboardBLE_home() {
-  keyboardBLE_home_HAL();
+  CONNECTIVITY_HAL_CALL(keyboardBLE_home_HAL());
 }
 void keyboardBLE_sendString(const std::string &s) {
-  keyboardBLE_sendString_HAL(s);
+  CONNECTIVITY_HAL_CALL(keyboardBLE_sendString_HAL(s));
 }
 void consumerControlBLE_write(const MediaKeyReport value) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  // MediaKeyReport is an array, the parameter only a pointer to it. The queued call needs a copy.
+  uint8_t value0 = value[0];
+  uint8_t value1 = value[1];
+  CONNECTIVITY_HAL_CALL(MediaKeyReport report; report[0] = value0; report[1] = value1; consumerControlBLE_write_HAL(report));
+  #else
   consumerControlBLE_write_HAL(value);
+  #endif
 }
 void consumerControlBLE_longpress(const MediaKeyReport value) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  uint8_t value0 = value[0];
+  uint8_t value1 = value[1];
+  CONNECTIVITY_HAL_CALL(MediaKeyReport report; report[0] = value0; report[1] = value1; consumerControlBLE_longpress_HAL(report));
+  #else
   consumerControlBLE_longpress_HAL(value);
+  #endif
 }
 #endif
 
@@ -244,30 +433,118 @@ void set_backlightBrightness(uint8_t aBacklightBrightness){
   set_backlightBrightness_HAL(aBacklightBrightness);
 }
 
+// --- clock, only in the simulator -------------------------------------------
+#if defined(WIN32) || defined(__linux__) || defined(__APPLE__)
+unsigned long get_clockMillis(void) {
+  return clock_millis_HAL();
+}
+void clock_delay(uint32_t ms) {
+  clock_delay_HAL(ms);
+}
+void clock_loop(void) {
+  clock_loop_HAL();
+}
+bool clock_isVirtual(void) {
+  return clock_isVirtual_HAL();
+}
+#endif
+
+// --- self tests, only in the headless simulator with ENABLE_SELFTESTS=1 -----
+#if (ENABLE_SELFTESTS == 1)
+void set_runSelfTest_cb(tRunSelfTest runSelfTest) {
+  set_runSelfTest_cb_HAL(runSelfTest);
+}
+void get_lastSentIRcode(sentIRcode *sent) {
+  int protocol;
+  uint16_t timings[SENT_IR_TIMINGS_MAX];
+  uint16_t timingsLength;
+  sent->count = get_lastSentIRcode_HAL(&protocol, &sent->data, &sent->nbits, &sent->repeat, timings, &timingsLength);
+  // the HAL does not know the protocol numbers, it marks GC codes with -1
+  sent->protocol = ((protocol == -1) && (sent->count > 0)) ? IR_PROTOCOL_GLOBALCACHE : protocol;
+  sent->timings.assign(timings, timings + timingsLength);
+  sent->firstSent_ms = get_firstSentIRcodeTime_HAL();
+}
+bool get_lastBacklightFade(backlightFade *fade) {
+  ledFadeCurve curve;
+  if (ledFade_getCurves_HAL(LEDFADE_CHANNEL_BACKLIGHT, &curve, 1) == 0) {
+    return false;
+  }
+  *fade = backlightFade{curve.start_ms, curve.fromDuty, curve.toDuty, curve.fadeTime_ms};
+  return true;
+}
+uint8_t get_backlightDutyAt(uint32_t time_ms) {
+  return ledFade_getDutyAt_HAL(LEDFADE_CHANNEL_BACKLIGHT, time_ms);
+}
+bool push_keypadEvent(char keyChar, bool pressed, unsigned long capturedAt) {
+  return keys_pushEvent_HAL(keyChar, pressed, capturedAt);
+}
+void set_touchPoint(int16_t x, int16_t y, bool pressed) {
+  set_touchPoint_HAL(x, y, pressed);
+}
+#if (ENABLE_WIFI_AND_MQTT == 1)
+uint32_t get_publishedMQTTMessageCount(void) {
+  return get_publishedMQTTMessageCount_HAL();
+}
+#endif
+#endif
+
 // --- lvgl -------------------------------------------------------------------
+lvglFrameTiming lastFrameTiming = {0, 0, 0, 0, 0};
+
+void announceFrameTiming_cb(uint32_t render_us, uint32_t flush_us, uint32_t pixels) {
+  lastFrameTiming.frameCount++;
+  lastFrameTiming.render_us = render_us;
+  lastFrameTiming.flush_us = flush_us;
+  lastFrameTiming.pixels = pixels;
+  lastFrameTiming.pixelsTotal += pixels;
+  omote_log_v("frame %lu: render %lu us, flush %lu us, %lu pixels\r\n", (unsigned long)lastFrameTiming.frameCount, (unsigned long)render_us, (unsigned long)flush_us, (unsigned long)pixels);
+}
+
 void init_lvgl_hardware() {
+  set_announceFrameTiming_cb_HAL(&announceFrameTiming_cb);
   init_lvgl_HAL();
 };
+lvglFrameTiming get_lastFrameTiming() {
+  return lastFrameTiming;
+}
 
 // --- WiFi / MQTT ------------------------------------------------------------
 #if (ENABLE_WIFI_AND_MQTT == 1)
 void init_mqtt(void) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  set_announceWiFiconnected_cb_HAL(&taskSplit_receiveWiFiConnected_cb);
+  set_announceSubscribedTopics_cb_HAL(taskSplit_receiveMQTTmessage_cb);
+  #else
   set_announceWiFiconnected_cb_HAL(&receiveWiFiConnected_cb);
   set_announceSubscribedTopics_cb_HAL(receiveMQTTmessage_cb);
+  #endif
   init_mqtt_HAL();
 }
 // used by "commandHandler.cpp", "sleep.cpp"
 bool getIsWifiConnected() {
+  #if (ENABLE_TASK_SPLIT == 1)
+  return cachedWifiIsConnected;
+  #else
   return getIsWifiConnected_HAL();
+  #endif
 }
 void mqtt_loop() {
   mqtt_loop_HAL();
 }
 bool publishMQTTMessage(const char *topic, const char *payload) {
+  #if (ENABLE_TASK_SPLIT == 1)
+  return taskSplit_publishMQTTMessage(topic, payload);
+  #else
+  return publishMQTTMessage_HAL(topic, payload);
+  #endif
+}
+#if (ENABLE_TASK_SPLIT == 1)
+bool publishMQTTMessage_now(const char *topic, const char *payload) {
   return publishMQTTMessage_HAL(topic, payload);
 }
+#endif
 void wifi_shutdown() {
-  wifi_shutdown_HAL();
+  CONNECTIVITY_HAL_CALL(wifi_shutdown_HAL());
 }
 #endif
 
@@ -275,3 +552,9 @@ void wifi_shutdown() {
 void get_heapUsage(unsigned long *heapSize, unsigned long *freeHeap, unsigned long *maxAllocHeap, unsigned long *minFreeHeap) {
   get_heapUsage_HAL(heapSize, freeHeap, maxAllocHeap, minFreeHeap);
 }
+void* malloc_largeBuffer(size_t size) {
+  return malloc_largeBuffer_HAL(size);
+}
+void free_largeBuffer(void* buffer) {
+  free_largeBuffer_HAL(buffer);
+}
@@ -2,6 +2,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 #include "applicationInternal/hardware/IRremoteProtocols.h"
 #include "applicationInternal/hardware/arduinoLayer.h"
 
@@ -27,23 +28,38 @@ void update_userled();
 // --- battery ----------------------------------------------------------------
 void init_battery(void);
 void get_battery_status(int *battery_voltage, int *battery_percentage, bool *battery_ischarging);
+// how fast the battery is charged (positive) or discharged (negative), in % per hour. NAN if there is no fuel gauge.
+float get_battery_chargeRate(void);
 
 // --- sleep / IMU ------------------------------------------------------------
 void init_sleep();
+// true after wakeup from deep sleep, false after reset or power on
+bool get_wakeupFromDeepSleep();
+// Memory that survives deep sleep, but not a reset. RTC slow memory of the ESP32.
+// The simulator never sleeps. It saves this memory when it ends and loads it on the next start, if the environment variable OMOTE_RTC_MEMORY_FILE is set.
+uint8_t *get_rtcMemory(size_t *size);
 void init_IMU();
 void check_activity();
 void setLastActivityTimestamp();
+// millis() of the last key press, touch or motion
+uint32_t get_lastActivityTimestamp();
 uint32_t get_sleepTimeout();
 void set_sleepTimeout(uint32_t aSleepTimeout);
 bool get_wakeupByIMUEnabled();
 void set_wakeupByIMUEnabled(bool aWakeupByIMUEnabled);
 uint8_t get_motionThreshold();
 void set_motionThreshold(uint8_t aMotionThreshold);
+// used by main.cpp, after every loop(). Sleeps until the next task of the scheduler is due or an input wakes up.
+// ESP32: light sleep, if possible (ENABLE_LIGHT_SLEEP=1), otherwise the loopTask blocks. Simulator: the host sleeps.
+void idle(uint32_t timeTillNextDeadline_ms);
+// ends idle() early, e.g. when the command worker hands over a command to the main loop. Can be called from any task.
+void wake_idle(void);
+// total time spent sleeping in idle()
+uint64_t get_idleSleepTime_us(void);
 
 // --- keypad -----------------------------------------------------------------
 void init_keys(void);
 const char NO_KEY = '\0';
-// -- has to be exactly the same structure as in the hardware implementations, because only a pointer is passed
 const uint8_t keypadROWS = 5; //five rows
 const uint8_t keypadCOLS = 5; //five columns
 enum keypad_rawKeyStates {IDLE_RAW, PRESSED_RAW,       RELEASED_RAW};
@@ -52,9 +68,32 @@ struct rawKey {
   char keyChar;
   keypad_rawKeyStates rawKeyState;
 };
-// --
 extern rawKey rawKeys[][keypadCOLS];
-void getKeys(rawKey (*rawKeys)[keypadCOLS], unsigned long currentMillis);
+// A single press or release of a key, as received from the keypad (OMOTE_HARDWARE_REV <= 4), the TCA8418 (OMOTE_HARDWARE_REV >= 5) or the simulator.
+// timestamp is the time the event was captured by the hardware, not the time it is processed.
+// The TCA8418 only signals its first event with an interrupt. Events captured after it, but read in the same go, have the time they were read.
+struct keypadEvent {
+  unsigned long timestamp;
+  uint8_t row;
+  uint8_t col;
+  char keyChar;
+  keypad_rawKeyStates rawKeyState;
+};
+// Capacity of the FIFO of keypad events. The TCA8418 delivers up to 10 events at once, so this has to be at least that large.
+#define KEYPAD_EVENT_FIFO_SIZE 16
+// Returns the oldest keypad event not yet processed. Only asks the hardware for new events if there is none left in the FIFO.
+// With ENABLE_TASK_SPLIT=1 the hardware is only asked by the input task, with keypad_pollHardware().
+bool getKeypadEvent(keypadEvent *event);
+#if (ENABLE_TASK_SPLIT == 1)
+// used by the input task. Puts all new events of the hardware into the FIFO, returns true if there were any.
+bool keypad_pollHardware(void);
+#endif
+// true if the hardware tells when there are new events (TCA8418, simulator). Otherwise the keypad has to be polled. Always true with ENABLE_TASK_SPLIT=1, the input task tells.
+bool keypadCanSignalEvents(void);
+// true if getKeypadEvent() would return an event
+bool keypadEventPending(void);
+// number of keypad events lost so far because the FIFO was full
+uint32_t get_keypadEventsDropped(void);
 #if(OMOTE_HARDWARE_REV >= 5)
 void update_keyboardBrightness(void);
 uint8_t get_keyboardBrightness();
@@ -68,7 +107,36 @@ void init_SD_card(void);
 
 // --- IR sender --------------------------------------------------------------
 void init_infraredSender(void);
-void sendIRcode(int protocol, std::list<std::string> commandPayloads, std::string additionalPayload);
+void sendIRcode(const IRcode &irCode);
+
+// --- command worker ---------------------------------------------------------
+void init_commandWorker(void);
+void notify_commandWorker(void);
+
+// --- tasks, only with ENABLE_TASK_SPLIT=1 -----------------------------------
+#if (ENABLE_TASK_SPLIT == 1)
+// loop() is always task 0
+#define TASK_NO_CORE -1
+// returns the ms until the task has to run again
+typedef uint32_t (*tTaskLoop)(void);
+// the task calls taskLoop again and again. Simulator: core and priority are ignored. Returns the id of the task.
+uint8_t start_task(const char *name, tTaskLoop taskLoop, uint32_t stackSize, int8_t core, uint8_t priority);
+// lets the task run as soon as possible. Can be called from any task.
+void wake_task(uint8_t taskId);
+struct taskStatistics {
+  const char *name;
+  int8_t core;
+  // time the task was not sleeping, since it was started
+  uint64_t awakeTime_us;
+  uint64_t lifeTime_us;
+  // bytes of the stack that were never used. Always 0 in the simulator.
+  uint32_t stackHighWaterMark;
+};
+uint8_t get_taskCount(void);
+taskStatistics get_taskStatistics(uint8_t taskId);
+// Only the connectivity task calls the HAL of BLE and WiFi. It caches their status with this, the other tasks get the cached status.
+void update_connectivityStatus(void);
+#endif
 
 // --- IR receiver ------------------------------------------------------------
 void start_infraredReceiver(void);
@@ -81,6 +149,8 @@ void set_irReceiverEnabled(bool aIrReceiverEnabled);
 #if (ENABLE_KEYBOARD_BLE == 1)
 void init_keyboardBLE();
 // used by "device_keyboard_ble.cpp", "sleep.cpp"
+// With ENABLE_TASK_SPLIT=1 the calls are only queued for the connectivity task. keyboardBLE_getBonds() and keyboardBLE_forceConnectionToAddress() wait for
+// their result, isAdvertising() and isConnected() return the status cached by the connectivity task.
 typedef uint8_t MediaKeyReport[2];
 const uint8_t BLE_KEY_UP_ARROW = 0xDA;
 const uint8_t BLE_KEY_DOWN_ARROW = 0xD9;
@@ -106,7 +176,7 @@ void keyboardBLE_disconnectAllClients();
 void keyboardBLE_printBonds();
 std::string keyboardBLE_getBonds();
 void keyboardBLE_deleteBonds();
-bool keyboardBLE_forceConnectionToAddress(std::string peerAddress);
+bool keyboardBLE_forceConnectionToAddress(const std::string &peerAddress);
 bool keyboardBLE_isAdvertising();
 bool keyboardBLE_isConnected();
 void keyboardBLE_shutdown();
@@ -123,18 +193,88 @@ void update_backlightBrightness(void);
 uint8_t get_backlightBrightness();
 void set_backlightBrightness(uint8_t aBacklightBrightness);
 
+// --- clock, only in the simulator -------------------------------------------
+#if defined(WIN32) || defined(__linux__) || defined(__APPLE__)
+// used by arduinoLayer.cpp for millis() and delay()
+unsigned long get_clockMillis(void);
+void clock_delay(uint32_t ms);
+// used by main.cpp, once per loop()
+void clock_loop(void);
+// true with SIMULATOR_VIRTUAL_CLOCK=1: millis() only advances with loop() and delay(), not with the time the host needs
+bool clock_isVirtual(void);
+#endif
+
+// --- self tests, only in the headless simulator with ENABLE_SELFTESTS=1 -----
+#if (ENABLE_SELFTESTS == 1)
+// called by the script command "selftest". Returns the number of failed checks, -1 if there is no test with this name.
+typedef int (*tRunSelfTest)(const char *name);
+void set_runSelfTest_cb(tRunSelfTest runSelfTest);
+// The simulator does not send IR codes, but records the last one. count is the number of IR codes sent so far.
+struct sentIRcode {
+  uint32_t count;
+  int16_t protocol;
+  uint64_t data;
+  uint16_t nbits;
+  uint16_t repeat;
+  // only for IR_PROTOCOL_GLOBALCACHE
+  std::vector<uint16_t> timings;
+  // millis() when the first IR code was sent, UINT32_MAX if none was sent yet
+  uint32_t firstSent_ms;
+};
+void get_lastSentIRcode(sentIRcode *sent);
+// The simulator does not dim its window, but records every fade of the backlight as a linear curve, like the LEDC hardware of the ESP32 fades.
+struct backlightFade {
+  uint32_t start_ms;
+  uint8_t fromDuty;
+  uint8_t toDuty;
+  uint32_t fadeTime_ms;
+};
+// the last fade of the backlight. Returns false if there was none yet.
+bool get_lastBacklightFade(backlightFade *fade);
+// the duty the backlight had at time_ms (millis()), calculated from the recorded fades
+uint8_t get_backlightDutyAt(uint32_t time_ms);
+// A key event as if the keypad window had been clicked at capturedAt (millis()). It is read from the hardware like any other keypad event.
+// Returns false if there is no such key.
+bool push_keypadEvent(char keyChar, bool pressed, unsigned long capturedAt);
+// Touches the screen at x,y, or lifts the finger. lvgl gets it with its next read of the touch input, like a touch from the script.
+void set_touchPoint(int16_t x, int16_t y, bool pressed);
+#if (ENABLE_WIFI_AND_MQTT == 1)
+// The simulator does not contact the MQTT broker in the self tests, but counts the published messages
+uint32_t get_publishedMQTTMessageCount(void);
+#endif
+#endif
+
 // --- lvgl -------------------------------------------------------------------
 void init_lvgl_hardware();
+// Timing of the last frame refreshed by lvgl. render_us: time lvgl was rendering, flush_us: time lvgl was sending to or waiting for the display.
+// With DMA (ESP32), flushing a band overlaps with rendering the next one, so only the time lvgl had to wait for the display is counted.
+struct lvglFrameTiming {
+  uint32_t frameCount;
+  uint32_t render_us;
+  uint32_t flush_us;
+  uint32_t pixels;
+  // sum of the pixels of all frames. Overflows, so only use the difference of two values.
+  uint32_t pixelsTotal;
+};
+lvglFrameTiming get_lastFrameTiming();
 
 // --- WiFi / MQTT ------------------------------------------------------------
 #if (ENABLE_WIFI_AND_MQTT == 1)
 void init_mqtt(void);
-// used by "commandHandler.cpp", "sleep.cpp"
+// used by "commandHandler.cpp", "sleep.cpp". With ENABLE_TASK_SPLIT=1 the status cached by the connectivity task.
 bool getIsWifiConnected();
 void mqtt_loop();
+// With ENABLE_TASK_SPLIT=1 the message is only queued for the connectivity task
 bool publishMQTTMessage(const char *topic, const char *payload);
+#if (ENABLE_TASK_SPLIT == 1)
+// used by the connectivity task
+bool publishMQTTMessage_now(const char *topic, const char *payload);
+#endif
 void wifi_shutdown();
 #endif
 
 // --- memory usage -----------------------------------------------------------
 void get_heapUsage(unsigned long *heapSize, unsigned long *freeHeap, unsigned long *maxAllocHeap, unsigned long *minFreeHeap);
+// for buffers too large for the internal heap. Uses PSRAM if available.
+void* malloc_largeBuffer(size_t size);
+void free_largeBuffer(void* buffer);
@@ -3,6 +3,8 @@
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "applicationInternal/scenes/sceneRegistry.h"
 #include "applicationInternal/commandHandler.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/keys.h"
 #include "applicationInternal/omote_log.h"
 
 enum keypad_keyStates    {IDLE, PRESSED, HOLD, RELEASED};
@@ -70,7 +72,7 @@ void doShortPress(char keyChar, int keyCode){
   
   lastTimeSent[row][col] = currentMillis;
 
-  uint16_t command = get_command_short(gui_memoryOptimizer_getActiveSceneName(), keyChar);
+  uint16_t command = get_keyBinding(keyChar).command_short;
   if (command == COMMAND_UNKNOWN) {
     omote_log_w("key: key '%c', but no command defined\r\n", keyChar);
     return;
@@ -81,7 +83,7 @@ void doShortPress(char keyChar, int keyCode){
 }
 
 void doLongPress(char keyChar, int keyCode){
-  uint16_t command = get_command_long(gui_memoryOptimizer_getActiveSceneName(), keyChar);
+  uint16_t command = get_keyBinding(keyChar).command_long;
   if (command != COMMAND_UNKNOWN) {
     omote_log_d("key: key '%c' (long press), will use command '%u'\r\n", keyChar, command);
     executeCommand(command);
@@ -104,11 +106,13 @@ void keypad_resetReleasedKeys() {
   }
 }
 
-// get raw keys from the keypad (OMOTE_HARDWARE_REV <= 4), the TCA8418 (OMOTE_HARDWARE_REV >= 5) or the simulator.
-void keypad_getRawKeys() {
-  // we need to provide currentMillis to the hardware, because at least in case of the simulator there is no way to access millis()
-  unsigned long currentMillis = millis();
-  getKeys(rawKeys, currentMillis);
+// apply a single event from the keypad (OMOTE_HARDWARE_REV <= 4), the TCA8418 (OMOTE_HARDWARE_REV >= 5) or the simulator to the raw keys.
+// Only one event per loop is applied, otherwise a press and release of the same key would overwrite each other before being processed.
+void keypad_getRawKeys(const keypadEvent &event) {
+  // use the time the event was captured, so that HOLD is computed from the real time the key was pressed
+  rawKeys[event.row][event.col].timestampReceived = event.timestamp;
+  rawKeys[event.row][event.col].keyChar = event.keyChar;
+  rawKeys[event.row][event.col].rawKeyState = event.rawKeyState;
 }
 
 // Now we have the latest rawKeyState[][] for all 25 keys and know when they have been sent
@@ -130,7 +134,11 @@ void keypad_setKeyStatesAndCheckForHold() {
   }
 }
 
+// true if all keys are IDLE and have been processed as IDLE. Then there is nothing to do until the next keypad event.
+bool keypadIsIdle = true;
+
 void keypad_processKeyStates() {
+  keypadIsIdle = true;
   // iterate over all keys and process them
   for(uint8_t row=0; row < keypadROWS; row++) {
     for(uint8_t col=0; col < keypadCOLS; col++) {
@@ -138,15 +146,18 @@ void keypad_processKeyStates() {
       keypad_keyStates singleKeyState = keyState[row][col];
       char keyChar = rawKeys[row][col].keyChar;
       int keyCode = row * keypadCOLS + col;
+      if (singleKeyState != IDLE) {
+        keypadIsIdle = false;
+      }
 
       if (singleKeyState == PRESSED) {
         omote_log_v("pressed\r\n");
 
-        if ((get_key_repeatMode(gui_memoryOptimizer_getActiveSceneName(), keyChar) == SHORT) && (keyStateProcessed[row][col].keyState != PRESSED)) {
+        if ((get_keyBinding(keyChar).repeatMode == SHORT) && (keyStateProcessed[row][col].keyState != PRESSED)) {
           omote_log_v("key: PRESSED of SHORT key %c (%d)\r\n", keyChar, keyCode);
           doShortPress(keyChar, keyCode);
 
-        } else if ((get_key_repeatMode(gui_memoryOptimizer_getActiveSceneName(), keyChar) == SHORT_REPEATED) && (keyStateProcessed[row][col].keyState != PRESSED)) { // here do not repeat it too early, do the repeat only in HOLD
+        } else if ((get_keyBinding(keyChar).repeatMode == SHORT_REPEATED) && (keyStateProcessed[row][col].keyState != PRESSED)) { // here do not repeat it too early, do the repeat only in HOLD
           omote_log_v("key: PRESSED of SHORT_REPEATED key %c (%d)\r\n", keyChar, keyCode);
           doShortPress(keyChar, keyCode);
 
@@ -156,13 +167,13 @@ void keypad_processKeyStates() {
       } else if (singleKeyState == HOLD) {
         omote_log_v("hold\r\n");
 
-        if ((get_key_repeatMode(gui_memoryOptimizer_getActiveSceneName(), keyChar) == SHORTorLONG) && (keyStateProcessed[row][col].keyState != HOLD)) {
+        if ((get_keyBinding(keyChar).repeatMode == SHORTorLONG) && (keyStateProcessed[row][col].keyState != HOLD)) {
           omote_log_v("key: HOLD of SHORTorLONG key %c (%d)\r\n", keyChar, keyCode);
           omote_log_v("will set keyIsHold to TRUE for keycode %d\r\n", keyCode);
           keyStateProcessed[row][col].keyIsHold = true;
           doLongPress(keyChar, keyCode);
 
-        } else if (get_key_repeatMode(gui_memoryOptimizer_getActiveSceneName(), keyChar) == SHORT_REPEATED) { // this is the only case where we do not check the keyStateProcessed, because here it is intended to repeat the action
+        } else if (get_keyBinding(keyChar).repeatMode == SHORT_REPEATED) { // this is the only case where we do not check the keyStateProcessed, because here it is intended to repeat the action
           omote_log_v("key: HOLD of SHORT_REPEATED key %c (%d)\r\n", keyChar, keyCode);
           doShortPress(keyChar, keyCode);
 
@@ -171,7 +182,7 @@ void keypad_processKeyStates() {
 
       } else if (singleKeyState == RELEASED) {
         omote_log_v("released\r\n");
-        if ((get_key_repeatMode(gui_memoryOptimizer_getActiveSceneName(), keyChar) == SHORTorLONG) && !keyStateProcessed[row][col].keyIsHold && (keyStateProcessed[row][col].keyState != RELEASED)) {
+        if ((get_keyBinding(keyChar).repeatMode == SHORTorLONG) && !keyStateProcessed[row][col].keyIsHold && (keyStateProcessed[row][col].keyState != RELEASED)) {
           omote_log_v("value of keyIsHold for keycode %d is %d\r\n", keyCode, keyStateProcessed[row][col].keyIsHold);
           omote_log_v("key: RELEASED of SHORTorLONG key %c (%d)\r\n", keyChar, keyCode);
           doShortPress(keyChar, keyCode);
@@ -193,9 +204,31 @@ void keypad_processKeyStates() {
   }
 }
 
+unsigned long keypadLastPoll = 0;
+
 void keypad_loop(void) {
+  keypadLastPoll = millis();
+  keypadEvent event;
+  bool hasEvent = getKeypadEvent(&event);
+  if (!hasEvent && keypadIsIdle) {
+    // no key is pressed or has to be processed
+    return;
+  }
+
   keypad_resetReleasedKeys();
-  keypad_getRawKeys();
+  if (hasEvent) {
+    keypad_getRawKeys(event);
+  }
   keypad_setKeyStatesAndCheckForHold();
   keypad_processKeyStates();
 }
+
+uint32_t keypad_timeTillNextPoll(void) {
+  // While all keys are idle, a keypad that signals new events needs no polling. This lets the loop sleep.
+  if (keypadIsIdle && keypadCanSignalEvents()) {
+    return keypadEventPending() ? 0 : SCHEDULER_NO_DEADLINE;
+  }
+  // pressed keys are checked for HOLD and repeated
+  unsigned long elapsed = millis() - keypadLastPoll;
+  return (elapsed >= KEYPAD_POLL_PERIOD_MS) ? 0 : KEYPAD_POLL_PERIOD_MS - elapsed;
+}
@@ -22,4 +22,8 @@ typedef std::map<char, repeatModes> *key_repeatModes;
 typedef std::map<char, uint16_t> *key_commands_short;
 typedef std::map<char, uint16_t> *key_commands_long;
 
+// how often keypad_loop() runs while a key is pressed, or always if the keypad has to be polled (OMOTE_HARDWARE_REV <= 4)
+#define KEYPAD_POLL_PERIOD_MS 10
 void keypad_loop(void);
+// used by the scheduler: ms until keypad_loop() has to run again
+uint32_t keypad_timeTillNextPoll(void);
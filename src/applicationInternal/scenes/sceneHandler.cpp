@@ -3,6 +3,7 @@
 #include "applicationInternal/gui/guiBase.h"
 #include "applicationInternal/gui/guiMemoryOptimizer.h"
 #include "applicationInternal/scenes/sceneRegistry.h"
+#include "applicationInternal/scenes/sceneSequencer.h"
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "applicationInternal/commandHandler.h"
 #include "applicationInternal/omote_log.h"
@@ -15,7 +16,7 @@ void setLabelActiveScene() {
   }
 }
 
-void showSpecificGUI(GUIlists GUIlist, std::string GUIname);
+void showSpecificGUI(GUIlists GUIlist, const std::string &GUIname);
 
 static unsigned long last_gui_navigation_time = 0;
 const unsigned long GUI_NAVIGATION_DEBOUNCE_MS = 100;
@@ -30,10 +31,10 @@ bool isGuiNavigationDebounced() {
   return false;
 }
 
-void handleScene(uint16_t command, commandData commandData, std::string additionalPayload = "") {
+void handleScene(uint16_t command, const commandData &commandData, const std::string &additionalPayload) {
 
   auto current = commandData.commandPayloads.begin();
-  std::string scene_name = *current;
+  const std::string &scene_name = *current;
 
   // --- do not switch scene, but show scene selection gui. From that on, we are in the main_gui_list. ----------------
   if (scene_name == scene_name_selection) {
@@ -89,11 +90,8 @@ void handleScene(uint16_t command, commandData commandData, std::string addition
   // e.g. executeCommand(activate_scene_command, "FORCE");
 
   // we can have a second payload
-  std::string isForcePayload = "";
   ++current;
-  if (current != commandData.commandPayloads.end()) {
-    isForcePayload = *current;
-  }
+  bool isForced = (additionalPayload == "FORCE") || ((current != commandData.commandPayloads.end()) && (*current == "FORCE"));
 
   // check if we know the new scene
   if (!sceneExists(scene_name)) {
@@ -105,10 +103,10 @@ void handleScene(uint16_t command, commandData commandData, std::string addition
 
   // do not activate the same scene again, only when forced to do so (e.g. by long press on the gui or when selected by hardware key)
   bool callEndAndStartSequences;
-  if ((scene_name == gui_memoryOptimizer_getActiveSceneName()) && ((isForcePayload != "FORCE") && (additionalPayload != "FORCE"))) {
+  if ((scene_name == gui_memoryOptimizer_getActiveSceneName()) && !isForced) {
     omote_log_d("scene: will not start scene again, because it is already active\r\n");
     callEndAndStartSequences = false;
-  } else if ((scene_name == gui_memoryOptimizer_getActiveSceneName()) && ((isForcePayload == "FORCE") || (additionalPayload == "FORCE"))) {
+  } else if ((scene_name == gui_memoryOptimizer_getActiveSceneName()) && isForced) {
     omote_log_d("scene: scene is already active, but FORCE was set, so start scene again\r\n");
     callEndAndStartSequences = true;
   } else {
@@ -116,10 +114,19 @@ void handleScene(uint16_t command, commandData commandData, std::string addition
     callEndAndStartSequences = true;
   }
 
+  // Pressing the key of the active scene again normally brings back the first gui of the scene. If that one is already shown, there is nothing to do.
+  if (!callEndAndStartSequences && gui_memoryOptimizer_isGUIshown(SCENE_GUI_LIST, 0)) {
+    omote_log_d("scene: first gui of the scene is already shown, nothing to do\r\n");
+    return;
+  }
+
   if (SceneLabel != NULL) {lv_label_set_text(SceneLabel, "changing...");}
   gui_loop();
 
   if (callEndAndStartSequences) {
+    // If the sequence of the previous scene switch is still running, the user changed their mind. Don't execute the rest of it.
+    sceneSequencer_cancel();
+
     // end old scene
     if (!sceneExists(gui_memoryOptimizer_getActiveSceneName()) && (gui_memoryOptimizer_getActiveSceneName() != "")) {
       omote_log_w("scene: WARNING: cannot end scene %s, because it is unknown\r\n", gui_memoryOptimizer_getActiveSceneName().c_str());
@@ -146,7 +153,7 @@ void handleScene(uint16_t command, commandData commandData, std::string addition
   guis_doTabCreationAfterGUIlistChanged(SCENE_GUI_LIST);
 }
 
-void showSpecificGUI(GUIlists GUIlist, std::string GUIname) {
+void showSpecificGUI(GUIlists GUIlist, const std::string &GUIname) {
   gui_list gui_list_for_search = get_gui_list_withFallback(GUIlist);
 
   // 1. search for gui in the gui list
@@ -161,6 +168,11 @@ void showSpecificGUI(GUIlists GUIlist, std::string GUIname) {
   
   // 2. call guiBase.cpp
   if ((gui_list_index >= 0) && (gui_list_index < gui_list_for_search->size())) {
+    if (gui_memoryOptimizer_isGUIshown(GUIlist, gui_list_index)) {
+      // the tabs would only be recreated as they are
+      omote_log_d("showSpecificGUI: GUI is already shown\r\n");
+      return;
+    }
     guis_doTabCreationForSpecificGUI(GUIlist, gui_list_index);
 
   } else {
@@ -170,13 +182,13 @@ void showSpecificGUI(GUIlists GUIlist, std::string GUIname) {
   }  
 }
 
-void handleGUI(uint16_t command, commandData commandData, std::string additionalPayload = "") {
+void handleGUI(uint16_t command, const commandData &commandData, const std::string &additionalPayload) {
 
   auto current = commandData.commandPayloads.begin();
   GUIlists GUIlist = (GUIlists)std::stoi(*current);
 
   current = std::next(current, 1);
-  std::string GUIname = *current;
+  const std::string &GUIname = *current;
 
   showSpecificGUI(GUIlist, GUIname);
 
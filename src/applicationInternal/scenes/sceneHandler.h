@@ -4,5 +4,5 @@
 #include "applicationInternal/commandHandler.h"
 
 void setLabelActiveScene();
-void handleScene(uint16_t command, commandData commandData, std::string additionalPayload = "");
-void handleGUI  (uint16_t command, commandData commandData, std::string additionalPayload = "");
+void handleScene(uint16_t command, const commandData &commandData, const std::string &additionalPayload = "");
+void handleGUI  (uint16_t command, const commandData &commandData, const std::string &additionalPayload = "");
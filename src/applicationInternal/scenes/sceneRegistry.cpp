@@ -66,7 +66,7 @@ void scene_end_sequence_from_registry(std::string sceneName) {
   }
 }
 
-repeatModes get_key_repeatMode(std::string sceneName, char keyChar) {
+repeatModes get_key_repeatMode(const std::string &sceneName, char keyChar) {
   try {
     // look if the map of the active gui has a definition for it
     std::string GUIname = gui_memoryOptimizer_getActiveGUIname();
@@ -96,7 +96,7 @@ repeatModes get_key_repeatMode(std::string sceneName, char keyChar) {
   }
 }
 
-uint16_t get_command_short(std::string sceneName, char keyChar) {
+uint16_t get_command_short(const std::string &sceneName, char keyChar) {
   try {
     // look if the map of the active gui has a definition for it
     std::string GUIname = gui_memoryOptimizer_getActiveGUIname();
@@ -127,7 +127,7 @@ uint16_t get_command_short(std::string sceneName, char keyChar) {
 
 }
 
-uint16_t get_command_long(std::string sceneName, char keyChar) {
+uint16_t get_command_long(const std::string &sceneName, char keyChar) {
   try {
     // look if the map of the active gui has a definition for it
     std::string GUIname = gui_memoryOptimizer_getActiveGUIname();
@@ -265,3 +265,49 @@ char KEY_RED    = '1';
 char KEY_GREEN  = '2';
 char KEY_YELLO  = '3';
 char KEY_BLUE   = '4';
+
+// --- resolved key bindings ----------------------------------------------------------------------------------------
+// get_key_repeatMode(), get_command_short() and get_command_long() search up to three maps (gui, scene, default) by name.
+// Instead of doing this on every key event, the result for all keys is resolved once after the active scene or gui changed.
+char *allKeys[] = {&KEY_OFF, &KEY_STOP, &KEY_REWI, &KEY_PLAY, &KEY_FORW, &KEY_CONF, &KEY_INFO, &KEY_UP, &KEY_DOWN, &KEY_LEFT, &KEY_RIGHT, &KEY_OK,
+                   &KEY_BACK, &KEY_SRC, &KEY_VOLUP, &KEY_VOLDO, &KEY_MUTE, &KEY_REC, &KEY_CHUP, &KEY_CHDOW, &KEY_RED, &KEY_GREEN, &KEY_YELLO, &KEY_BLUE};
+const uint8_t keyCount = sizeof(allKeys) / sizeof(allKeys[0]);
+// one entry per key, plus one entry for unknown keys at the end
+keyBinding resolvedKeyBindings[keyCount + 1];
+// maps a keyChar to its entry in resolvedKeyBindings
+uint8_t resolvedKeyBindingIndex[128];
+bool resolvedKeyBindingsValid = false;
+
+void invalidate_keyBindings() {
+  resolvedKeyBindingsValid = false;
+}
+
+void resolve_keyBindings() {
+  unsigned long startTime = millis();
+  std::string sceneName = gui_memoryOptimizer_getActiveSceneName();
+
+  for (uint8_t i = 0; i < sizeof(resolvedKeyBindingIndex); i++) {
+    resolvedKeyBindingIndex[i] = keyCount;
+  }
+  resolvedKeyBindings[keyCount] = keyBinding{REPEAT_MODE_UNKNOWN, COMMAND_UNKNOWN, COMMAND_UNKNOWN};
+
+  for (uint8_t i = 0; i < keyCount; i++) {
+    char keyChar = *allKeys[i];
+    resolvedKeyBindingIndex[keyChar & 0x7F] = i;
+    resolvedKeyBindings[i] = keyBinding{
+      get_key_repeatMode(sceneName, keyChar),
+      get_command_short(sceneName, keyChar),
+      get_command_long(sceneName, keyChar)
+    };
+  }
+
+  resolvedKeyBindingsValid = true;
+  omote_log_d("resolve_keyBindings: resolved keys for scene \"%s\" and gui \"%s\" in %lu ms\r\n", sceneName.c_str(), gui_memoryOptimizer_getActiveGUIname().c_str(), millis() - startTime);
+}
+
+const keyBinding &get_keyBinding(char keyChar) {
+  if (!resolvedKeyBindingsValid) {
+    resolve_keyBindings();
+  }
+  return resolvedKeyBindings[resolvedKeyBindingIndex[keyChar & 0x7F]];
+}
@@ -42,9 +42,18 @@ void register_scene(
 bool sceneExists(std::string sceneName);
 void scene_start_sequence_from_registry(std::string sceneName);
 void scene_end_sequence_from_registry(std::string sceneName);
-repeatModes get_key_repeatMode(std::string sceneName, char keyChar);
-uint16_t get_command_short(std::string sceneName, char keyChar);
-uint16_t get_command_long(std::string sceneName, char keyChar);
+repeatModes get_key_repeatMode(const std::string &sceneName, char keyChar);
+uint16_t get_command_short(const std::string &sceneName, char keyChar);
+uint16_t get_command_long(const std::string &sceneName, char keyChar);
+// The key bindings of the active scene and gui, resolved for all keys. Used on every key event, so it is only an array access.
+// Resolved again on the next access after invalidate_keyBindings(), which has to be called whenever the active scene or gui changes, or keys are set again.
+struct keyBinding {
+  repeatModes repeatMode;
+  uint16_t command_short;
+  uint16_t command_long;
+};
+const keyBinding &get_keyBinding(char keyChar);
+void invalidate_keyBindings();
 gui_list get_gui_list_withFallback(GUIlists gui_list);
 gui_list get_gui_list_active_withFallback();
 bool get_scene_has_gui_list(std::string sceneName);
@@ -76,3 +85,6 @@ extern char KEY_RED  ;
 extern char KEY_GREEN;
 extern char KEY_YELLO;
 extern char KEY_BLUE ;
+// all of the keys above
+extern char *allKeys[];
+extern const uint8_t keyCount;
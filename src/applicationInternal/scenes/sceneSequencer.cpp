@@ -0,0 +1,53 @@
+#include <vector>
+#include "applicationInternal/scenes/sceneSequencer.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/omote_log.h"
+
+std::vector<sceneSequenceStep> sceneSequence;
+size_t sceneSequence_nextStep = 0;
+unsigned long sceneSequence_lastStepTime = 0;
+unsigned long sceneSequence_waitBeforeNextStep = 0;
+
+bool sceneSequencer_isRunning() {
+  return sceneSequence_nextStep < sceneSequence.size();
+}
+
+void sceneSequencer_add(std::initializer_list<sceneSequenceStep> steps) {
+  if (!sceneSequencer_isRunning()) {
+    // start a new sequence. The first step is due as soon as the wait after the last step of the previous sequence is over.
+    sceneSequence.clear();
+    sceneSequence_nextStep = 0;
+  }
+  sceneSequence.insert(sceneSequence.end(), steps);
+}
+
+void sceneSequencer_cancel() {
+  if (sceneSequencer_isRunning()) {
+    omote_log_d("sceneSequencer: cancel sequence, %u steps will not be executed\r\n", (unsigned int)(sceneSequence.size() - sceneSequence_nextStep));
+  }
+  sceneSequence.clear();
+  sceneSequence_nextStep = 0;
+  sceneSequence_waitBeforeNextStep = 0;
+}
+
+void sceneSequencer_loop() {
+  while (sceneSequencer_isRunning() && (millis() - sceneSequence_lastStepTime >= sceneSequence_waitBeforeNextStep)) {
+    // copy the step, because executing the command could cancel the sequence or add new steps
+    sceneSequenceStep step = sceneSequence[sceneSequence_nextStep];
+    sceneSequence_nextStep++;
+    sceneSequence_lastStepTime = millis();
+    sceneSequence_waitBeforeNextStep = step.waitAfter_ms;
+
+    omote_log_d("sceneSequencer: execute step %u, command '%u', then wait %lu ms\r\n", (unsigned int)sceneSequence_nextStep, step.command, step.waitAfter_ms);
+    executeCommand(step.command);
+  }
+}
+
+uint32_t sceneSequencer_timeTillNextStep() {
+  if (!sceneSequencer_isRunning()) {
+    return UINT32_MAX;
+  }
+  unsigned long elapsed = millis() - sceneSequence_lastStepTime;
+  return (elapsed >= sceneSequence_waitBeforeNextStep) ? 0 : sceneSequence_waitBeforeNextStep - elapsed;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <initializer_list>
+
+// Scene start and end sequences often need a pause between two commands, e.g. to give a TV time to power on before switching its input.
+// Instead of calling executeCommand() and delay(), a scene can describe its sequence as a list of steps.
+// The steps are executed by sceneSequencer_loop() from the main loop, so the remote keeps redrawing, scanning keys and servicing MQTT/BLE while waiting.
+// Example:
+//   sceneSequencer_add({
+//     {SAMSUNG_POWER_ON,  500},
+//     {YAMAHA_POWER_ON,  1500},
+//     {SAMSUNG_INPUT_TV,    0},
+//   });
+struct sceneSequenceStep {
+  uint16_t command;
+  // time to wait after this command, before the next step is executed
+  unsigned long waitAfter_ms;
+};
+
+// Appends the steps to the sequence that is currently running. If no sequence is running, the first step is executed in the next loop
+// (or after the wait of the last step of the previous sequence is over).
+// Appending means that the end sequence of the old scene and the start sequence of the new scene are executed one after the other.
+void sceneSequencer_add(std::initializer_list<sceneSequenceStep> steps);
+// Drops all steps that have not been executed yet. Used when another scene is selected while a sequence is still running.
+void sceneSequencer_cancel();
+bool sceneSequencer_isRunning();
+// executes the next step, if it is due
+void sceneSequencer_loop();
+// ms until the next step is due, UINT32_MAX if no sequence is running. Used by the scheduler.
+uint32_t sceneSequencer_timeTillNextStep();
@@ -0,0 +1,143 @@
+#include <atomic>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/omote_log.h"
+
+struct t_schedulerTask {
+  const char *name;
+  tSchedulerTask task;
+  uint32_t period_ms;
+  tSchedulerNextDeadline nextDeadline;
+  // millis() when the task is due because of its period
+  unsigned long nextRun;
+  std::atomic<bool> woken;
+  schedulerTaskStatistics statistics;
+};
+static t_schedulerTask schedulerTasks[SCHEDULER_MAX_TASKS];
+static uint8_t schedulerTaskCount = 0;
+static uint32_t timeTillNextDeadline = 0;
+
+#if defined(SHOW_SCHEDULER_STATISTICS_ON_SERIAL)
+static unsigned long updateSerialLogTimer = 0;
+#endif
+
+uint8_t scheduler_addTask(const char *name, tSchedulerTask task, uint32_t period_ms, tSchedulerNextDeadline nextDeadline) {
+  if (schedulerTaskCount >= SCHEDULER_MAX_TASKS) {
+    omote_log_e("scheduler: cannot add task %s, increase SCHEDULER_MAX_TASKS\r\n", name);
+    return UINT8_MAX;
+  }
+  t_schedulerTask *t = &schedulerTasks[schedulerTaskCount];
+  t->name = name;
+  t->task = task;
+  t->period_ms = period_ms;
+  t->nextDeadline = nextDeadline;
+  // periodic tasks run for the first time in the first pass
+  t->nextRun = millis();
+  t->woken = false;
+  t->statistics = schedulerTaskStatistics{name, 0, 0, 0, 0, 0};
+  return schedulerTaskCount++;
+}
+
+void scheduler_wakeTask(uint8_t taskId) {
+  if (taskId < schedulerTaskCount) {
+    schedulerTasks[taskId].woken = true;
+  }
+}
+
+static uint32_t timeTillDue(t_schedulerTask *t, unsigned long now) {
+  if (t->woken) {
+    return 0;
+  }
+  uint32_t till = SCHEDULER_NO_DEADLINE;
+  if (t->period_ms != SCHEDULER_NO_PERIOD) {
+    long diff = (long)(t->nextRun - now);
+    till = (diff <= 0) ? 0 : diff;
+  }
+  if (t->nextDeadline != NULL) {
+    uint32_t deadline = t->nextDeadline();
+    if (deadline < till) {
+      till = deadline;
+    }
+  }
+  return till;
+}
+
+#if defined(SHOW_SCHEDULER_STATISTICS_ON_SERIAL)
+static void logTaskStatistics() {
+  for (uint8_t i = 0; i < schedulerTaskCount; i++) {
+    schedulerTaskStatistics *s = &schedulerTasks[i].statistics;
+    omote_log_d("scheduler: %-12s runs %7lu, avg %6lu us, max %7lu us, overruns %4lu, max late %4lu ms\r\n",
+      s->name, (unsigned long)s->runs, (s->runs > 0) ? (unsigned long)(s->totalRunTime_us / s->runs) : 0UL,
+      (unsigned long)s->maxRunTime_us, (unsigned long)s->overruns, (unsigned long)s->maxLateness_ms);
+  }
+}
+#endif
+
+uint32_t scheduler_loop(void) {
+  for (uint8_t i = 0; i < schedulerTaskCount; i++) {
+    t_schedulerTask *t = &schedulerTasks[i];
+    unsigned long now = millis();
+    if (timeTillDue(t, now) > 0) {
+      continue;
+    }
+    t->woken = false;
+
+    schedulerTaskStatistics *s = &t->statistics;
+    if ((t->period_ms != SCHEDULER_NO_PERIOD) && ((long)(now - t->nextRun) > (long)s->maxLateness_ms)) {
+      s->maxLateness_ms = now - t->nextRun;
+    }
+    unsigned long start = micros();
+    t->task();
+    uint32_t runTime_us = micros() - start;
+    if (t->period_ms != SCHEDULER_NO_PERIOD) {
+      t->nextRun = now + t->period_ms;
+    }
+
+    s->runs++;
+    s->totalRunTime_us += runTime_us;
+    if (runTime_us > s->maxRunTime_us) {
+      s->maxRunTime_us = runTime_us;
+    }
+    if ((t->period_ms != SCHEDULER_NO_PERIOD) && (t->period_ms > 0) && (runTime_us > t->period_ms * 1000)) {
+      s->overruns++;
+    }
+  }
+
+  #if defined(SHOW_SCHEDULER_STATISTICS_ON_SERIAL)
+  if (millis() - updateSerialLogTimer >= 10000) {
+    updateSerialLogTimer = millis();
+    logTaskStatistics();
+  }
+  #endif
+
+  unsigned long now = millis();
+  timeTillNextDeadline = SCHEDULER_NO_DEADLINE;
+  for (uint8_t i = 0; i < schedulerTaskCount; i++) {
+    uint32_t till = timeTillDue(&schedulerTasks[i], now);
+    if (till < timeTillNextDeadline) {
+      timeTillNextDeadline = till;
+    }
+  }
+  return timeTillNextDeadline;
+}
+
+uint32_t scheduler_getTimeTillNextDeadline(void) {
+  return timeTillNextDeadline;
+}
+
+uint8_t scheduler_getTaskCount(void) {
+  return schedulerTaskCount;
+}
+
+schedulerTaskStatistics scheduler_getTaskStatistics(uint8_t taskId) {
+  if (taskId >= schedulerTaskCount) {
+    return schedulerTaskStatistics{"", 0, 0, 0, 0, 0};
+  }
+  return schedulerTasks[taskId].statistics;
+}
+
+void scheduler_resetTaskStatistics(void) {
+  for (uint8_t i = 0; i < schedulerTaskCount; i++) {
+    schedulerTasks[i].statistics = schedulerTaskStatistics{schedulerTasks[i].name, 0, 0, 0, 0, 0};
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// activate log of the task statistics on serial output, every 10 s
+//#define SHOW_SCHEDULER_STATISTICS_ON_SERIAL
+
+// A small cooperative scheduler for loop(). Each task runs
+//   - every period_ms (0: in every pass of the scheduler),
+//   - and/or when its nextDeadline callback says it is due (e.g. the next step of a scene sequence, the next lvgl timer),
+//   - and/or as soon as possible after scheduler_wakeTask() was called (e.g. from an interrupt).
+// scheduler_loop() runs all due tasks and returns the time until the next one is due, so that the caller can idle until then.
+// Tasks are not preempted. A task that runs longer than its period counts as overrun.
+#define SCHEDULER_MAX_TASKS   12
+#define SCHEDULER_NO_PERIOD   UINT32_MAX
+#define SCHEDULER_NO_DEADLINE UINT32_MAX
+
+typedef void (*tSchedulerTask)(void);
+// ms until the task has to run again, SCHEDULER_NO_DEADLINE if it is not waiting for anything
+typedef uint32_t (*tSchedulerNextDeadline)(void);
+
+// returns the id of the task, which is needed for scheduler_wakeTask(). Tasks run in the order they were added.
+uint8_t scheduler_addTask(const char *name, tSchedulerTask task, uint32_t period_ms, tSchedulerNextDeadline nextDeadline = NULL);
+// lets the task run in the next pass. Can be called from an interrupt or another thread.
+void scheduler_wakeTask(uint8_t taskId);
+// runs all tasks that are due, returns the ms until the next task is due
+uint32_t scheduler_loop(void);
+uint32_t scheduler_getTimeTillNextDeadline(void);
+
+struct schedulerTaskStatistics {
+  const char *name;
+  uint32_t runs;
+  uint32_t maxRunTime_us;
+  uint64_t totalRunTime_us;
+  // runs that took longer than the period
+  uint32_t overruns;
+  // how late the task started at most, compared to its deadline
+  uint32_t maxLateness_ms;
+};
+uint8_t scheduler_getTaskCount(void);
+schedulerTaskStatistics scheduler_getTaskStatistics(uint8_t taskId);
+void scheduler_resetTaskStatistics(void);
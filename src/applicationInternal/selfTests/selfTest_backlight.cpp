@@ -0,0 +1,101 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+
+// Checks the fades of the backlight against the software model of the simulator, which fades like the LEDC hardware of the ESP32:
+// a new fade only when the target changes, linear from the old to the new duty, and no new target while a fade is still running.
+
+// waits until the last fade of the backlight has reached its target
+static void waitForBacklightFade(void) {
+  backlightFade fade;
+  if (!get_lastBacklightFade(&fade)) {
+    return;
+  }
+  while (millis() - fade.start_ms < fade.fadeTime_ms) {
+    delay(1);
+  }
+}
+
+// sets the brightness and waits until the backlight has faded to it
+static void fadeBacklightTo(uint8_t brightness) {
+  set_backlightBrightness(brightness);
+  // a fade that was still running ignores the new target, so update again after it has finished
+  update_backlightBrightness();
+  waitForBacklightFade();
+  update_backlightBrightness();
+  waitForBacklightFade();
+}
+
+static void selfTest_backlightFade(void) {
+  uint8_t brightnessBefore = get_backlightBrightness();
+  backlightFade fade;
+  backlightFade lastFade;
+
+  fadeBacklightTo(200);
+  SELFTEST_CHECK(get_lastBacklightFade(&lastFade));
+  SELFTEST_CHECK(lastFade.toDuty == 200);
+
+  // the target did not change, so no new fade
+  update_backlightBrightness();
+  update_backlightBrightness();
+  SELFTEST_CHECK(get_lastBacklightFade(&fade));
+  SELFTEST_CHECK((fade.start_ms == lastFade.start_ms) && (fade.toDuty == lastFade.toDuty));
+
+  // a new target starts a fade from the current duty, now
+  set_backlightBrightness(100);
+  unsigned long before = millis();
+  update_backlightBrightness();
+  unsigned long after = millis();
+  SELFTEST_CHECK(get_lastBacklightFade(&fade));
+  SELFTEST_CHECK((fade.start_ms - before) <= (after - before));
+  SELFTEST_CHECK((fade.fromDuty == 200) && (fade.toDuty == 100));
+  SELFTEST_CHECK(fade.fadeTime_ms > 0);
+
+  // the curve is linear, from 200 at its start to 100 at its end
+  SELFTEST_CHECK(get_backlightDutyAt(fade.start_ms) == 200);
+  SELFTEST_CHECK(get_backlightDutyAt(fade.start_ms + fade.fadeTime_ms) == 100);
+  SELFTEST_CHECK(get_backlightDutyAt(fade.start_ms + fade.fadeTime_ms + 1000) == 100);
+  int32_t maxDeviation = 0;
+  bool monotonic = true;
+  for (uint32_t t = 0; t <= fade.fadeTime_ms; t++) {
+    int32_t duty = get_backlightDutyAt(fade.start_ms + t);
+    int32_t expected = 200 - (int32_t)(100 * t / fade.fadeTime_ms);
+    int32_t deviation = (duty > expected) ? duty - expected : expected - duty;
+    if (deviation > maxDeviation) {
+      maxDeviation = deviation;
+    }
+    if ((t > 0) && (duty > get_backlightDutyAt(fade.start_ms + t - 1))) {
+      monotonic = false;
+    }
+  }
+  SELFTEST_CHECK(maxDeviation <= 1);
+  SELFTEST_CHECK(monotonic);
+
+  // while fading, a new target is not taken
+  set_backlightBrightness(255);
+  update_backlightBrightness();
+  SELFTEST_CHECK(get_lastBacklightFade(&lastFade));
+  SELFTEST_CHECK((lastFade.start_ms == fade.start_ms) && (lastFade.toDuty == 100));
+
+  // but on the first update after the fade has ended
+  waitForBacklightFade();
+  update_backlightBrightness();
+  SELFTEST_CHECK(get_lastBacklightFade(&lastFade));
+  SELFTEST_CHECK((lastFade.fromDuty == 100) && (lastFade.toDuty == 255));
+  SELFTEST_CHECK((int32_t)(lastFade.start_ms - (fade.start_ms + fade.fadeTime_ms)) >= 0);
+  // the older curve is still used for times before the new one
+  SELFTEST_CHECK(get_backlightDutyAt(fade.start_ms + fade.fadeTime_ms) == 100);
+  SELFTEST_CHECK(get_backlightDutyAt(fade.start_ms + fade.fadeTime_ms / 2) < 200);
+  omote_log_i("selfTest:   backlight faded from 200 to 100 in %lu ms, largest deviation from a linear fade %ld\r\n",
+    (unsigned long)fade.fadeTime_ms, (long)maxDeviation);
+
+  fadeBacklightTo(brightnessBefore);
+}
+
+void register_selfTests_backlight(void) {
+  register_selfTest("backlightFade", &selfTest_backlightFade);
+}
+
+#endif
@@ -0,0 +1,531 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/scenes/sceneSequencer.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+#include "devices/misc/device_specialCommands.h"
+#include "scenes/scene__default.h"
+#include "scenes/scene_TV.h"
+#include "devices/misc/device_smarthome/device_smarthome.h"
+#include "devices/misc/device_smarthome/gui_smarthome.h"
+
+// --- command table ----------------------------------------------------------
+// Benchmark of the dense command table against the std::map<uint16_t, commandData> it replaced.
+// Both hold the commands registered by the devices. The key presses are the same pseudo random sequence of IR commands for both.
+// The times are only logged: they depend on the host and its load, and are much slower under ThreadSanitizer. Checked is that both find the same commands.
+#define COMMAND_TABLE_BENCHMARK_PRESSES 200000
+
+static void selfTest_commandTable(void) {
+  std::map<uint16_t, commandData> commandMap;
+  std::vector<uint16_t> irCommands;
+  for (uint16_t command = 0; command < get_commandCount(); command++) {
+    const commandData *data = get_commandData(command);
+    if (data == NULL) {
+      continue;
+    }
+    commandMap[command] = *data;
+    if (data->commandHandler == IR) {
+      irCommands.push_back(command);
+    }
+  }
+  if (!SELFTEST_CHECK(!irCommands.empty())) {
+    return;
+  }
+  std::vector<uint16_t> presses(COMMAND_TABLE_BENCHMARK_PRESSES);
+  uint32_t random = 12345;
+  for (auto &press : presses) {
+    random = random * 1103515245 + 12345;
+    press = irCommands[(random >> 16) % irCommands.size()];
+  }
+
+  // lookup only. The sums keep the compiler from removing the loops.
+  uint32_t mapSum = 0;
+  unsigned long start = micros();
+  for (uint16_t command : presses) {
+    // as executeCommand() did before
+    if (commandMap.count(command) > 0) {
+      mapSum += commandMap.at(command).commandHandler + command;
+    }
+  }
+  unsigned long mapLookup_us = micros() - start;
+  uint32_t tableSum = 0;
+  start = micros();
+  for (uint16_t command : presses) {
+    const commandData *data = get_commandData(command);
+    if (data != NULL) {
+      tableSum += data->commandHandler + command;
+    }
+  }
+  unsigned long tableLookup_us = micros() - start;
+  SELFTEST_CHECK(tableSum == mapSum);
+
+  // lookup and execute. The IR HAL of the simulator sends nothing, so this is the cost of the command handler itself.
+  start = micros();
+  for (uint16_t command : presses) {
+    if (commandMap.count(command) > 0) {
+      executeCommandWithData(command, commandMap.at(command), "");
+    }
+  }
+  unsigned long mapExecute_us = micros() - start;
+  start = micros();
+  for (uint16_t command : presses) {
+    const commandData *data = get_commandData(command);
+    if (data != NULL) {
+      executeCommandWithData(command, *data, "");
+    }
+  }
+  unsigned long tableExecute_us = micros() - start;
+
+  omote_log_i("selfTest: %u commands, %u IR commands, %u presses (checksum %lu)\r\n",
+    get_commandCount(), (unsigned int)irCommands.size(), COMMAND_TABLE_BENCHMARK_PRESSES, (unsigned long)tableSum);
+  omote_log_i("selfTest:   lookup            map %6.1f ns, table %6.1f ns per press\r\n",
+    mapLookup_us * 1000.0 / COMMAND_TABLE_BENCHMARK_PRESSES, tableLookup_us * 1000.0 / COMMAND_TABLE_BENCHMARK_PRESSES);
+  omote_log_i("selfTest:   lookup and execute map %6.1f ns, table %6.1f ns per press\r\n",
+    mapExecute_us * 1000.0 / COMMAND_TABLE_BENCHMARK_PRESSES, tableExecute_us * 1000.0 / COMMAND_TABLE_BENCHMARK_PRESSES);
+}
+
+// --- IR round trip -----------------------------------------------------------
+// IR codes are parsed when they are registered and sent later by the command worker. The IR HAL of the simulator records what it was asked to send.
+// Each command is executed through the queue, and the recorded code has to be the same as the payload it was registered with.
+static uint16_t IRTEST_NEC_DEFAULTS;
+static uint16_t IRTEST_SONY_EXPLICIT;
+static uint16_t IRTEST_GC;
+static uint16_t IRTEST_NEC_PROTOCOL_ONLY;
+static uint16_t IRTEST_NEC_INVALID;
+static uint16_t IRTEST_TABLE_NEC_DEFAULTS;
+static uint16_t IRTEST_TABLE_GC;
+static const uint16_t irTest_gcTimings[] = {38000, 1, 1, 172, 172, 22, 64, 22, 21, 22, 1673};
+#define IRTEST_NEC_DEFAULTS_PAYLOAD  "0x20DF10EF"
+#define IRTEST_SONY_EXPLICIT_PAYLOAD "0xA90:12:2"
+#define IRTEST_GC_PAYLOAD            "38000,1,1,172,172,22,64,22,21,22,1673"
+
+static void register_irRoundTripCommands(void) {
+  register_command(&IRTEST_NEC_DEFAULTS,      makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), IRTEST_NEC_DEFAULTS_PAYLOAD}));
+  register_command(&IRTEST_SONY_EXPLICIT,     makeCommandData(IR, {std::to_string(IR_PROTOCOL_SONY), IRTEST_SONY_EXPLICIT_PAYLOAD}));
+  register_command(&IRTEST_GC,                makeCommandData(IR, {std::to_string(IR_PROTOCOL_GLOBALCACHE), IRTEST_GC_PAYLOAD}));
+  register_command(&IRTEST_NEC_PROTOCOL_ONLY, makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC)}));
+  register_command(&IRTEST_NEC_INVALID,       makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x20DF10EF:32"}));
+  static const IRcommandTableEntry irTestTable[] = {
+    {&IRTEST_TABLE_NEC_DEFAULTS, IR_PROTOCOL_NEC,         0x20DF40BF, 0, 0, NULL, 0},
+    {&IRTEST_TABLE_GC,           IR_PROTOCOL_GLOBALCACHE, 0,          0, 0, irTest_gcTimings, sizeof(irTest_gcTimings) / sizeof(irTest_gcTimings[0])},
+  };
+  register_IRcommandTable(irTestTable, sizeof(irTestTable) / sizeof(irTestTable[0]));
+}
+
+// Executes the command and waits until the worker has sent it. Returns false if nothing was sent within a second.
+static bool irRoundTrip(uint16_t command, const std::string &additionalPayload, sentIRcode *sent) {
+  get_lastSentIRcode(sent);
+  uint32_t countBefore = sent->count;
+  executeCommand(command, additionalPayload);
+  unsigned long start = millis();
+  while (millis() - start < 1000) {
+    selfTest_runMainLoop(1);
+    get_lastSentIRcode(sent);
+    if (sent->count != countBefore) {
+      return sent->count == countBefore + 1;
+    }
+  }
+  return false;
+}
+
+static void selfTest_irRoundTrip(void) {
+  sentIRcode sent;
+
+  // data only, nbits and repeat are the defaults of the protocol
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_NEC_DEFAULTS, "", &sent))) {
+    SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_NEC);
+    SELFTEST_CHECK(sent.data == 0x20DF10EF);
+    SELFTEST_CHECK(sent.nbits == kNECBits);
+    SELFTEST_CHECK(sent.repeat == kNoRepeat);
+  }
+  // data:nbits:repeat
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_SONY_EXPLICIT, "", &sent))) {
+    SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_SONY);
+    SELFTEST_CHECK(sent.data == 0xA90);
+    SELFTEST_CHECK(sent.nbits == 12);
+    SELFTEST_CHECK(sent.repeat == 2);
+  }
+  // comma separated timings
+  std::vector<uint16_t> gcTimings(irTest_gcTimings, irTest_gcTimings + sizeof(irTest_gcTimings) / sizeof(irTest_gcTimings[0]));
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_GC, "", &sent))) {
+    SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_GLOBALCACHE);
+    SELFTEST_CHECK(sent.timings == gcTimings);
+  }
+  // only the protocol is registered, the data comes as additionalPayload
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_NEC_PROTOCOL_ONLY, "0x1234:16:3", &sent))) {
+    SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_NEC);
+    SELFTEST_CHECK(sent.data == 0x1234);
+    SELFTEST_CHECK(sent.nbits == 16);
+    SELFTEST_CHECK(sent.repeat == 3);
+  }
+  // an additionalPayload replaces the registered data
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_NEC_DEFAULTS, "0x20DF8877", &sent))) {
+    SELFTEST_CHECK(sent.data == 0x20DF8877);
+    SELFTEST_CHECK(sent.nbits == kNECBits);
+  }
+  // neither data nor additionalPayload, and data which cannot be parsed: nothing is sent
+  SELFTEST_CHECK(!irRoundTrip(IRTEST_NEC_PROTOCOL_ONLY, "", &sent));
+  SELFTEST_CHECK(!irRoundTrip(IRTEST_NEC_INVALID, "", &sent));
+  SELFTEST_CHECK(!irRoundTrip(IRTEST_NEC_PROTOCOL_ONLY, "0x12:x:0", &sent));
+  // commands of a const table
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_TABLE_NEC_DEFAULTS, "", &sent))) {
+    SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_NEC);
+    SELFTEST_CHECK(sent.data == 0x20DF40BF);
+    SELFTEST_CHECK(sent.nbits == kNECBits);
+    SELFTEST_CHECK(sent.repeat == kNoRepeat);
+  }
+  if (SELFTEST_CHECK(irRoundTrip(IRTEST_TABLE_GC, "", &sent))) {
+    SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_GLOBALCACHE);
+    SELFTEST_CHECK(sent.timings == gcTimings);
+  }
+}
+
+// --- IR send path ------------------------------------------------------------
+// Benchmark of sending a registered IR command from its parsed IRcode against parsing its strings on each send, as it was done before.
+// Both paths send the same commands through the same IR HAL, which only records the code in the simulator.
+// The times are only logged, like in "commandTable". Checked is that both send the same codes, and that only the string path allocates.
+#define IR_SEND_PATH_BENCHMARK_PRESSES 30000
+
+// What executeCommandWithData() and sendIRcode_HAL() did for each press before IR commands were parsed at registration.
+// The payloads are copied, because executeCommandWithData() got the commandData by value and erased the protocol from it.
+static bool sendIRcodeFromStrings(std::list<std::string> commandPayloads, const std::string &additionalPayload) {
+  std::list<std::string>::iterator it = commandPayloads.begin();
+  int protocol = std::stoi(*it);
+  it = commandPayloads.erase(it);
+
+  std::string dataStr;
+  if (additionalPayload != "") {
+    dataStr = additionalPayload;
+  } else if (!commandPayloads.empty()) {
+    dataStr = *commandPayloads.begin();
+  } else {
+    return false;
+  }
+
+  if (protocol == IR_PROTOCOL_GLOBALCACHE) {
+    std::string::difference_type size = std::count(dataStr.begin(), dataStr.end(), ',') + 1;
+    uint16_t *buf = new uint16_t[size];
+    int pos = 0;
+    std::stringstream ss(dataStr);
+    while (ss.good()) {
+      std::string valueStr;
+      std::getline(ss, valueStr, ',');
+      buf[pos] = std::stoull(valueStr, nullptr, 0);
+      pos += 1;
+    }
+    IRcode irCode = {(int16_t)protocol, true, 0, kNoRepeat, 0, (uint16_t)size, buf};
+    sendIRcode(irCode);
+    delete [] buf;
+    return true;
+  }
+
+  if (std::count(dataStr.begin(), dataStr.end(), ':') == 0) {
+    uint16_t nbits, repeat;
+    if (!getProtocolDefaultBitsAndRepeat(protocol, &nbits, &repeat)) {
+      return false;
+    }
+    dataStr.append(":").append(std::to_string(nbits)).append(":").append(std::to_string(repeat));
+  }
+  if (std::count(dataStr.begin(), dataStr.end(), ':') != 2) {
+    return false;
+  }
+  std::string valueAsStr;
+  std::stringstream dataStrAsStream(dataStr);
+  IRcode irCode = {(int16_t)protocol, true, 0, kNoRepeat, 0, 0, NULL};
+  std::getline(dataStrAsStream, valueAsStr, ':');
+  irCode.data = std::stoull(valueAsStr, nullptr, 0);
+  std::getline(dataStrAsStream, valueAsStr, ':');
+  irCode.nbits = std::stoul(valueAsStr, nullptr, 0);
+  std::getline(dataStrAsStream, valueAsStr, ':');
+  irCode.repeat = std::stoul(valueAsStr, nullptr, 0);
+  sendIRcode(irCode);
+  return true;
+}
+
+struct irSendPathCommand {
+  const char *name;
+  uint16_t command;
+  std::list<std::string> payloads;
+};
+
+static void selfTest_irSendPath(void) {
+  // the commands registered for "irRoundTrip", with the strings they were registered with
+  const irSendPathCommand commands[] = {
+    {"NEC, defaults",        IRTEST_NEC_DEFAULTS,  {std::to_string(IR_PROTOCOL_NEC),         IRTEST_NEC_DEFAULTS_PAYLOAD}},
+    {"Sony, data:nbits:rep", IRTEST_SONY_EXPLICIT, {std::to_string(IR_PROTOCOL_SONY),        IRTEST_SONY_EXPLICIT_PAYLOAD}},
+    {"GC timings",           IRTEST_GC,            {std::to_string(IR_PROTOCOL_GLOBALCACHE), IRTEST_GC_PAYLOAD}},
+  };
+  const std::string noPayload = "";
+  sentIRcode fromStrings;
+  sentIRcode fromIRcode;
+
+  for (const irSendPathCommand &command : commands) {
+    const commandData *data = get_commandData(command.command);
+    if (!SELFTEST_CHECK(data != NULL)) {
+      return;
+    }
+    // both paths send the same code
+    SELFTEST_CHECK(sendIRcodeFromStrings(command.payloads, noPayload));
+    get_lastSentIRcode(&fromStrings);
+    executeCommandWithData(command.command, *data, noPayload);
+    get_lastSentIRcode(&fromIRcode);
+    SELFTEST_CHECK(fromIRcode.count == fromStrings.count + 1);
+    SELFTEST_CHECK(fromIRcode.protocol == fromStrings.protocol);
+    SELFTEST_CHECK(fromIRcode.data == fromStrings.data);
+    SELFTEST_CHECK(fromIRcode.nbits == fromStrings.nbits);
+    SELFTEST_CHECK(fromIRcode.repeat == fromStrings.repeat);
+    SELFTEST_CHECK(fromIRcode.timings == fromStrings.timings);
+
+    // the strings are parsed on each send, the IRcode was parsed once at registration
+    uint32_t before = selfTest_getAllocationCount();
+    sendIRcodeFromStrings(command.payloads, noPayload);
+    uint32_t stringAllocations = selfTest_getAllocationCount() - before;
+    before = selfTest_getAllocationCount();
+    executeCommandWithData(command.command, *data, noPayload);
+    uint32_t irCodeAllocations = selfTest_getAllocationCount() - before;
+    SELFTEST_CHECK(stringAllocations > 0);
+    SELFTEST_CHECK(irCodeAllocations == 0);
+
+    unsigned long start = micros();
+    for (int i = 0; i < IR_SEND_PATH_BENCHMARK_PRESSES; i++) {
+      sendIRcodeFromStrings(command.payloads, noPayload);
+    }
+    unsigned long fromStrings_us = micros() - start;
+    start = micros();
+    for (int i = 0; i < IR_SEND_PATH_BENCHMARK_PRESSES; i++) {
+      executeCommandWithData(command.command, *data, noPayload);
+    }
+    unsigned long fromIRcode_us = micros() - start;
+
+    omote_log_i("selfTest:   %-20s strings %7.1f ns, %2u allocations   IRcode %7.1f ns, %u allocations per send\r\n", command.name,
+      fromStrings_us * 1000.0 / IR_SEND_PATH_BENCHMARK_PRESSES, stringAllocations,
+      fromIRcode_us * 1000.0 / IR_SEND_PATH_BENCHMARK_PRESSES, irCodeAllocations);
+  }
+}
+
+// --- allocations -------------------------------------------------------------
+// Steady state key presses must not allocate memory. A command is first pressed a few times, so that everything only done once is done
+// (e.g. the switch to a scene, or the first navigation to a gui). Then it is pressed again and again, and operator new must not be called.
+// The warmup is longer than the command queue: each slot of the queue keeps the additionalPayload. A long one allocates only the first time a slot is used.
+#define ALLOCATION_TEST_WARMUP_PRESSES 40
+#define ALLOCATION_TEST_PRESSES 20
+
+// Waits until the worker has executed all queued commands. Does not run the main loop, it would allocate on its own.
+static void waitUntilQueueIsEmpty(void) {
+  commandQueueMetrics metrics;
+  unsigned long start = millis();
+  do {
+    delay(1);
+    get_commandQueueMetrics(&metrics);
+  } while ((metrics.depth > 0) && (millis() - start < 1000));
+}
+
+// returns the number of allocations of ALLOCATION_TEST_PRESSES presses
+static uint32_t allocationsOfPresses(const char *name, uint16_t command, const std::string &additionalPayload) {
+  for (int i = 0; i < ALLOCATION_TEST_WARMUP_PRESSES; i++) {
+    executeCommand(command, additionalPayload);
+    waitUntilQueueIsEmpty();
+  }
+  // e.g. a scene sequence started by the first press
+  selfTest_runMainLoop(200);
+  uint32_t before = selfTest_getAllocationCount();
+  for (int i = 0; i < ALLOCATION_TEST_PRESSES; i++) {
+    executeCommand(command, additionalPayload);
+    waitUntilQueueIsEmpty();
+  }
+  uint32_t allocations = selfTest_getAllocationCount() - before;
+  omote_log_i("selfTest:   %-28s %u allocations in %u presses\r\n", name, allocations, ALLOCATION_TEST_PRESSES);
+  return allocations;
+}
+
+static void selfTest_noAllocations(void) {
+  // longer than the buffer of std::string for short strings, so that copying it would allocate
+  const std::string longPayload = "a payload longer than the small string buffer";
+  const std::string irPayload = "0x1234:16:3";
+  const std::string noPayload = "";
+
+  // the counter itself
+  uint32_t before = selfTest_getAllocationCount();
+  std::string *allocated = new std::string(longPayload);
+  SELFTEST_CHECK(selfTest_getAllocationCount() - before >= 1);
+  delete allocated;
+
+  sentIRcode sent;
+  get_lastSentIRcode(&sent);
+  uint32_t irSentBefore = sent.count;
+  SELFTEST_CHECK(allocationsOfPresses("IR, registered", IRTEST_NEC_DEFAULTS, noPayload) == 0);
+  SELFTEST_CHECK(allocationsOfPresses("IR, registered, payload", IRTEST_NEC_PROTOCOL_ONLY, irPayload) == 0);
+  SELFTEST_CHECK(allocationsOfPresses("IR, const table", IRTEST_TABLE_NEC_DEFAULTS, noPayload) == 0);
+  SELFTEST_CHECK(allocationsOfPresses("IR, const table, GC", IRTEST_TABLE_GC, noPayload) == 0);
+  get_lastSentIRcode(&sent);
+  SELFTEST_CHECK(sent.count - irSentBefore == 4 * (ALLOCATION_TEST_WARMUP_PRESSES + ALLOCATION_TEST_PRESSES));
+
+  // With ENABLE_TASK_SPLIT=1 MQTT and BLE are queued for the connectivity task as std::function, which allocates. And MQTT is only published later.
+  #if (ENABLE_WIFI_AND_MQTT == 1) && (ENABLE_TASK_SPLIT != 1)
+  uint32_t mqttPublishedBefore = get_publishedMQTTMessageCount();
+  SELFTEST_CHECK(allocationsOfPresses("MQTT", SMARTHOME_MQTT_BULB1_SET, longPayload) == 0);
+  SELFTEST_CHECK(get_publishedMQTTMessageCount() - mqttPublishedBefore == ALLOCATION_TEST_WARMUP_PRESSES + ALLOCATION_TEST_PRESSES);
+  #endif
+
+  #if (ENABLE_KEYBOARD_BLE == 1) && (ENABLE_TASK_SPLIT != 1)
+  SELFTEST_CHECK(allocationsOfPresses("BLE keyboard", KEYBOARD_BLE_UP, noPayload) == 0);
+  SELFTEST_CHECK(allocationsOfPresses("BLE keyboard, send string", KEYBOARD_BLE_SENDSTRING, longPayload) == 0);
+  #endif
+
+  // the active scene again, and navigating beyond the first gui
+  SELFTEST_CHECK(allocationsOfPresses("SCENE, active scene", SCENE_TV, noPayload) == 0);
+  SELFTEST_CHECK(allocationsOfPresses("SCENE, prev gui", GUI_PREV, noPayload) == 0);
+
+  // the gui already shown
+  SELFTEST_CHECK(allocationsOfPresses("GUI", GUI_SMARTHOME_ACTIVATE, noPayload) == 0);
+}
+
+// --- command order -----------------------------------------------------------
+// Thousands of commands for the worker (IR) and for the main loop (SPECIAL), mixed at random. Each one has its sequence number as additionalPayload,
+// and all of them must be executed exactly once and in this order, no matter which consumer executes them.
+// First all of them at once: the queue is full most of the time, executeCommand() has to wait. Then in small bursts, with the main loop running in between.
+// A burst is much smaller than the queue and the queue is emptied after each one, so executeCommand() must not wait then.
+#define COMMAND_ORDER_PRESSES 4000
+#define COMMAND_ORDER_BURST 5
+// Longest time a command may wait in the queue. In the simulator a full queue (32 commands) is worked off in 10 to 20 ms.
+// The bound leaves room for ThreadSanitizer and loaded machines. A command waiting longer means that a consumer did not hand over.
+#define COMMAND_ORDER_MAX_WAIT_MS 250
+
+static uint32_t commandOrder_expected = 0;
+static uint32_t commandOrder_outOfOrder = 0;
+static uint32_t commandOrder_ir = 0;
+static uint32_t commandOrder_special = 0;
+
+// called by the worker or the main loop, but never by both at the same time
+static void commandOrder_executed(uint16_t command, const std::string &additionalPayload) {
+  if ((command != IRTEST_NEC_PROTOCOL_ONLY) && (command != MY_SPECIAL_COMMAND)) {
+    return;
+  }
+  uint32_t sequence = strtoul(additionalPayload.c_str(), NULL, 0);
+  if (sequence != commandOrder_expected) {
+    if (commandOrder_outOfOrder == 0) {
+      omote_log_e("selfTest:   command %u was executed, expected %u\r\n", sequence, commandOrder_expected);
+    }
+    commandOrder_outOfOrder++;
+  }
+  commandOrder_expected = sequence + 1;
+  if (command == IRTEST_NEC_PROTOCOL_ONLY) {
+    commandOrder_ir++;
+  } else {
+    commandOrder_special++;
+  }
+}
+
+static void commandOrder_press(uint32_t sequence, uint32_t *random) {
+  *random = *random * 1103515245 + 12345;
+  char payload[16];
+  if ((*random >> 16) & 1) {
+    // the sequence number is the data of the IR code
+    snprintf(payload, sizeof(payload), "0x%x", sequence);
+    executeCommand(IRTEST_NEC_PROTOCOL_ONLY, payload);
+  } else {
+    snprintf(payload, sizeof(payload), "%u", sequence);
+    executeCommand(MY_SPECIAL_COMMAND, payload);
+  }
+}
+
+// runs the main loop until the queue is empty. Returns false if it took longer than a second.
+static bool commandOrder_waitUntilQueueIsEmpty(void) {
+  commandQueueMetrics metrics;
+  unsigned long start = millis();
+  do {
+    selfTest_runMainLoop(1);
+    get_commandQueueMetrics(&metrics);
+  } while ((metrics.depth > 0) && (millis() - start < 1000));
+  return metrics.depth == 0;
+}
+
+static void selfTest_commandOrder(void) {
+  // e.g. the start sequence of the scene activated by noAllocations would send IR codes in between
+  unsigned long start = millis();
+  while (sceneSequencer_isRunning() && (millis() - start < 10000)) {
+    selfTest_runMainLoop(10);
+  }
+  SELFTEST_CHECK(commandOrder_waitUntilQueueIsEmpty());
+
+  commandQueueMetrics metrics;
+  get_commandQueueMetrics(&metrics);
+  uint32_t executedBefore = metrics.executed;
+  uint32_t blockedBefore = metrics.blocked;
+  unsigned long blockedBefore_ms = metrics.blocked_ms;
+  sentIRcode sent;
+  get_lastSentIRcode(&sent);
+  uint32_t irSentBefore = sent.count;
+  commandOrder_expected = 0;
+  commandOrder_outOfOrder = 0;
+  commandOrder_ir = 0;
+  commandOrder_special = 0;
+  set_commandExecuted_cb(&commandOrder_executed);
+
+  uint32_t random = 4711;
+  uint32_t sequence = 0;
+  start = millis();
+  for (int i = 0; i < COMMAND_ORDER_PRESSES; i++) {
+    commandOrder_press(sequence++, &random);
+  }
+  SELFTEST_CHECK(commandOrder_waitUntilQueueIsEmpty());
+  unsigned long allAtOnce_ms = millis() - start;
+  get_commandQueueMetrics(&metrics);
+  uint32_t blocked = metrics.blocked - blockedBefore;
+  unsigned long blocked_ms = metrics.blocked_ms - blockedBefore_ms;
+  // the queue was full, and executeCommand() waited at least once for the worker
+  SELFTEST_CHECK(blocked > 0);
+  SELFTEST_CHECK(blocked <= COMMAND_ORDER_PRESSES);
+  SELFTEST_CHECK(blocked_ms > 0);
+  SELFTEST_CHECK(blocked_ms <= allAtOnce_ms);
+
+  start = millis();
+  for (int i = 0; i < COMMAND_ORDER_PRESSES / COMMAND_ORDER_BURST; i++) {
+    for (int j = 0; j < COMMAND_ORDER_BURST; j++) {
+      commandOrder_press(sequence++, &random);
+    }
+    SELFTEST_CHECK(commandOrder_waitUntilQueueIsEmpty());
+  }
+  unsigned long inBursts_ms = millis() - start;
+  set_commandExecuted_cb(NULL);
+
+  get_commandQueueMetrics(&metrics);
+  // bursts into an empty queue never wait
+  SELFTEST_CHECK(metrics.blocked - blockedBefore == blocked);
+  SELFTEST_CHECK(metrics.blocked_ms - blockedBefore_ms == blocked_ms);
+  // the highest wait of all commands queued so far, including the ones of the tests before
+  SELFTEST_CHECK(metrics.maxWait_ms <= COMMAND_ORDER_MAX_WAIT_MS);
+  get_lastSentIRcode(&sent);
+  SELFTEST_CHECK(commandOrder_outOfOrder == 0);
+  SELFTEST_CHECK(commandOrder_expected == sequence);
+  SELFTEST_CHECK(commandOrder_ir + commandOrder_special == sequence);
+  SELFTEST_CHECK(sent.count - irSentBefore == commandOrder_ir);
+  // the main loop executes a SPECIAL command inline if the queue is empty, so not all of them went through the queue
+  SELFTEST_CHECK(metrics.executed - executedBefore >= commandOrder_ir);
+  SELFTEST_CHECK(metrics.executed - executedBefore <= sequence);
+  omote_log_i("selfTest:   %u commands (%u IR, %u SPECIAL) in %lu ms at once and %lu ms in bursts of %u, %u out of order\r\n",
+    sequence, commandOrder_ir, commandOrder_special, allAtOnce_ms, inBursts_ms, COMMAND_ORDER_BURST, commandOrder_outOfOrder);
+  omote_log_i("selfTest:   queue: %u executed, max depth %u, avg wait %lu ms, max wait %lu ms. executeCommand() had to wait %u times, %lu ms in total\r\n",
+    metrics.executed - executedBefore, metrics.maxDepth, (metrics.executed > 0) ? metrics.totalWait_ms / metrics.executed : 0, metrics.maxWait_ms, blocked, blocked_ms);
+}
+
+void register_selfTests_commandHandler(void) {
+  register_irRoundTripCommands();
+  register_selfTest("commandTable", &selfTest_commandTable);
+  register_selfTest("irRoundTrip", &selfTest_irRoundTrip);
+  register_selfTest("irSendPath", &selfTest_irSendPath);
+  register_selfTest("noAllocations", &selfTest_noAllocations);
+  register_selfTest("commandOrder", &selfTest_commandOrder);
+}
+
+#endif
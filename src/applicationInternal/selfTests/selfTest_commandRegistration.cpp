@@ -0,0 +1,140 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include <stdio.h>
+#include <limits.h>
+#include <string>
+#include <vector>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+
+// Registration of the IR commands of the current device set, once with register_IRcommandTable() as the devices do it,
+// and once with register_command() and string payloads as the devices did it before.
+// Both are measured while booting, in register_selfTests_commandRegistration(), because that is where the devices register their commands.
+// The test itself checks what was measured, and that both registrations send the same IR codes.
+// Each way is registered REGISTRATION_ROUNDS times, and the cheapest round counts, so that a preemption of the simulator does not spoil the time.
+#define REGISTRATION_ROUNDS 3
+
+struct registrationCost {
+  uint32_t allocations;
+  uint32_t bytes;
+  unsigned long time_us;
+};
+static registrationCost tableCost   = {UINT32_MAX, UINT32_MAX, ULONG_MAX};
+static registrationCost stringsCost = {UINT32_MAX, UINT32_MAX, ULONG_MAX};
+
+// the entries of the device tables, and the same commands as strings
+static std::vector<IRcommandTableEntry> deviceEntries;
+static std::vector<std::string> protocolStrings;
+static std::vector<std::string> dataStrings;
+// register_IRcommandTable() keeps pointers to the entries and to the command ids, so they are never freed
+static std::vector<IRcommandTableEntry> tableEntries[REGISTRATION_ROUNDS];
+static std::vector<uint16_t> tableCommands[REGISTRATION_ROUNDS];
+static std::vector<uint16_t> stringsCommands[REGISTRATION_ROUNDS];
+
+// the payload a device would have registered with register_command() for this entry
+static std::string dataStringOfEntry(const IRcommandTableEntry &entry) {
+  char value[32];
+  if (entry.protocol == IR_PROTOCOL_GLOBALCACHE) {
+    std::string timings;
+    for (uint16_t i = 0; i < entry.timingsLength; i++) {
+      snprintf(value, sizeof(value), (i == 0) ? "%u" : ",%u", entry.timings[i]);
+      timings += value;
+    }
+    return timings;
+  }
+  if (entry.nbits == 0) {
+    snprintf(value, sizeof(value), "0x%llX", (unsigned long long)entry.data);
+  } else {
+    snprintf(value, sizeof(value), "0x%llX:%u:%u", (unsigned long long)entry.data, entry.nbits, entry.repeat);
+  }
+  return value;
+}
+
+static void keepCheapest(registrationCost *cost, uint32_t allocationsBefore, uint32_t bytesBefore, unsigned long start) {
+  unsigned long time_us = micros() - start;
+  uint32_t allocations = selfTest_getAllocationCount() - allocationsBefore;
+  uint32_t bytes = selfTest_getAllocatedBytes() - bytesBefore;
+  if (allocations < cost->allocations) {cost->allocations = allocations;}
+  if (bytes < cost->bytes)             {cost->bytes = bytes;}
+  if (time_us < cost->time_us)         {cost->time_us = time_us;}
+}
+
+static void measureRegistration(void) {
+  for (uint16_t command = 0; command < get_commandCount(); command++) {
+    const IRcommandTableEntry *entry = get_IRcommandTableEntry(command);
+    if (entry != NULL) {
+      deviceEntries.push_back(*entry);
+      protocolStrings.push_back(std::to_string(entry->protocol));
+      dataStrings.push_back(dataStringOfEntry(*entry));
+    }
+  }
+  size_t count = deviceEntries.size();
+
+  for (int round = 0; round < REGISTRATION_ROUNDS; round++) {
+    tableCommands[round].resize(count);
+    stringsCommands[round].resize(count);
+    tableEntries[round] = deviceEntries;
+    for (size_t i = 0; i < count; i++) {
+      tableEntries[round][i].command = &tableCommands[round][i];
+    }
+
+    uint32_t allocationsBefore = selfTest_getAllocationCount();
+    uint32_t bytesBefore = selfTest_getAllocatedBytes();
+    unsigned long start = micros();
+    register_IRcommandTable(tableEntries[round].data(), count);
+    keepCheapest(&tableCost, allocationsBefore, bytesBefore, start);
+
+    // as the devices did it: the strings are created at the call, from literals
+    allocationsBefore = selfTest_getAllocationCount();
+    bytesBefore = selfTest_getAllocatedBytes();
+    start = micros();
+    for (size_t i = 0; i < count; i++) {
+      register_command(&stringsCommands[round][i], makeCommandData(IR, {protocolStrings[i].c_str(), dataStrings[i].c_str()}));
+    }
+    keepCheapest(&stringsCost, allocationsBefore, bytesBefore, start);
+  }
+}
+
+static void selfTest_commandRegistration(void) {
+  size_t count = deviceEntries.size();
+  if (!SELFTEST_CHECK(count > 0)) {
+    return;
+  }
+  omote_log_i("selfTest:   %u IR commands of the devices, cheapest of %u registrations\r\n", (unsigned int)count, REGISTRATION_ROUNDS);
+  omote_log_i("selfTest:   register_IRcommandTable %5u allocations, %6u bytes, %5lu us\r\n", tableCost.allocations, tableCost.bytes, tableCost.time_us);
+  omote_log_i("selfTest:   register_command        %5u allocations, %6u bytes, %5lu us\r\n", stringsCost.allocations, stringsCost.bytes, stringsCost.time_us);
+
+  // At least one std::list node and one string per command for register_command(), only the growth of the command table for the const table.
+  SELFTEST_CHECK(tableCost.allocations < count);
+  SELFTEST_CHECK(stringsCost.allocations >= 2 * count);
+  SELFTEST_CHECK(tableCost.bytes < stringsCost.bytes);
+  SELFTEST_CHECK(tableCost.time_us < stringsCost.time_us);
+
+  // both registrations send the same codes
+  sentIRcode fromTable;
+  sentIRcode fromStrings;
+  for (size_t i = 0; i < count; i++) {
+    executeCommandWithData(tableCommands[0][i], *get_commandData(tableCommands[0][i]), "");
+    get_lastSentIRcode(&fromTable);
+    executeCommandWithData(stringsCommands[0][i], *get_commandData(stringsCommands[0][i]), "");
+    get_lastSentIRcode(&fromStrings);
+    if (!SELFTEST_CHECK(fromStrings.count == fromTable.count + 1)) {
+      omote_log_e("selfTest:   IR command '%s' '%s' was not sent\r\n", protocolStrings[i].c_str(), dataStrings[i].c_str());
+      continue;
+    }
+    SELFTEST_CHECK(fromStrings.protocol == fromTable.protocol);
+    SELFTEST_CHECK(fromStrings.data == fromTable.data);
+    SELFTEST_CHECK(fromStrings.nbits == fromTable.nbits);
+    SELFTEST_CHECK(fromStrings.repeat == fromTable.repeat);
+    SELFTEST_CHECK(fromStrings.timings == fromTable.timings);
+  }
+}
+
+void register_selfTests_commandRegistration(void) {
+  measureRegistration();
+  register_selfTest("commandRegistration", &selfTest_commandRegistration);
+}
+
+#endif
@@ -0,0 +1,353 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include <limits.h>
+#include <string>
+#include <lvgl.h>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/gui/guiBase.h"
+#include "applicationInternal/gui/guiMemoryOptimizer.h"
+#include "applicationInternal/gui/guiRegistry.h"
+#include "applicationInternal/frameStatistics.h"
+#include "applicationInternal/scenes/sceneRegistry.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+#include "scenes/scene__default.h"
+
+// --- test guis --------------------------------------------------------------
+// A gui list longer than the real ones, so that the tab window slides along it. Each page looks like the numpad: a grid of buttons with labels.
+// The test guis are registered at startup, but they are only in main_gui_list while a test runs.
+#define GUI_TEST_PAGES 12
+// time for the first frames after the tabs were created
+#define GUI_TEST_SETTLE_MS 200
+// a swipe like in the scripts, in the middle of the tabview. After the finger is lifted, lvgl lets the tab snap into place with an animation.
+#define GUI_TEST_SWIPE_MS 300
+#define GUI_TEST_SWIPE_TIMEOUT_MS 2000
+
+static t_gui_list guiTestList;
+
+static void create_tab_content_guiTest(lv_obj_t* tab) {
+  static lv_coord_t col_dsc[] = { LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST };
+  static lv_coord_t row_dsc[] = { 52, 52, 52, 52, LV_GRID_TEMPLATE_LAST };
+
+  lv_obj_set_style_pad_all(tab, 0, LV_PART_MAIN);
+  lv_obj_t* cont = lv_obj_create(tab);
+  lv_obj_set_style_bg_color(cont, lv_color_black(), LV_PART_MAIN);
+  lv_obj_set_style_grid_column_dsc_array(cont, col_dsc, 0);
+  lv_obj_set_style_grid_row_dsc_array(cont, row_dsc, 0);
+  lv_obj_set_size(cont, SCR_WIDTH, 270);
+  lv_obj_set_layout(cont, LV_LAYOUT_GRID);
+  lv_obj_align(cont, LV_ALIGN_TOP_MID, 0, 0);
+  for (int i = 0; i < 12; i++) {
+    lv_obj_t* obj = lv_btn_create(cont);
+    lv_obj_set_grid_cell(obj, LV_GRID_ALIGN_STRETCH, i % 3, 1, LV_GRID_ALIGN_STRETCH, i / 3, 1);
+    lv_obj_set_style_bg_color(obj, color_primary, LV_PART_MAIN);
+    lv_obj_set_style_radius(obj, 14, LV_PART_MAIN);
+    lv_obj_t* buttonLabel = lv_label_create(obj);
+    lv_label_set_text(buttonLabel, std::to_string(i + 1).c_str());
+    lv_obj_center(buttonLabel);
+  }
+}
+
+static void notify_tab_before_delete_guiTest(void) {
+  // nothing to persist
+}
+
+// what the gui showed before the test
+struct guiTestState {
+  t_gui_list mainGuiList;
+  GUIlists guiList;
+  std::string guiName;
+  int lastActiveGUIlistIndex;
+};
+
+// shows a test gui, with all tabs created anew
+static guiTestState guiTest_begin(int gui_list_index) {
+  guiTestState saved = {main_gui_list, gui_memoryOptimizer_getActiveGUIlist(), gui_memoryOptimizer_getActiveGUIname(), get_lastActiveGUIlistIndex()};
+  main_gui_list = guiTestList;
+  guis_doTabCreationForSpecificGUI(MAIN_GUI_LIST, gui_list_index);
+  selfTest_runMainLoop(GUI_TEST_SETTLE_MS);
+  return saved;
+}
+
+static void guiTest_end(const guiTestState &saved) {
+  main_gui_list = saved.mainGuiList;
+  gui_list guiList = get_gui_list_withFallback(saved.guiList);
+  int gui_list_index = 0;
+  for (int i = 0; i < (int)guiList->size(); i++) {
+    if (guiList->at(i) == saved.guiName) {
+      gui_list_index = i;
+      break;
+    }
+  }
+  guis_doTabCreationForSpecificGUI(saved.guiList, gui_list_index);
+  set_lastActiveGUIlistIndex(saved.lastActiveGUIlistIndex);
+  selfTest_runMainLoop(GUI_TEST_SETTLE_MS);
+}
+
+// Swipes to the next or previous gui and waits until the tabs were recycled or recreated. Returns false if the tab did not change.
+static bool guiTest_swipe(bool toNext, tabSlideMetrics *metrics) {
+  tabSlideMetrics before;
+  gui_memoryOptimizer_getSlideMetrics(&before);
+  int16_t y = tabviewTop + tabviewHeight / 2;
+  if (toNext) {
+    selfTest_swipe(200, y, 40, y, GUI_TEST_SWIPE_MS);
+  } else {
+    selfTest_swipe(40, y, 200, y, GUI_TEST_SWIPE_MS);
+  }
+  unsigned long start = millis();
+  do {
+    selfTest_runMainLoop(1);
+    gui_memoryOptimizer_getSlideMetrics(metrics);
+  } while ((metrics->slides == before.slides) && (millis() - start < GUI_TEST_SWIPE_TIMEOUT_MS));
+  return metrics->slides == before.slides + 1;
+}
+
+static uint32_t lvglMemoryUsed(void) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+// --- swipes -----------------------------------------------------------------
+// Swipes along the whole test gui list and back, through the touch input of the headless simulator.
+// After every swipe, the tabs still needed are kept and only the newly exposed neighbour is created (recycleTabsAfterSliding()).
+// Checked is that every swipe arrives at the next gui and that never more than the tab window is in memory.
+// Logged are the time to recycle or recreate the tabs after each swipe, and the memory used by lvgl.
+// lv_mem_monitor() only has the high-water mark since startup. So the memory used is also sampled after every swipe.
+struct guiSwipeResult {
+  int swipes;
+  uint32_t recycled;
+  unsigned long min_us;
+  unsigned long max_us;
+  unsigned long sum_us;
+  uint32_t usedBefore;
+  uint32_t usedPeak;
+};
+
+// starts on the first test gui, with all tabs created anew, so that a tab window size just set is used from the first swipe on
+static void guiTest_swipeAlongList(guiSwipeResult *result) {
+  guis_doTabCreationForSpecificGUI(MAIN_GUI_LIST, 0);
+  selfTest_runMainLoop(GUI_TEST_SETTLE_MS);
+  uint8_t tabWindowSize = gui_memoryOptimizer_getTabWindowSize();
+  tabSlideMetrics metricsBefore;
+  gui_memoryOptimizer_getSlideMetrics(&metricsBefore);
+  tabSlideMetrics metrics = metricsBefore;
+  *result = {0, 0, ULONG_MAX, 0, 0, lvglMemoryUsed(), 0};
+  result->usedPeak = result->usedBefore;
+
+  // to the last gui and back to the first one
+  for (int i = 1; i < 2 * GUI_TEST_PAGES - 1; i++) {
+    bool toNext = (i < GUI_TEST_PAGES);
+    int expectedIndex = toNext ? i : 2 * (GUI_TEST_PAGES - 1) - i;
+    if (!SELFTEST_CHECK(guiTest_swipe(toNext, &metrics))) {
+      break;
+    }
+    result->swipes++;
+    SELFTEST_CHECK(gui_memoryOptimizer_isGUIshown(MAIN_GUI_LIST, expectedIndex));
+    if (tabWindowSize != GUI_TAB_WINDOW_WHOLE_LIST) {
+      SELFTEST_CHECK(!gui_memoryOptimizer_isTabIDInMemory(tabWindowSize));
+    }
+    if (metrics.last_us < result->min_us) {result->min_us = metrics.last_us;}
+    if (metrics.last_us > result->max_us) {result->max_us = metrics.last_us;}
+    result->sum_us += metrics.last_us;
+    uint32_t used = lvglMemoryUsed();
+    if (used > result->usedPeak) {result->usedPeak = used;}
+  }
+  result->recycled = metrics.recycled - metricsBefore.recycled;
+}
+
+static void selfTest_guiSwipes(void) {
+  uint8_t tabWindowSize = gui_memoryOptimizer_getTabWindowSize();
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  uint32_t maxUsedBefore = mon.max_used;
+  guiSwipeResult result;
+  guiTestState saved = guiTest_begin(0);
+  guiTest_swipeAlongList(&result);
+  guiTest_end(saved);
+  // only at both ends of the list the window shrinks, then all tabs are recreated
+  SELFTEST_CHECK(result.recycled > 0);
+  lv_mem_monitor(&mon);
+
+  omote_log_i("selfTest:   %d swipes over %d guis, tab window %u, %u of them recycled the tabs\r\n", result.swipes, GUI_TEST_PAGES, tabWindowSize, result.recycled);
+  if (result.swipes > 0) {
+    omote_log_i("selfTest:   tabs after a swipe: min %lu us, avg %lu us, max %lu us\r\n", result.min_us, result.sum_us / result.swipes, result.max_us);
+  }
+  omote_log_i("selfTest:   lvgl memory used %lu bytes before, %lu bytes at most after a swipe, high-water mark %lu -> %lu of %lu bytes\r\n",
+    (unsigned long)result.usedBefore, (unsigned long)result.usedPeak, (unsigned long)maxUsedBefore, (unsigned long)mon.max_used, (unsigned long)mon.total_size);
+}
+
+// --- tab window sizes -------------------------------------------------------
+// The same swipes as in "guiSwipes", once for each tab window size, to compare the time needed after a swipe and the memory used by lvgl.
+// See chooseTabWindowSize() for the default. The size set before the test is restored afterwards.
+// lvgl cannot recover from running out of memory. So the whole list is skipped if the memory per tab, estimated from the sizes 3 and 5, does not fit.
+static const uint8_t guiTestTabWindowSizes[] = {3, 5, GUI_TAB_WINDOW_WHOLE_LIST};
+
+static void selfTest_guiTabWindowSizes(void) {
+  uint8_t tabWindowSizeBefore = gui_memoryOptimizer_getTabWindowSize();
+  guiSwipeResult results[sizeof(guiTestTabWindowSizes)] = {};
+  guiTestState saved = guiTest_begin(0);
+  for (size_t i = 0; i < sizeof(guiTestTabWindowSizes); i++) {
+    if ((guiTestTabWindowSizes[i] == GUI_TAB_WINDOW_WHOLE_LIST) && (i >= 2)) {
+      uint32_t bytesPerTab = (results[i-1].usedPeak > results[i-2].usedPeak) ? (results[i-1].usedPeak - results[i-2].usedPeak) / 2 : 0;
+      lv_mem_monitor_t mon;
+      lv_mem_monitor(&mon);
+      uint32_t needed = bytesPerTab * GUI_TEST_PAGES;
+      if (needed + needed / 4 > mon.free_size) {
+        omote_log_w("selfTest:   all %d guis need about %lu bytes of lvgl memory, only %lu are free. Skipping the whole list.\r\n",
+          GUI_TEST_PAGES, (unsigned long)needed, (unsigned long)mon.free_size);
+        continue;
+      }
+    }
+    SELFTEST_CHECK(gui_memoryOptimizer_setTabWindowSize(guiTestTabWindowSizes[i]));
+    guiTest_swipeAlongList(&results[i]);
+    SELFTEST_CHECK(results[i].swipes == 2 * (GUI_TEST_PAGES - 1));
+  }
+  // before the navigation back, so that it uses the size again
+  gui_memoryOptimizer_setTabWindowSize(tabWindowSizeBefore);
+  guiTest_end(saved);
+
+  omote_log_i("selfTest:   %d swipes over %d guis per tab window size\r\n", 2 * (GUI_TEST_PAGES - 1), GUI_TEST_PAGES);
+  omote_log_i("selfTest:   window  recycled  avg us  max us  lvgl bytes before  at most\r\n");
+  for (size_t i = 0; i < sizeof(guiTestTabWindowSizes); i++) {
+    const guiSwipeResult &result = results[i];
+    if (result.swipes == 0) {
+      omote_log_i("selfTest:   %6u  skipped\r\n", guiTestTabWindowSizes[i]);
+      continue;
+    }
+    omote_log_i("selfTest:   %6u  %8u  %6lu  %6lu  %17lu  %7lu\r\n", guiTestTabWindowSizes[i], result.recycled,
+      result.sum_us / result.swipes, result.max_us, (unsigned long)result.usedBefore, (unsigned long)result.usedPeak);
+  }
+}
+
+// --- snapshot cache ---------------------------------------------------------
+// The swipes of "guiSwipes", once with the widgets on the neighbour tabs and once with images of them (GUI_SNAPSHOT_NEIGHBOUR_TABS).
+// Logged are the time after a swipe, and the frame times of the last FRAME_STATISTICS_WINDOW frames of the swipes from get_frameStatistics().
+// With images, also how many are in the cache and the bytes per image. Without, the cache has to be empty.
+static void selfTest_guiSnapshotCache(void) {
+  bool snapshotsBefore = gui_memoryOptimizer_getSnapshotNeighbourTabs();
+  if (!gui_memoryOptimizer_setSnapshotNeighbourTabs(snapshotsBefore)) {
+    omote_log_w("selfTest:   images of the neighbour tabs are not compiled in, needs -D GUI_SNAPSHOT_NEIGHBOUR_TABS=1\r\n");
+    return;
+  }
+  guiTestState saved = guiTest_begin(0);
+  for (int withImages = 0; withImages <= 1; withImages++) {
+    gui_memoryOptimizer_setSnapshotNeighbourTabs(withImages == 1);
+    guiSwipeResult result;
+    guiTest_swipeAlongList(&result);
+    frameStatistics statistics = get_frameStatistics();
+    tabSnapshotCacheInfo cache;
+    gui_memoryOptimizer_getSnapshotCacheInfo(&cache);
+    if (withImages == 1) {
+      SELFTEST_CHECK(cache.images > 0);
+      SELFTEST_CHECK(cache.images <= cache.maxImages);
+    } else {
+      SELFTEST_CHECK(cache.images == 0);
+    }
+
+    omote_log_i("selfTest:   %s: %d swipes, tabs after a swipe avg %lu us, max %lu us\r\n", (withImages == 1) ? "images" : "widgets",
+      result.swipes, (result.swipes > 0) ? result.sum_us / result.swipes : 0UL, result.max_us);
+    omote_log_i("selfTest:   last %u frames: lv_timer_handler avg %lu us, p99 %lu us, max %lu us, render avg %lu us\r\n", statistics.samples,
+      (unsigned long)statistics.timerHandler_us.avg, (unsigned long)statistics.timerHandler_us.p99, (unsigned long)statistics.timerHandler_us.max,
+      (unsigned long)statistics.render_us.avg);
+    if (cache.images > 0) {
+      omote_log_i("selfTest:   cache has %lu of at most %lu images, %lu bytes, %lu bytes per image\r\n",
+        (unsigned long)cache.images, (unsigned long)cache.maxImages, (unsigned long)cache.bytes, (unsigned long)(cache.bytes / cache.images));
+    }
+  }
+  // before the navigation back, so that it uses the setting again
+  gui_memoryOptimizer_setSnapshotNeighbourTabs(snapshotsBefore);
+  guiTest_end(saved);
+}
+
+// --- page indicator ---------------------------------------------------------
+// After a swipe inside the gui list, the page indicator keeps its objects and only its colors, labels and click actions are changed
+// (updatePanelWithPageIndicator_strategyTabWindow()). Apart from it, only the newly exposed neighbour tab has to be created.
+// lvgl has no hook for the creation of objects, so the objects on the screen are counted before and after each swipe, and the objects of the new tab.
+// All test guis look the same, so the screen has as many objects after the swipe as before if nothing but the new tab was created.
+// The area invalidated by a swipe is the sum of the pixels flushed to the display, reported by the lvgl HAL (get_lastFrameTiming()).
+#define GUI_TEST_INDICATOR_SWIPES 3
+
+static uint32_t countObjects(lv_obj_t* obj) {
+  uint32_t count = 1;
+  for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+    count += countObjects(lv_obj_get_child(obj, i));
+  }
+  return count;
+}
+
+static lv_obj_t* findTabview(void) {
+  lv_obj_t* screen = lv_scr_act();
+  for (uint32_t i = 0; i < lv_obj_get_child_cnt(screen); i++) {
+    lv_obj_t* child = lv_obj_get_child(screen, i);
+    if (lv_obj_check_type(child, &lv_tabview_class)) {
+      return child;
+    }
+  }
+  return NULL;
+}
+
+static void selfTest_guiPageIndicator(void) {
+  uint8_t tabWindowSize = gui_memoryOptimizer_getTabWindowSize();
+  // start with a full tab window, so that the layout of the page indicator does not change
+  int neighbours = (tabWindowSize == GUI_TAB_WINDOW_WHOLE_LIST) ? 0 : tabWindowSize / 2;
+  guiTestState saved = guiTest_begin(neighbours);
+  lv_obj_t* screen = lv_scr_act();
+  uint32_t screenPixels = SCR_WIDTH * SCR_HEIGHT;
+
+  for (int i = 1; i <= GUI_TEST_INDICATOR_SWIPES; i++) {
+    int index = neighbours + i;
+    // a larger tab window set at build time may not fit into the test gui list
+    bool windowIsFull = (index + neighbours <= GUI_TEST_PAGES - 1);
+    tabSlideMetrics metricsBefore;
+    gui_memoryOptimizer_getSlideMetrics(&metricsBefore);
+    uint32_t objectsBefore = countObjects(screen);
+    lvglFrameTiming frameBefore = get_lastFrameTiming();
+    tabSlideMetrics metrics;
+    if (!SELFTEST_CHECK(guiTest_swipe(true, &metrics))) {
+      break;
+    }
+    selfTest_runMainLoop(GUI_TEST_SETTLE_MS);
+    lvglFrameTiming frameAfter = get_lastFrameTiming();
+    uint32_t objectsAfter = countObjects(screen);
+    SELFTEST_CHECK(gui_memoryOptimizer_isGUIshown(MAIN_GUI_LIST, index));
+
+    // the newly exposed neighbour is the last tab of the window. With the whole list in memory, no tab is created.
+    uint32_t objectsCreated = 0;
+    lv_obj_t* tabview = findTabview();
+    if (SELFTEST_CHECK(tabview != NULL) && (neighbours > 0)) {
+      lv_obj_t* content = lv_tabview_get_content(tabview);
+      objectsCreated = countObjects(lv_obj_get_child(content, lv_obj_get_child_cnt(content) - 1));
+    }
+    if (windowIsFull) {
+      SELFTEST_CHECK(metrics.recycled == metricsBefore.recycled + 1);
+      SELFTEST_CHECK(metrics.pageIndicatorsCreated == metricsBefore.pageIndicatorsCreated);
+      SELFTEST_CHECK(objectsAfter == objectsBefore);
+    }
+    uint32_t pixels = frameAfter.pixelsTotal - frameBefore.pixelsTotal;
+    omote_log_i("selfTest:   swipe to gui %d: %lu objects on the screen before, %lu after, %lu created for the new tab, page indicator %s\r\n",
+      index, (unsigned long)objectsBefore, (unsigned long)objectsAfter, (unsigned long)objectsCreated,
+      (metrics.pageIndicatorsCreated == metricsBefore.pageIndicatorsCreated) ? "updated in place" : "created anew");
+    omote_log_i("selfTest:   %lu frames, %lu pixels invalidated (%lu.%02lu screens)\r\n",
+      (unsigned long)(frameAfter.frameCount - frameBefore.frameCount), (unsigned long)pixels,
+      (unsigned long)(pixels / screenPixels), (unsigned long)(pixels % screenPixels * 100 / screenPixels));
+  }
+  guiTest_end(saved);
+}
+
+void register_selfTests_gui(void) {
+  // register_gui() adds every gui to main_gui_list, but the test guis are only shown while a test runs
+  t_gui_list mainGuiList = main_gui_list;
+  for (int i = 1; i <= GUI_TEST_PAGES; i++) {
+    std::string name = "Test " + std::to_string(i);
+    register_gui(name, &create_tab_content_guiTest, &notify_tab_before_delete_guiTest);
+    guiTestList.push_back(name);
+  }
+  main_gui_list = mainGuiList;
+  register_selfTest("guiSwipes", &selfTest_guiSwipes);
+  register_selfTest("guiPageIndicator", &selfTest_guiPageIndicator);
+  register_selfTest("guiTabWindowSizes", &selfTest_guiTabWindowSizes);
+  register_selfTest("guiSnapshotCache", &selfTest_guiSnapshotCache);
+}
+
+#endif
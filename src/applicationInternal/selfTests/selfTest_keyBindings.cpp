@@ -0,0 +1,88 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include <string>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/gui/guiMemoryOptimizer.h"
+#include "applicationInternal/scenes/sceneRegistry.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+#include "scenes/scene_TV.h"
+#include "scenes/scene_allOff.h"
+
+// Benchmark of get_keyBinding() against the lookups it replaced. Before, each key event called get_key_repeatMode(), get_command_short()
+// and get_command_long(), which search the maps of the active gui, the active scene and the defaults by name.
+// Now the bindings of all keys are resolved once after the scene or gui changed, and a key event only indexes an array of 128 entries.
+// The times are only logged, like in "commandTable". Checked is that both give the same bindings, and that the index is rebuilt after a scene switch.
+#define KEY_BINDINGS_BENCHMARK_LOOKUPS 100000
+
+static void selfTest_keyBindings(void) {
+  std::string sceneBefore = gui_memoryOptimizer_getActiveSceneName();
+  std::string sceneName = sceneBefore;
+
+  // the index gives the same bindings as the lookups by name
+  for (int i = 0; i < keyCount; i++) {
+    char keyChar = *allKeys[i];
+    const keyBinding &binding = get_keyBinding(keyChar);
+    SELFTEST_CHECK(binding.repeatMode == get_key_repeatMode(sceneName, keyChar));
+    SELFTEST_CHECK(binding.command_short == get_command_short(sceneName, keyChar));
+    SELFTEST_CHECK(binding.command_long == get_command_long(sceneName, keyChar));
+  }
+  // an unknown key
+  SELFTEST_CHECK(get_keyBinding('#').repeatMode == REPEAT_MODE_UNKNOWN);
+  SELFTEST_CHECK(get_keyBinding('#').command_short == COMMAND_UNKNOWN);
+
+  // lookups. The sums keep the compiler from removing the loops.
+  uint32_t namesSum = 0;
+  unsigned long start = micros();
+  for (int i = 0; i < KEY_BINDINGS_BENCHMARK_LOOKUPS; i++) {
+    char keyChar = *allKeys[i % keyCount];
+    namesSum += get_key_repeatMode(sceneName, keyChar) + get_command_short(sceneName, keyChar) + get_command_long(sceneName, keyChar);
+  }
+  unsigned long names_us = micros() - start;
+  uint32_t indexSum = 0;
+  uint32_t allocationsBefore = selfTest_getAllocationCount();
+  start = micros();
+  for (int i = 0; i < KEY_BINDINGS_BENCHMARK_LOOKUPS; i++) {
+    const keyBinding &binding = get_keyBinding(*allKeys[i % keyCount]);
+    indexSum += binding.repeatMode + binding.command_short + binding.command_long;
+  }
+  unsigned long index_us = micros() - start;
+  SELFTEST_CHECK(selfTest_getAllocationCount() == allocationsBefore);
+  SELFTEST_CHECK(indexSum == namesSum);
+
+  // one rebuild, done by the first lookup after the index was invalidated
+  invalidate_keyBindings();
+  start = micros();
+  get_keyBinding(KEY_OK);
+  unsigned long rebuild_us = micros() - start;
+
+  omote_log_i("selfTest:   %u lookups of %u keys in scene \"%s\" (checksum %lu)\r\n",
+    KEY_BINDINGS_BENCHMARK_LOOKUPS, keyCount, sceneName.c_str(), (unsigned long)indexSum);
+  omote_log_i("selfTest:   by name %7.1f ns, index %7.1f ns per lookup, rebuild of the index %lu us\r\n",
+    names_us * 1000.0 / KEY_BINDINGS_BENCHMARK_LOOKUPS, index_us * 1000.0 / KEY_BINDINGS_BENCHMARK_LOOKUPS, rebuild_us);
+
+  // A scene switch invalidates the index. Needed is a key which is bound differently in two scenes.
+  char keyChar = 0;
+  for (int i = 0; i < keyCount; i++) {
+    if (get_command_short(scene_name_TV, *allKeys[i]) != get_command_short(scene_name_allOff, *allKeys[i])) {
+      keyChar = *allKeys[i];
+      break;
+    }
+  }
+  if (SELFTEST_CHECK(keyChar != 0)) {
+    gui_memoryOptimizer_setActiveSceneName(scene_name_TV);
+    SELFTEST_CHECK(get_keyBinding(keyChar).command_short == get_command_short(scene_name_TV, keyChar));
+    gui_memoryOptimizer_setActiveSceneName(scene_name_allOff);
+    SELFTEST_CHECK(get_keyBinding(keyChar).command_short == get_command_short(scene_name_allOff, keyChar));
+    gui_memoryOptimizer_setActiveSceneName(scene_name_TV);
+    SELFTEST_CHECK(get_keyBinding(keyChar).command_short == get_command_short(scene_name_TV, keyChar));
+  }
+  gui_memoryOptimizer_setActiveSceneName(sceneBefore);
+}
+
+void register_selfTests_keyBindings(void) {
+  register_selfTest("keyBindings", &selfTest_keyBindings);
+}
+
+#endif
@@ -0,0 +1,166 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include <atomic>
+#include <string>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/keys.h"
+#include "applicationInternal/gui/guiMemoryOptimizer.h"
+#include "applicationInternal/scenes/sceneRegistry.h"
+#include "applicationInternal/wakeLatency.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+
+// --- wakeup key -------------------------------------------------------------
+// Wakeup from deep sleep by a key: the key that woke up the remote has to be executed, and as early as possible.
+// Needs two runs of the simulator with the same OMOTE_RTC_MEMORY_FILE, the second one with OMOTE_WAKEUP_KEY=+. See runTests.sh.
+// '+' is KEY_VOLUP, which is YAMAHA_VOL_PLUS in the default scene. Not included in "selftest all".
+#define WAKEUP_KEY_TEST_DATA 0x5EA158A7
+
+static void selfTest_wakeupKey(void) {
+  SELFTEST_CHECK(get_wakeupFromDeepSleep());
+  sentIRcode sent;
+  get_lastSentIRcode(&sent);
+  // the key was pressed and released once, so exactly one IR code
+  SELFTEST_CHECK(sent.count == 1);
+  SELFTEST_CHECK(sent.protocol == IR_PROTOCOL_NEC);
+  SELFTEST_CHECK(sent.data == WAKEUP_KEY_TEST_DATA);
+
+  // millis() starts with the application, so these are the times after the wakeup
+  SELFTEST_CHECK(get_wakeToFirstCommand_ms() != WAKE_LATENCY_NOT_YET);
+  SELFTEST_CHECK(sent.firstSent_ms != UINT32_MAX);
+  SELFTEST_CHECK(sent.firstSent_ms >= get_wakeToFirstCommand_ms());
+  omote_log_i("selfTest:   wake to first frame %lu ms, to first command %lu ms, to IR code sent %lu ms\r\n",
+    (unsigned long)get_wakeToFirstFrame_ms(), (unsigned long)get_wakeToFirstCommand_ms(), (unsigned long)sent.firstSent_ms);
+}
+
+// --- keypad FIFO ------------------------------------------------------------
+// Key events go through the stand-in for the event FIFO of the TCA8418, as clicks on the keypad window do, into the FIFO of getKeypadEvent().
+// More events than fit into the FIFO are announced at once, and the test reads the FIFO itself, without keypad_loop(). So no key is processed.
+// They have to come out in the order they were captured and with the time they were captured. The ones that do not fit are dropped and counted.
+#define KEYPAD_FIFO_TEST_EVENTS (KEYPAD_EVENT_FIFO_SIZE + 4)
+
+static void selfTest_keypadFIFO(void) {
+  keypadEvent event;
+  // e.g. left over from the script
+  while (getKeypadEvent(&event)) {}
+  uint32_t droppedBefore = get_keypadEventsDropped();
+
+  // a press and a release of one key after the other, 1 ms apart
+  unsigned long capturedAt = millis() - KEYPAD_FIFO_TEST_EVENTS;
+  for (int i = 0; i < KEYPAD_FIFO_TEST_EVENTS; i++) {
+    SELFTEST_CHECK(push_keypadEvent(*allKeys[i / 2], (i % 2) == 0, capturedAt + i));
+  }
+  #if (ENABLE_TASK_SPLIT == 1)
+  // The input task reads the hardware. Only read the FIFO after it has read all events, otherwise more of them would fit.
+  unsigned long start = millis();
+  while ((get_keypadEventsDropped() - droppedBefore < KEYPAD_FIFO_TEST_EVENTS - KEYPAD_EVENT_FIFO_SIZE) && (millis() - start < 1000)) {
+    delay(1);
+  }
+  #endif
+
+  int count = 0;
+  while (getKeypadEvent(&event)) {
+    if (count < KEYPAD_EVENT_FIFO_SIZE) {
+      SELFTEST_CHECK(event.keyChar == *allKeys[count / 2]);
+      SELFTEST_CHECK(event.rawKeyState == (((count % 2) == 0) ? PRESSED_RAW : RELEASED_RAW));
+      // the stand-in converts the time to millis() of the time it was read, which can be 1 ms later than its own clock
+      SELFTEST_CHECK((capturedAt + count) - event.timestamp <= 1);
+    }
+    count++;
+  }
+  SELFTEST_CHECK(count == KEYPAD_EVENT_FIFO_SIZE);
+  SELFTEST_CHECK(get_keypadEventsDropped() - droppedBefore == KEYPAD_FIFO_TEST_EVENTS - KEYPAD_EVENT_FIFO_SIZE);
+  omote_log_i("selfTest:   %u events announced, %d read from the FIFO, %u dropped\r\n",
+    KEYPAD_FIFO_TEST_EVENTS, count, get_keypadEventsDropped() - droppedBefore);
+}
+
+// --- key hold ---------------------------------------------------------------
+// HOLD is detected from the time a key was captured, not from the time its event is processed.
+// A key press captured longer ago than KEY_HOLD_TIME (500 ms, keys.cpp) is a long press, even if press and release are processed right after another.
+// Needed is a SHORTorLONG key with a short and a long command, in any scene. It is activated without its start sequence.
+#define KEY_HOLD_TEST_HELD_MS 600
+// time for keypad_loop() to process the events, one per pass
+#define KEY_HOLD_TEST_PROCESSING_MS 200
+
+static uint16_t keyHold_commandShort;
+static uint16_t keyHold_commandLong;
+static std::atomic<uint32_t> keyHold_shortExecuted(0);
+static std::atomic<uint32_t> keyHold_longExecuted(0);
+
+static void keyHold_executed(uint16_t command, const std::string &additionalPayload) {
+  if (command == keyHold_commandShort) {
+    keyHold_shortExecuted++;
+  } else if (command == keyHold_commandLong) {
+    keyHold_longExecuted++;
+  }
+}
+
+static bool keyHold_findKey(std::string *sceneName, char *keyChar) {
+  for (auto const &scene : registered_scenes) {
+    for (uint8_t i = 0; i < keyCount; i++) {
+      uint16_t commandShort = get_command_short(scene.first, *allKeys[i]);
+      uint16_t commandLong = get_command_long(scene.first, *allKeys[i]);
+      if ((get_key_repeatMode(scene.first, *allKeys[i]) == SHORTorLONG) && (commandShort != commandLong) &&
+          (get_commandData(commandShort) != NULL) && (get_commandData(commandLong) != NULL)) {
+        *sceneName = scene.first;
+        *keyChar = *allKeys[i];
+        keyHold_commandShort = commandShort;
+        keyHold_commandLong = commandLong;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// presses and releases the key, captured heldFor_ms apart, and lets keypad_loop() process both events and the worker execute the command
+static void keyHold_press(char keyChar, unsigned long heldFor_ms) {
+  // a key is not sent again within repeatRate (125 ms, keys.cpp) of its last command
+  selfTest_runMainLoop(KEY_HOLD_TEST_PROCESSING_MS);
+  unsigned long releasedAt = millis();
+  SELFTEST_CHECK(push_keypadEvent(keyChar, true, releasedAt - heldFor_ms));
+  SELFTEST_CHECK(push_keypadEvent(keyChar, false, releasedAt));
+  selfTest_runMainLoop(KEY_HOLD_TEST_PROCESSING_MS);
+  commandQueueMetrics metrics;
+  unsigned long start = millis();
+  do {
+    selfTest_runMainLoop(1);
+    get_commandQueueMetrics(&metrics);
+  } while ((metrics.depth > 0) && (millis() - start < 1000));
+}
+
+static void selfTest_keyHold(void) {
+  std::string sceneName;
+  char keyChar;
+  if (!SELFTEST_CHECK(keyHold_findKey(&sceneName, &keyChar))) {
+    return;
+  }
+  std::string sceneBefore = gui_memoryOptimizer_getActiveSceneName();
+  gui_memoryOptimizer_setActiveSceneName(sceneName);
+  keyHold_shortExecuted = 0;
+  keyHold_longExecuted = 0;
+  set_commandExecuted_cb(&keyHold_executed);
+
+  // short press
+  keyHold_press(keyChar, 0);
+  SELFTEST_CHECK(keyHold_shortExecuted == 1);
+  SELFTEST_CHECK(keyHold_longExecuted == 0);
+  // captured as long press, processed right away
+  keyHold_press(keyChar, KEY_HOLD_TEST_HELD_MS);
+  SELFTEST_CHECK(keyHold_shortExecuted == 1);
+  SELFTEST_CHECK(keyHold_longExecuted == 1);
+
+  set_commandExecuted_cb(NULL);
+  gui_memoryOptimizer_setActiveSceneName(sceneBefore);
+  omote_log_i("selfTest:   key '%c' of scene \"%s\": %u short and %u long commands executed\r\n",
+    keyChar, sceneName.c_str(), (uint32_t)keyHold_shortExecuted, (uint32_t)keyHold_longExecuted);
+}
+
+void register_selfTests_keys(void) {
+  register_selfTest("wakeupKey", &selfTest_wakeupKey, false);
+  register_selfTest("keypadFIFO", &selfTest_keypadFIFO);
+  register_selfTest("keyHold", &selfTest_keyHold);
+}
+
+#endif
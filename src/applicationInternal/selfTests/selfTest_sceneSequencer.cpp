@@ -0,0 +1,80 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/scenes/sceneSequencer.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+#include "scenes/scene_TV.h"
+
+// --- responsiveness -----------------------------------------------------------
+// A full activation of the TV scene: four IR codes with 5 s of waits in between. When the sequence used delay(), the main loop was blocked for the whole time.
+// Now the main loop has to keep running. Measured is the longest time between the start of two passes of the scheduler, which is how long a key press
+// or a frame would have to wait at most. The test runs the main loop like loop() does, but with delay(1) instead of idle().
+#define SCENE_RESPONSIVENESS_TIMEOUT_MS 10000
+// With the virtual clock, only a delay() in the main loop lets time pass between two passes, so the gap does not depend on the host.
+// Far below the waits of the sequence. Sending an IR code in the worker takes about 70 ms on the ESP32, in the simulator no time at all.
+#define SCENE_RESPONSIVENESS_MAX_GAP_MS 50
+// With the real clock, the gap depends on the load of the host and is much longer under ThreadSanitizer. It is logged, and only checked against
+// a bound below the shortest wait of the sequence (500 ms), so that a sequence blocking the main loop is still found.
+#define SCENE_RESPONSIVENESS_MAX_REAL_GAP_MS 400
+
+static void selfTest_sceneResponsiveness(void) {
+  sentIRcode sent;
+  get_lastSentIRcode(&sent);
+  uint32_t irSentBefore = sent.count;
+  commandQueueMetrics metrics;
+
+  // forced, so that the start sequence runs even if the scene is already active
+  executeCommand(SCENE_TV_FORCE);
+  SELFTEST_CHECK(sceneSequencer_isRunning());
+
+  unsigned long start = millis();
+  unsigned long lastPass_ms = start;
+  unsigned long maxGap_ms = 0;
+  unsigned long lastPass_us = micros();
+  unsigned long maxGap_us = 0;
+  unsigned long maxPass_us = 0;
+  uint32_t passes = 0;
+  do {
+    unsigned long passStart_ms = millis();
+    if (passStart_ms - lastPass_ms > maxGap_ms) {
+      maxGap_ms = passStart_ms - lastPass_ms;
+    }
+    lastPass_ms = passStart_ms;
+    unsigned long passStart_us = micros();
+    if (passStart_us - lastPass_us > maxGap_us) {
+      maxGap_us = passStart_us - lastPass_us;
+    }
+    lastPass_us = passStart_us;
+    scheduler_loop();
+    if (micros() - passStart_us > maxPass_us) {
+      maxPass_us = micros() - passStart_us;
+    }
+    passes++;
+    delay(1);
+    get_commandQueueMetrics(&metrics);
+  } while ((sceneSequencer_isRunning() || (metrics.depth > 0)) && (millis() - start < SCENE_RESPONSIVENESS_TIMEOUT_MS));
+  unsigned long sequence_ms = millis() - start;
+
+  get_lastSentIRcode(&sent);
+  SELFTEST_CHECK(!sceneSequencer_isRunning());
+  SELFTEST_CHECK(sent.count - irSentBefore == 4);
+  // the waits of scene_start_sequence_TV()
+  SELFTEST_CHECK(sequence_ms >= 500 + 1500 + 3000);
+  if (clock_isVirtual()) {
+    SELFTEST_CHECK(maxGap_ms <= SCENE_RESPONSIVENESS_MAX_GAP_MS);
+  } else {
+    SELFTEST_CHECK(maxGap_ms < SCENE_RESPONSIVENESS_MAX_REAL_GAP_MS);
+  }
+  omote_log_i("selfTest:   TV scene activation took %lu ms, %u passes of the main loop. Longest time between two passes %lu ms (%s clock)\r\n",
+    sequence_ms, passes, maxGap_ms, clock_isVirtual() ? "virtual" : "real");
+  omote_log_i("selfTest:   on the host: longest pass %lu us, longest time between two passes %lu us\r\n", maxPass_us, maxGap_us);
+}
+
+void register_selfTests_sceneSequencer(void) {
+  register_selfTest("sceneResponsiveness", &selfTest_sceneResponsiveness);
+}
+
+#endif
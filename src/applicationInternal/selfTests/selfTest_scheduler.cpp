@@ -0,0 +1,138 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include <limits.h>
+#include <string.h>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+
+// --- periods ----------------------------------------------------------------
+// The periodic tasks of loop() have to run exactly every period. The test runs the main loop like selfTest_runMainLoop() does and notes the
+// time of every run. With the virtual clock, time only passes with the delay(1) between two passes, so every run has to come exactly one period
+// after the one before, and the number of runs is known in advance. With the real clock, the host can delay a pass at any time, so only
+// the lower bound is checked: a task never runs before its period has passed. Then the intervals are only logged.
+#define SCHEDULER_PERIODS_TEST_MS 3000
+
+struct periodicTask {
+  const char *name;
+  uint32_t period_ms;
+};
+// see register_loopTasks() in main.cpp
+static const periodicTask periodicTasks[] = {
+  {"activity", 100},
+  {"status",   1000}
+};
+#define PERIODIC_TASK_COUNT (sizeof(periodicTasks) / sizeof(periodicTasks[0]))
+
+struct periodicTaskRuns {
+  uint8_t taskId;
+  uint32_t runsBefore;
+  uint32_t runs;
+  unsigned long lastRun_ms;
+  unsigned long minInterval_ms;
+  unsigned long maxInterval_ms;
+};
+
+static uint8_t findTask(const char *name) {
+  for (uint8_t i = 0; i < scheduler_getTaskCount(); i++) {
+    if (strcmp(scheduler_getTaskStatistics(i).name, name) == 0) {
+      return i;
+    }
+  }
+  return UINT8_MAX;
+}
+
+static void selfTest_schedulerPeriods(void) {
+  periodicTaskRuns taskRuns[PERIODIC_TASK_COUNT];
+  for (size_t i = 0; i < PERIODIC_TASK_COUNT; i++) {
+    taskRuns[i] = {findTask(periodicTasks[i].name), 0, 0, 0, ULONG_MAX, 0};
+    if (!SELFTEST_CHECK(taskRuns[i].taskId != UINT8_MAX)) {
+      return;
+    }
+    taskRuns[i].runsBefore = scheduler_getTaskStatistics(taskRuns[i].taskId).runs;
+    taskRuns[i].runs = taskRuns[i].runsBefore;
+  }
+
+  // the first run seen only starts the intervals
+  bool seenRun[PERIODIC_TASK_COUNT] = {};
+  unsigned long start = millis();
+  do {
+    unsigned long now = millis();
+    scheduler_loop();
+    for (size_t i = 0; i < PERIODIC_TASK_COUNT; i++) {
+      uint32_t runs = scheduler_getTaskStatistics(taskRuns[i].taskId).runs;
+      if (runs == taskRuns[i].runs) {
+        continue;
+      }
+      SELFTEST_CHECK(runs == taskRuns[i].runs + 1);
+      taskRuns[i].runs = runs;
+      if (seenRun[i]) {
+        unsigned long interval = now - taskRuns[i].lastRun_ms;
+        if (interval < taskRuns[i].minInterval_ms) {taskRuns[i].minInterval_ms = interval;}
+        if (interval > taskRuns[i].maxInterval_ms) {taskRuns[i].maxInterval_ms = interval;}
+      }
+      seenRun[i] = true;
+      taskRuns[i].lastRun_ms = now;
+    }
+    delay(1);
+  } while (millis() - start < SCHEDULER_PERIODS_TEST_MS);
+
+  for (size_t i = 0; i < PERIODIC_TASK_COUNT; i++) {
+    const periodicTaskRuns &r = taskRuns[i];
+    if (!SELFTEST_CHECK(r.maxInterval_ms > 0)) {
+      continue;
+    }
+    SELFTEST_CHECK(r.minInterval_ms >= periodicTasks[i].period_ms);
+    if (clock_isVirtual()) {
+      // one pass per ms, and the test time is a multiple of the periods
+      SELFTEST_CHECK(r.runs - r.runsBefore == SCHEDULER_PERIODS_TEST_MS / periodicTasks[i].period_ms);
+      SELFTEST_CHECK(r.minInterval_ms == periodicTasks[i].period_ms);
+      SELFTEST_CHECK(r.maxInterval_ms == periodicTasks[i].period_ms);
+    }
+    omote_log_i("selfTest:   %-8s period %4lu ms, %lu runs in %u ms, every %lu to %lu ms (%s clock)\r\n", periodicTasks[i].name,
+      (unsigned long)periodicTasks[i].period_ms, (unsigned long)(r.runs - r.runsBefore), SCHEDULER_PERIODS_TEST_MS,
+      r.minInterval_ms, r.maxInterval_ms, clock_isVirtual() ? "virtual" : "real");
+  }
+}
+
+// --- idle -------------------------------------------------------------------
+// When nothing is due, loop() has to sleep in idle() until the next task is due, instead of spinning. The test runs the main loop like loop() does,
+// with idle() instead of delay(1), and checks the share of the time idle() slept, and that there was not more than one pass per ms.
+// Only with the real clock: with the virtual clock, the simulator does not sleep at all, see clock_idle_HAL().
+#define IDLE_TEST_MS 2000
+// Rendering the frames and the few tasks due in between leave most of the time to sleep, also under ThreadSanitizer
+#define IDLE_TEST_MIN_SLEEP_PERCENT 50
+
+static void selfTest_idleSleeps(void) {
+  if (clock_isVirtual()) {
+    omote_log_i("selfTest:   skipped, the simulator does not sleep with the virtual clock\r\n");
+    return;
+  }
+  // e.g. the frames after the previous test
+  selfTest_runMainLoop(500);
+
+  uint64_t sleptBefore_us = get_idleSleepTime_us();
+  unsigned long start_us = micros();
+  unsigned long start = millis();
+  uint32_t passes = 0;
+  do {
+    idle(scheduler_loop());
+    passes++;
+  } while (millis() - start < IDLE_TEST_MS);
+  unsigned long elapsed_us = micros() - start_us;
+  uint64_t slept_us = get_idleSleepTime_us() - sleptBefore_us;
+  uint32_t sleptPercent = slept_us * 100 / elapsed_us;
+
+  SELFTEST_CHECK(sleptPercent >= IDLE_TEST_MIN_SLEEP_PERCENT);
+  SELFTEST_CHECK(passes <= IDLE_TEST_MS);
+  omote_log_i("selfTest:   %lu passes of the main loop in %lu ms, slept %lu%% of the time\r\n",
+    (unsigned long)passes, elapsed_us / 1000, (unsigned long)sleptPercent);
+}
+
+void register_selfTests_scheduler(void) {
+  register_selfTest("schedulerPeriods", &selfTest_schedulerPeriods);
+  register_selfTest("idleSleeps", &selfTest_idleSleeps);
+}
+
+#endif
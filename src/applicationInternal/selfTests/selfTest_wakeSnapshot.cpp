@@ -0,0 +1,68 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/gui/guiMemoryOptimizer.h"
+#include "applicationInternal/wakeSnapshot.h"
+#include "applicationInternal/wakeLatency.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+#include "guis/gui_settings.h"
+#include "scenes/scene_TV.h"
+
+// Round trip of the snapshot through the simulated RTC memory. It spans two runs of the simulator, both with the same OMOTE_RTC_MEMORY_FILE:
+// the first run sets the state below and ends, which saves the snapshot as if going to deep sleep. The second run starts as after a wakeup
+// and has to come up with the same state. The simulator does not keep its preferences from one run to the next, so they can only come from the snapshot.
+// See runTests.sh. None of these tests is included in "selftest all".
+#define WAKE_SNAPSHOT_TEST_SLEEP_TIMEOUT       600000
+#define WAKE_SNAPSHOT_TEST_MOTION_THRESHOLD    42
+#define WAKE_SNAPSHOT_TEST_BACKLIGHT           123
+
+// first run, after a reset: set the state that the next run has to find again
+static void selfTest_wakeSnapshotSave(void) {
+  SELFTEST_CHECK(!get_wakeupFromDeepSleep());
+  SELFTEST_CHECK(!wakeSnapshot_wasRestored());
+  set_activeScene(scene_name_TV);
+  set_activeGUIname(tabName_settings);
+  set_activeGUIlist(MAIN_GUI_LIST);
+  set_wakeupByIMUEnabled(false);
+  set_sleepTimeout(WAKE_SNAPSHOT_TEST_SLEEP_TIMEOUT);
+  set_motionThreshold(WAKE_SNAPSHOT_TEST_MOTION_THRESHOLD);
+  set_backlightBrightness(WAKE_SNAPSHOT_TEST_BACKLIGHT);
+}
+
+// second run: everything comes from the snapshot, and the first screen is the one of the first run
+static void selfTest_wakeSnapshotRestored(void) {
+  SELFTEST_CHECK(get_wakeupFromDeepSleep());
+  SELFTEST_CHECK(wakeSnapshot_wasRestored());
+  SELFTEST_CHECK(get_activeScene() == scene_name_TV);
+  // set again by the GUI when it has created the tabs, so this is the GUI that is shown
+  SELFTEST_CHECK(get_activeGUIname() == tabName_settings);
+  SELFTEST_CHECK(get_activeGUIlist() == MAIN_GUI_LIST);
+  SELFTEST_CHECK(get_wakeupByIMUEnabled() == false);
+  SELFTEST_CHECK(get_sleepTimeout() == WAKE_SNAPSHOT_TEST_SLEEP_TIMEOUT);
+  SELFTEST_CHECK(get_motionThreshold() == WAKE_SNAPSHOT_TEST_MOTION_THRESHOLD);
+  SELFTEST_CHECK(get_backlightBrightness() == WAKE_SNAPSHOT_TEST_BACKLIGHT);
+
+  SELFTEST_CHECK(get_wakeToFirstFrame_ms() != WAKE_LATENCY_NOT_YET);
+  if (get_wakeToFirstCommand_ms() == WAKE_LATENCY_NOT_YET) {
+    omote_log_i("selfTest:   wake to first frame %lu ms, no command yet\r\n", (unsigned long)get_wakeToFirstFrame_ms());
+  } else {
+    omote_log_i("selfTest:   wake to first frame %lu ms, to first command %lu ms\r\n", (unsigned long)get_wakeToFirstFrame_ms(), (unsigned long)get_wakeToFirstCommand_ms());
+  }
+}
+
+// second run, but with a damaged snapshot: it is not used, the settings come from the preferences as after a reset
+static void selfTest_wakeSnapshotInvalid(void) {
+  SELFTEST_CHECK(get_wakeupFromDeepSleep());
+  SELFTEST_CHECK(!wakeSnapshot_wasRestored());
+  SELFTEST_CHECK(get_sleepTimeout() != WAKE_SNAPSHOT_TEST_SLEEP_TIMEOUT);
+  SELFTEST_CHECK(get_motionThreshold() != WAKE_SNAPSHOT_TEST_MOTION_THRESHOLD);
+}
+
+void register_selfTests_wakeSnapshot(void) {
+  register_selfTest("wakeSnapshotSave",     &selfTest_wakeSnapshotSave,     false);
+  register_selfTest("wakeSnapshotRestored", &selfTest_wakeSnapshotRestored, false);
+  register_selfTest("wakeSnapshotInvalid",  &selfTest_wakeSnapshotInvalid,  false);
+}
+
+#endif
@@ -0,0 +1,136 @@
+#if (ENABLE_SELFTESTS == 1)
+
+#if (SIMULATOR_HEADLESS != 1)
+  // the tests are started by the script of the headless simulator
+  #error "ENABLE_SELFTESTS=1 needs SIMULATOR_HEADLESS=1"
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <vector>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/scheduler.h"
+#include "applicationInternal/selfTests/selfTests.h"
+#include "applicationInternal/omote_log.h"
+
+struct selfTest {
+  const char *name;
+  tSelfTest test;
+  bool includedInAll;
+};
+static std::vector<selfTest> selfTests;
+static int failedChecks = 0;
+
+void register_selfTest(const char *name, tSelfTest test, bool includedInAll) {
+  selfTests.push_back(selfTest{name, test, includedInAll});
+}
+
+bool selfTest_check(bool ok, const char *expression, const char *file, int line) {
+  if (!ok) {
+    failedChecks++;
+    omote_log_e("selfTest: check failed: %s (%s:%d)\r\n", expression, file, line);
+  }
+  return ok;
+}
+
+// Replaces the global operator new and delete of the whole program, so that tests can check that something does not allocate.
+static std::atomic<uint32_t> allocationCount(0);
+static std::atomic<uint32_t> allocatedBytes(0);
+
+static void *countedAllocation(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  return malloc(size == 0 ? 1 : size);
+}
+void *operator new(size_t size) {
+  void *p = countedAllocation(size);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return countedAllocation(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return countedAllocation(size);
+}
+void operator delete(void *p) noexcept {
+  free(p);
+}
+void operator delete[](void *p) noexcept {
+  free(p);
+}
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  free(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  free(p);
+}
+
+uint32_t selfTest_getAllocationCount(void) {
+  return allocationCount.load(std::memory_order_relaxed);
+}
+uint32_t selfTest_getAllocatedBytes(void) {
+  return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void selfTest_runMainLoop(uint32_t ms) {
+  unsigned long start = millis();
+  do {
+    scheduler_loop();
+    delay(1);
+  } while (millis() - start < ms);
+}
+
+void selfTest_swipe(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t ms) {
+  unsigned long start = millis();
+  unsigned long elapsed;
+  while ((elapsed = millis() - start) < ms) {
+    set_touchPoint(x1 + (x2 - x1) * (int32_t)elapsed / (int32_t)ms, y1 + (y2 - y1) * (int32_t)elapsed / (int32_t)ms, true);
+    scheduler_loop();
+    delay(1);
+  }
+  set_touchPoint(x2, y2, false);
+}
+
+// called by the headless simulator for the script command "selftest"
+static int runSelfTests(const char *name) {
+  bool all = (strcmp(name, "all") == 0);
+  bool found = false;
+  int failedBefore = failedChecks;
+  for (auto const &t : selfTests) {
+    if (all ? !t.includedInAll : (strcmp(name, t.name) != 0)) {
+      continue;
+    }
+    found = true;
+    int failedBeforeTest = failedChecks;
+    omote_log_i("selfTest: %s started\r\n", t.name);
+    t.test();
+    omote_log_i("selfTest: %s %s\r\n", t.name, (failedChecks == failedBeforeTest) ? "passed" : "FAILED");
+  }
+  if (!found) {
+    return -1;
+  }
+  return failedChecks - failedBefore;
+}
+
+void register_selfTests(void) {
+  register_selfTests_commandHandler();
+  register_selfTests_commandRegistration();
+  register_selfTests_sceneSequencer();
+  register_selfTests_backlight();
+  register_selfTests_wakeSnapshot();
+  register_selfTests_keys();
+  register_selfTests_keyBindings();
+  register_selfTests_gui();
+  register_selfTests_scheduler();
+  set_runSelfTest_cb(&runSelfTests);
+}
+
+#endif
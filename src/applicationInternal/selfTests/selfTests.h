@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+// Self tests, only in the headless simulator (build flag ENABLE_SELFTESTS=1, see env:linux_64bit_selftest in platformio.ini).
+// They run inside the complete application, with the HAL of the simulator. The headless script starts them with "selftest <name>" or "selftest all",
+// see hardware/windows_linux/headless/headless.h. hardware/windows_linux/headless/tests/runTests.sh runs all of them.
+// A test is a function with checks. Every failed check is logged with file and line and counts as failure of the script.
+// Tests run on the main thread, between two loop(). If a test needs the main loop, e.g. until queued commands are executed, it calls selfTest_runMainLoop().
+#if (ENABLE_SELFTESTS == 1)
+
+typedef void (*tSelfTest)(void);
+// called by main(), before init_commandQueue(), because tests can register commands of their own
+void register_selfTests(void);
+// Tests that need a script of their own, e.g. because they span two runs of the simulator, are registered with includedInAll = false.
+// "selftest all" skips them, they only run by their name.
+void register_selfTest(const char *name, tSelfTest test, bool includedInAll = true);
+
+// returns ok, so that a test can stop after a failed check
+bool selfTest_check(bool ok, const char *expression, const char *file, int line);
+#define SELFTEST_CHECK(expression) selfTest_check((expression), #expression, __FILE__, __LINE__)
+// runs the tasks of the main loop for ms milliseconds
+void selfTest_runMainLoop(uint32_t ms);
+// Swipes with one finger from x1,y1 to x2,y2 within ms milliseconds, like the script command "swipe", and runs the main loop meanwhile.
+// When the finger is lifted, lvgl usually continues the swipe with an animation. Run the main loop until it is done.
+void selfTest_swipe(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t ms);
+// Number of heap allocations done with operator new so far, on all threads. Counted by the replaced global operator new of the self test build.
+// malloc() is not counted. lvgl has a memory pool of its own in the simulator (LV_MEM_CUSTOM=0), so its objects are not counted either.
+uint32_t selfTest_getAllocationCount(void);
+// Bytes requested from operator new so far, on all threads. What is freed again is not subtracted.
+uint32_t selfTest_getAllocatedBytes(void);
+
+// the tests of each module, in selfTest_<module>.cpp
+void register_selfTests_commandHandler(void);
+void register_selfTests_commandRegistration(void);
+void register_selfTests_sceneSequencer(void);
+void register_selfTests_backlight(void);
+void register_selfTests_wakeSnapshot(void);
+void register_selfTests_keys(void);
+void register_selfTests_keyBindings(void);
+void register_selfTests_gui(void);
+void register_selfTests_scheduler(void);
+
+#endif
@@ -0,0 +1,258 @@
+#if (ENABLE_TASK_SPLIT == 1)
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/commandHandler.h"
+#include "applicationInternal/keys.h"
+#include "applicationInternal/taskSplit.h"
+#include "applicationInternal/omote_log.h"
+
+// Enough for the TCA8418 over I2C and the Keypad library, including logging with printf
+#define INPUT_TASK_STACK_SIZE        4096
+// WiFi, mqtt and the initialization of NimBLE
+#define CONNECTIVITY_TASK_STACK_SIZE 8192
+// The loopTask runs with priority 1. Higher, so that the input task is not delayed by lvgl on the same core.
+#define INPUT_TASK_CORE              1
+#define INPUT_TASK_PRIORITY          2
+#define CONNECTIVITY_TASK_CORE       0
+#define CONNECTIVITY_TASK_PRIORITY   1
+// same as the mqtt task of the scheduler without task split
+#define MQTT_LOOP_PERIOD_MS          10
+// how often BLE and WiFi status are cached when there is no mqtt loop. The GUI shows them once per second.
+#define CONNECTIVITY_STATUS_PERIOD_MS 250
+// the gui task is loop() itself, it is always task 0
+#define GUI_TASK_ID                  0
+
+// Bounded queue between tasks. Any number of producers (e.g. the WiFi event task and the connectivity task), one consumer.
+// Producers never block on a full queue, the message is dropped instead.
+template <typename T, uint8_t SIZE>
+class boundedQueue {
+public:
+  bool push(const T &item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == SIZE) {
+      dropped++;
+      return false;
+    }
+    items[(head + count) % SIZE] = item;
+    count++;
+    if (count > maxDepth) {
+      maxDepth = count;
+    }
+    return true;
+  }
+  bool pop(T *item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) {
+      return false;
+    }
+    *item = items[head];
+    head = (head + 1) % SIZE;
+    count--;
+    return true;
+  }
+  void getMetrics(uint8_t *aDepth, uint8_t *aMaxDepth, uint32_t *aDropped) {
+    std::lock_guard<std::mutex> lock(mutex);
+    *aDepth = count;
+    *aMaxDepth = maxDepth;
+    *aDropped = dropped;
+  }
+private:
+  std::mutex mutex;
+  T items[SIZE];
+  uint8_t head = 0;
+  uint8_t count = 0;
+  uint8_t maxDepth = 0;
+  uint32_t dropped = 0;
+};
+
+// to the gui task
+enum guiMessageTypes {BLE_MESSAGE, WIFI_CONNECTED, MQTT_MESSAGE};
+struct guiMessage {
+  guiMessageTypes type;
+  bool connected;
+  std::string topic;
+  std::string payload;
+};
+static boundedQueue<guiMessage, TASK_SPLIT_QUEUE_SIZE> guiQueue;
+// to the connectivity task
+static boundedQueue<tConnectivityCall, TASK_SPLIT_QUEUE_SIZE> connectivityQueue;
+
+static uint8_t keypadTaskId = UINT8_MAX;
+static uint8_t guiMessagesTaskId = UINT8_MAX;
+static uint8_t connectivityTaskId = UINT8_MAX;
+static tSchedulerTask thisConnectivityInit = NULL;
+static tSchedulerNextDeadline thisConnectivityInit_timeTillNext = NULL;
+
+// --- gui task ---------------------------------------------------------------
+static void postToGUI(const guiMessage &message) {
+  if (!guiQueue.push(message)) {
+    omote_log_w("taskSplit: queue to gui is full, message is dropped\r\n");
+    return;
+  }
+  scheduler_wakeTask(guiMessagesTaskId);
+  wake_task(GUI_TASK_ID);
+}
+
+void taskSplit_receiveBLEmessage_cb(std::string message) {
+  postToGUI(guiMessage{BLE_MESSAGE, false, "", message});
+}
+void taskSplit_receiveWiFiConnected_cb(bool connected) {
+  postToGUI(guiMessage{WIFI_CONNECTED, connected, "", ""});
+}
+void taskSplit_receiveMQTTmessage_cb(std::string topic, std::string payload) {
+  postToGUI(guiMessage{MQTT_MESSAGE, false, topic, payload});
+}
+
+// scheduler task of the gui task, runs when it was woken by postToGUI()
+static void guiMessages_task() {
+  guiMessage message;
+  while (guiQueue.pop(&message)) {
+    switch (message.type) {
+      #if (ENABLE_KEYBOARD_BLE == 1)
+      case BLE_MESSAGE: {
+        receiveBLEmessage_cb(message.payload);
+        break;
+      }
+      #endif
+      #if (ENABLE_WIFI_AND_MQTT == 1)
+      case WIFI_CONNECTED: {
+        receiveWiFiConnected_cb(message.connected);
+        break;
+      }
+      case MQTT_MESSAGE: {
+        receiveMQTTmessage_cb(message.topic, message.payload);
+        break;
+      }
+      #endif
+      default: {
+        break;
+      }
+    }
+  }
+}
+
+// --- input task -------------------------------------------------------------
+static uint32_t inputTask_loop() {
+  if (keypad_pollHardware()) {
+    scheduler_wakeTask(keypadTaskId);
+    wake_task(GUI_TASK_ID);
+  }
+  return KEYPAD_POLL_PERIOD_MS;
+}
+
+// --- connectivity task ------------------------------------------------------
+bool taskSplit_runOnConnectivityTask(const tConnectivityCall &call) {
+  if (!connectivityQueue.push(call)) {
+    return false;
+  }
+  wake_task(connectivityTaskId);
+  return true;
+}
+
+// shared by the waiting task and the call, which outlives the wait if it times out
+struct connectivityCallDone {
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool done = false;
+};
+
+bool taskSplit_runOnConnectivityTaskAndWait(const tConnectivityCall &call, uint32_t timeout_ms) {
+  std::shared_ptr<connectivityCallDone> callDone = std::make_shared<connectivityCallDone>();
+  bool queued = taskSplit_runOnConnectivityTask([call, callDone]() {
+    call();
+    std::lock_guard<std::mutex> lock(callDone->mutex);
+    callDone->done = true;
+    callDone->condition.notify_one();
+  });
+  if (!queued) {
+    omote_log_w("taskSplit: queue to connectivity is full, call is dropped\r\n");
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(callDone->mutex);
+  if (!callDone->condition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&callDone]() {return callDone->done;})) {
+    omote_log_w("taskSplit: connectivity task did not answer within %lu ms\r\n", (unsigned long)timeout_ms);
+    return false;
+  }
+  return true;
+}
+
+bool taskSplit_publishMQTTMessage(const char *topic, const char *payload) {
+  std::string topicCopy = topic;
+  std::string payloadCopy = payload;
+  if (!taskSplit_runOnConnectivityTask([topicCopy, payloadCopy]() {publishMQTTMessage_now(topicCopy.c_str(), payloadCopy.c_str());})) {
+    omote_log_w("taskSplit: queue to connectivity is full, mqtt message to %s is dropped\r\n", topic);
+    return false;
+  }
+  return true;
+}
+
+static uint32_t connectivityTask_loop() {
+  // queued calls wait until BLE and WiFi are initialized
+  if (thisConnectivityInit_timeTillNext() == 0) {
+    thisConnectivityInit();
+    return 0;
+  }
+  tConnectivityCall call;
+  while (connectivityQueue.pop(&call)) {
+    call();
+  }
+  update_connectivityStatus();
+  #if (ENABLE_WIFI_AND_MQTT == 1)
+  mqtt_loop();
+  return MQTT_LOOP_PERIOD_MS;
+  #else
+  return CONNECTIVITY_STATUS_PERIOD_MS;
+  #endif
+}
+
+void start_taskSplit(uint8_t aKeypadTaskId, tSchedulerTask connectivityInit, tSchedulerNextDeadline connectivityInit_timeTillNext) {
+  keypadTaskId = aKeypadTaskId;
+  thisConnectivityInit = connectivityInit;
+  thisConnectivityInit_timeTillNext = connectivityInit_timeTillNext;
+  guiMessagesTaskId = scheduler_addTask("messages", &guiMessages_task, SCHEDULER_NO_PERIOD);
+  start_task("input", &inputTask_loop, INPUT_TASK_STACK_SIZE, INPUT_TASK_CORE, INPUT_TASK_PRIORITY);
+  connectivityTaskId = start_task("connectivity", &connectivityTask_loop, CONNECTIVITY_TASK_STACK_SIZE, CONNECTIVITY_TASK_CORE, CONNECTIVITY_TASK_PRIORITY);
+}
+
+// --- statistics -------------------------------------------------------------
+#if defined(SHOW_TASK_STATISTICS_ON_SERIAL)
+#define TASK_SPLIT_MAX_TASKS 4
+struct taskTimes {
+  uint64_t awakeTime_us;
+  uint64_t lifeTime_us;
+};
+static taskTimes lastTaskTimes[TASK_SPLIT_MAX_TASKS];
+static unsigned long updateSerialLogTimer = 0;
+#endif
+
+void doLogTaskStatistics(void) {
+  #if defined(SHOW_TASK_STATISTICS_ON_SERIAL)
+  if (millis() - updateSerialLogTimer < 10000) {
+    return;
+  }
+  updateSerialLogTimer = millis();
+
+  for (uint8_t i = 0; (i < get_taskCount()) && (i < TASK_SPLIT_MAX_TASKS); i++) {
+    taskStatistics statistics = get_taskStatistics(i);
+    // load since the last log
+    uint64_t awake_us = statistics.awakeTime_us - lastTaskTimes[i].awakeTime_us;
+    uint64_t interval_us = statistics.lifeTime_us - lastTaskTimes[i].lifeTime_us;
+    lastTaskTimes[i] = taskTimes{statistics.awakeTime_us, statistics.lifeTime_us};
+    omote_log_d("taskSplit: %-12s core %2d, load %5.1f%%, stack never used %5lu bytes\r\n",
+      statistics.name, statistics.core, (interval_us > 0) ? (float)awake_us * 100 / interval_us : 0.0f, (unsigned long)statistics.stackHighWaterMark);
+  }
+  uint8_t depth;
+  uint8_t maxDepth;
+  uint32_t dropped;
+  guiQueue.getMetrics(&depth, &maxDepth, &dropped);
+  omote_log_d("taskSplit: queue to gui          depth %u, max depth %u, dropped %lu\r\n", depth, maxDepth, (unsigned long)dropped);
+  connectivityQueue.getMetrics(&depth, &maxDepth, &dropped);
+  omote_log_d("taskSplit: queue to connectivity depth %u, max depth %u, dropped %lu\r\n", depth, maxDepth, (unsigned long)dropped);
+  #endif
+}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <functional>
+#include "applicationInternal/scheduler.h"
+
+// activate log of the task statistics on serial output, every 10 s
+//#define SHOW_TASK_STATISTICS_ON_SERIAL
+
+// Optional split of the main loop into tasks (ENABLE_TASK_SPLIT=1). Without it, everything runs in loop() as before.
+//   gui           loop() itself, with the scheduler. Owns lvgl and the state of the application: keys are processed, commands are executed and scenes and GUIs are changed only here.
+//                 The IR receiver stays here, because it is switched on and off by the GUI.
+//   input         scans the keypad hardware every KEYPAD_POLL_PERIOD_MS and puts the events into the keypad event FIFO of the hardwarePresenter
+//   connectivity  owns WiFi, mqtt and the BLE keyboard. Does the deferred initialization (BLE keyboard, WiFi), services the mqtt client and is the only task
+//                 that calls the HAL of BLE and WiFi. The hardwarePresenter queues these calls for it, no matter if they come from the gui task or from the command worker.
+//                 Calls queued before the deferred initialization has finished wait for it. BLE and WiFi status are read by this task and cached for the others.
+// IR commands are sent by the command worker, which is a task of its own anyway.
+// The tasks only talk through bounded queues. Whatever arrives from WiFi, mqtt or BLE is queued for the gui task, which shows it.
+// Before deep sleep, the HAL stops the input and the connectivity task, before it shuts down the radios.
+// ESP32: gui is the loopTask on core 1. input runs on core 1 as well, but with a higher priority, so that keys are scanned while lvgl renders. connectivity runs on core 0, next to the radio.
+// Light sleep is not used, the loopTask blocks until the next deadline or until another task wakes it up.
+// Simulator: the same tasks as threads. env:linux_64bit_selftest_tsan runs the self tests with them under ThreadSanitizer.
+#define TASK_SPLIT_QUEUE_SIZE 16
+
+// called by register_loopTasks(), after all tasks of the scheduler were added.
+// keypadTaskId: the scheduler task that processes the keypad events. connectivityInit: called by the connectivity task as long as connectivityInit_timeTillNext returns 0.
+void start_taskSplit(uint8_t keypadTaskId, tSchedulerTask connectivityInit, tSchedulerNextDeadline connectivityInit_timeTillNext);
+
+// used as callbacks from hardware instead of the ones in commandHandler.h. Can be called from any task, the message is handled by the gui task.
+void taskSplit_receiveBLEmessage_cb(std::string message);
+void taskSplit_receiveWiFiConnected_cb(bool connected);
+void taskSplit_receiveMQTTmessage_cb(std::string topic, std::string payload);
+// used by publishMQTTMessage(). Only queues the message for the connectivity task. Returns false if the queue is full.
+bool taskSplit_publishMQTTMessage(const char *topic, const char *payload);
+// Used by the hardwarePresenter for the calls of the BLE and WiFi HAL. Queues the call for the connectivity task. Returns false if the queue is full.
+typedef std::function<void(void)> tConnectivityCall;
+bool taskSplit_runOnConnectivityTask(const tConnectivityCall &call);
+// Same, but waits until the call was done, at most timeout_ms. For calls that return a value. Returns false if the call was not done in time.
+// A call that timed out is still done later, so it must not use anything of the caller's stack. Never call it from the connectivity task itself.
+bool taskSplit_runOnConnectivityTaskAndWait(const tConnectivityCall &call, uint32_t timeout_ms);
+
+// called every second
+void doLogTaskStatistics(void);
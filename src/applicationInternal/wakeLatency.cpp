@@ -0,0 +1,37 @@
+#include <atomic>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/wakeLatency.h"
+#include "applicationInternal/omote_log.h"
+
+static uint32_t wakeToFirstFrame_ms = WAKE_LATENCY_NOT_YET;
+static std::atomic<uint32_t> wakeToFirstCommand_ms(WAKE_LATENCY_NOT_YET);
+
+static const char *wakeLatency_startReason() {
+  return get_wakeupFromDeepSleep() ? "wakeup" : "power on";
+}
+
+void wakeLatency_frameRendered(void) {
+  if (wakeToFirstFrame_ms != WAKE_LATENCY_NOT_YET) {
+    return;
+  }
+  if (get_lastFrameTiming().frameCount == 0) {
+    return;
+  }
+  wakeToFirstFrame_ms = millis();
+  omote_log_i("wakeLatency: first frame %lu ms after %s\r\n", (unsigned long)wakeToFirstFrame_ms, wakeLatency_startReason());
+}
+
+void wakeLatency_commandExecuted(void) {
+  uint32_t notYet = WAKE_LATENCY_NOT_YET;
+  uint32_t now = millis();
+  if (wakeToFirstCommand_ms.compare_exchange_strong(notYet, now)) {
+    omote_log_i("wakeLatency: first command %lu ms after %s\r\n", (unsigned long)now, wakeLatency_startReason());
+  }
+}
+
+uint32_t get_wakeToFirstFrame_ms(void) {
+  return wakeToFirstFrame_ms;
+}
+uint32_t get_wakeToFirstCommand_ms(void) {
+  return wakeToFirstCommand_ms;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// How long the remote needs after power on or wakeup from deep sleep until
+//   - the first frame is on the display
+//   - the first command is executed, e.g. the IR code of the key that woke up the remote
+// Both are logged once, with omote_log_i. Times are ms of millis(), which starts with the application. The bootloader before is not included.
+#define WAKE_LATENCY_NOT_YET UINT32_MAX
+
+// called by gui_loop()
+void wakeLatency_frameRendered(void);
+// called when a command is executed. Can be called from the command worker.
+void wakeLatency_commandExecuted(void);
+uint32_t get_wakeToFirstFrame_ms(void);
+uint32_t get_wakeToFirstCommand_ms(void);
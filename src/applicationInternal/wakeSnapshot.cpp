@@ -0,0 +1,126 @@
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include "applicationInternal/hardware/hardwarePresenter.h"
+#include "applicationInternal/wakeSnapshot.h"
+#include "applicationInternal/omote_log.h"
+
+// "OMWS". RTC memory is zero after power on, so a snapshot without this is not valid.
+#define WAKE_SNAPSHOT_MAGIC   0x4F4D5753
+// increase when wakeSnapshot changes. A snapshot of an older firmware is then ignored.
+#define WAKE_SNAPSHOT_VERSION 1
+#define WAKE_SNAPSHOT_MAX_NAME_LENGTH 32
+
+// everything init_preferences() would read from the NVS
+struct wakeSnapshot {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  char activeScene[WAKE_SNAPSHOT_MAX_NAME_LENGTH];
+  char activeGUIname[WAKE_SNAPSHOT_MAX_NAME_LENGTH];
+  int8_t activeGUIlist;
+  int16_t lastActiveGUIlistIndex;
+  bool wakeupByIMUEnabled;
+  uint32_t sleepTimeout;
+  uint8_t motionThreshold;
+  uint8_t backlightBrightness;
+  uint8_t keyboardBrightness;
+  // of all bytes before
+  uint32_t crc;
+};
+
+static bool restored = false;
+
+static uint32_t wakeSnapshot_crc32(const uint8_t *data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static bool copyName(char *dest, const std::string &name) {
+  if (name.length() >= WAKE_SNAPSHOT_MAX_NAME_LENGTH) {
+    return false;
+  }
+  strncpy(dest, name.c_str(), WAKE_SNAPSHOT_MAX_NAME_LENGTH);
+  return true;
+}
+
+void wakeSnapshot_save(void) {
+  size_t rtcMemorySize;
+  uint8_t *rtcMemory = get_rtcMemory(&rtcMemorySize);
+  if (sizeof(wakeSnapshot) > rtcMemorySize) {
+    omote_log_e("wakeSnapshot: needs %u bytes, but RTC memory has only %u bytes\r\n", (unsigned int)sizeof(wakeSnapshot), (unsigned int)rtcMemorySize);
+    return;
+  }
+
+  wakeSnapshot snapshot;
+  // also clears the padding, which is part of the crc
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.magic   = WAKE_SNAPSHOT_MAGIC;
+  snapshot.version = WAKE_SNAPSHOT_VERSION;
+  snapshot.size    = sizeof(wakeSnapshot);
+  if (!copyName(snapshot.activeScene, get_activeScene()) || !copyName(snapshot.activeGUIname, get_activeGUIname())) {
+    // the NVS has it anyway
+    omote_log_w("wakeSnapshot: name of scene or GUI too long, next wakeup reads the NVS\r\n");
+    memset(rtcMemory, 0, sizeof(wakeSnapshot));
+    return;
+  }
+  snapshot.activeGUIlist          = get_activeGUIlist();
+  snapshot.lastActiveGUIlistIndex = get_lastActiveGUIlistIndex();
+  snapshot.wakeupByIMUEnabled     = get_wakeupByIMUEnabled();
+  snapshot.sleepTimeout           = get_sleepTimeout();
+  snapshot.motionThreshold        = get_motionThreshold();
+  snapshot.backlightBrightness    = get_backlightBrightness();
+  #if(OMOTE_HARDWARE_REV >= 5)
+  snapshot.keyboardBrightness     = get_keyboardBrightness();
+  #endif
+  snapshot.crc = wakeSnapshot_crc32((const uint8_t *)&snapshot, offsetof(wakeSnapshot, crc));
+
+  memcpy(rtcMemory, &snapshot, sizeof(wakeSnapshot));
+  omote_log_d("wakeSnapshot: saved, GUI %s, scene %s\r\n", snapshot.activeGUIname, snapshot.activeScene);
+}
+
+bool wakeSnapshot_restore(void) {
+  if (!get_wakeupFromDeepSleep()) {
+    return false;
+  }
+  size_t rtcMemorySize;
+  uint8_t *rtcMemory = get_rtcMemory(&rtcMemorySize);
+  if (sizeof(wakeSnapshot) > rtcMemorySize) {
+    return false;
+  }
+  wakeSnapshot snapshot;
+  memcpy(&snapshot, rtcMemory, sizeof(wakeSnapshot));
+  if ((snapshot.magic != WAKE_SNAPSHOT_MAGIC) || (snapshot.version != WAKE_SNAPSHOT_VERSION) || (snapshot.size != sizeof(wakeSnapshot))
+      || (snapshot.crc != wakeSnapshot_crc32((const uint8_t *)&snapshot, offsetof(wakeSnapshot, crc)))) {
+    omote_log_w("wakeSnapshot: no valid snapshot in RTC memory, reading the NVS\r\n");
+    return false;
+  }
+  // terminated by copyName(), but don't trust the memory more than the crc
+  snapshot.activeScene[WAKE_SNAPSHOT_MAX_NAME_LENGTH - 1] = '\0';
+  snapshot.activeGUIname[WAKE_SNAPSHOT_MAX_NAME_LENGTH - 1] = '\0';
+
+  set_activeScene(snapshot.activeScene);
+  set_activeGUIname(snapshot.activeGUIname);
+  set_activeGUIlist(snapshot.activeGUIlist);
+  set_lastActiveGUIlistIndex(snapshot.lastActiveGUIlistIndex);
+  set_wakeupByIMUEnabled(snapshot.wakeupByIMUEnabled);
+  set_sleepTimeout(snapshot.sleepTimeout);
+  set_motionThreshold(snapshot.motionThreshold);
+  set_backlightBrightness(snapshot.backlightBrightness);
+  #if(OMOTE_HARDWARE_REV >= 5)
+  set_keyboardBrightness(snapshot.keyboardBrightness);
+  #endif
+  omote_log_i("wakeSnapshot: restored from RTC memory, GUI %s, scene %s\r\n", snapshot.activeGUIname, snapshot.activeScene);
+  restored = true;
+  return true;
+}
+
+bool wakeSnapshot_wasRestored(void) {
+  return restored;
+}
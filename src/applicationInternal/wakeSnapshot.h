@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fast wakeup from deep sleep.
+// Right before deep sleep, the settings and the state of the GUI are copied into memory that survives deep sleep (RTC slow memory of the ESP32).
+// After wakeup, wakeSnapshot_restore() takes them from there instead of reading the NVS flash, so that the first screen is the right one without waiting for the flash.
+// After a reset or power loss the snapshot is invalid and init_preferences() reads the NVS as before. The NVS is still written before every deep sleep.
+// In the simulator, set OMOTE_RTC_MEMORY_FILE to keep the snapshot from one run to the next.
+
+// is called by the hardware right before deep sleep
+void wakeSnapshot_save(void);
+// returns false if there is no valid snapshot, e.g. after a reset. Then init_preferences() has to be called.
+bool wakeSnapshot_restore(void);
+// true if the settings of this run came from the snapshot
+bool wakeSnapshot_wasRestored(void);
@@ -3,7 +3,7 @@
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "device_yamahaAmp.h"
 
-  // Only activate the commands that are used. Every command takes 100 bytes, wether used or not.
+  // Only activate the commands that are used. Every registered command takes some RAM in the command list, wether used or not.
   uint16_t YAMAHA_INPUT_DVD           ; //"Yamaha_input_dvd";
   uint16_t YAMAHA_INPUT_DTV           ; //"Yamaha_input_dtv";
   // uint16_t YAMAHA_INPUT_VCR           ; //"Yamaha_input_vcr";
@@ -39,38 +39,41 @@
 void register_device_yamahaAmp() {
   // tested with Yamaha RX-V359, works also with others
 
-  // Only activate the commands that are used. Every command takes 100 bytes, wether used or not.
-  register_command(&YAMAHA_INPUT_DVD           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1837C"}));
-  register_command(&YAMAHA_INPUT_DTV           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA12AD5"}));
-  // register_command(&YAMAHA_INPUT_VCR           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1F00F"}));
-  // register_command(&YAMAHA_POWER_TOGGLE        , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1F807"}));
-  // register_command(&YAMAHA_INPUT_CD            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1A857"}));
-  // register_command(&YAMAHA_INPUT_MD            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1936C"}));
-  // register_command(&YAMAHA_INPUT_VAUX          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1AA55"}));
-  // register_command(&YAMAHA_MULTICHANNEL        , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1E11E"}));
-  // register_command(&YAMAHA_INPUT_TUNER         , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA16897"}));
-  // register_command(&YAMAHA_PRESETGROUP         , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA148B7"}));
-  // register_command(&YAMAHA_PRESETSTATION_MINUS , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA18877"}));
-  // register_command(&YAMAHA_PRESETSTATION_PLUS  , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA108F7"}));
-  register_command(&YAMAHA_STANDARD            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA109F6"}));
-  // register_command(&YAMAHA_5CHSTEREO           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1E916"}));
-  // register_command(&YAMAHA_NIGHT               , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1A956"}));
-  // register_command(&YAMAHA_SLEEP               , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1EA15"}));
-  // register_command(&YAMAHA_TEST                , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1A15E"}));
-  // register_command(&YAMAHA_STRAIGHT            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA16A95"}));
-  register_command(&YAMAHA_VOL_MINUS           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1D827"}));
-  register_command(&YAMAHA_VOL_PLUS            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA158A7"}));
-  // register_command(&YAMAHA_PROG_MINUS          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA19A65"}));
-  // register_command(&YAMAHA_PROG_PLUS           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA11AE5"}));
-  register_command(&YAMAHA_MUTE_TOGGLE         , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA138C7"}));
-  // register_command(&YAMAHA_LEVEL               , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1619E"}));
-  // register_command(&YAMAHA_SETMENU             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA139C6"}));
-  // register_command(&YAMAHA_SETMENU_UP          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA119E6"}));
-  // register_command(&YAMAHA_SETMENU_DOWN        , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA19966"}));
-  // register_command(&YAMAHA_SETMENU_MINUS       , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1CA35"}));
-  // register_command(&YAMAHA_SETMENU_PLUS        , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA14AB5"}));
-  register_command(&YAMAHA_POWER_OFF           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA17887"}));
-  register_command(&YAMAHA_POWER_ON            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x5EA1B847"}));
+  // Only activate the commands that are used. The table itself is in flash, but every registered command still takes some RAM in the command list.
+  static const IRcommandTableEntry yamahaAmp_IRcommands[] = {
+    {&YAMAHA_INPUT_DVD           , IR_PROTOCOL_NEC, 0x5EA1837C},
+    {&YAMAHA_INPUT_DTV           , IR_PROTOCOL_NEC, 0x5EA12AD5},
+    // {&YAMAHA_INPUT_VCR           , IR_PROTOCOL_NEC, 0x5EA1F00F},
+    // {&YAMAHA_POWER_TOGGLE        , IR_PROTOCOL_NEC, 0x5EA1F807},
+    // {&YAMAHA_INPUT_CD            , IR_PROTOCOL_NEC, 0x5EA1A857},
+    // {&YAMAHA_INPUT_MD            , IR_PROTOCOL_NEC, 0x5EA1936C},
+    // {&YAMAHA_INPUT_VAUX          , IR_PROTOCOL_NEC, 0x5EA1AA55},
+    // {&YAMAHA_MULTICHANNEL        , IR_PROTOCOL_NEC, 0x5EA1E11E},
+    // {&YAMAHA_INPUT_TUNER         , IR_PROTOCOL_NEC, 0x5EA16897},
+    // {&YAMAHA_PRESETGROUP         , IR_PROTOCOL_NEC, 0x5EA148B7},
+    // {&YAMAHA_PRESETSTATION_MINUS , IR_PROTOCOL_NEC, 0x5EA18877},
+    // {&YAMAHA_PRESETSTATION_PLUS  , IR_PROTOCOL_NEC, 0x5EA108F7},
+    {&YAMAHA_STANDARD            , IR_PROTOCOL_NEC, 0x5EA109F6},
+    // {&YAMAHA_5CHSTEREO           , IR_PROTOCOL_NEC, 0x5EA1E916},
+    // {&YAMAHA_NIGHT               , IR_PROTOCOL_NEC, 0x5EA1A956},
+    // {&YAMAHA_SLEEP               , IR_PROTOCOL_NEC, 0x5EA1EA15},
+    // {&YAMAHA_TEST                , IR_PROTOCOL_NEC, 0x5EA1A15E},
+    // {&YAMAHA_STRAIGHT            , IR_PROTOCOL_NEC, 0x5EA16A95},
+    {&YAMAHA_VOL_MINUS           , IR_PROTOCOL_NEC, 0x5EA1D827},
+    {&YAMAHA_VOL_PLUS            , IR_PROTOCOL_NEC, 0x5EA158A7},
+    // {&YAMAHA_PROG_MINUS          , IR_PROTOCOL_NEC, 0x5EA19A65},
+    // {&YAMAHA_PROG_PLUS           , IR_PROTOCOL_NEC, 0x5EA11AE5},
+    {&YAMAHA_MUTE_TOGGLE         , IR_PROTOCOL_NEC, 0x5EA138C7},
+    // {&YAMAHA_LEVEL               , IR_PROTOCOL_NEC, 0x5EA1619E},
+    // {&YAMAHA_SETMENU             , IR_PROTOCOL_NEC, 0x5EA139C6},
+    // {&YAMAHA_SETMENU_UP          , IR_PROTOCOL_NEC, 0x5EA119E6},
+    // {&YAMAHA_SETMENU_DOWN        , IR_PROTOCOL_NEC, 0x5EA19966},
+    // {&YAMAHA_SETMENU_MINUS       , IR_PROTOCOL_NEC, 0x5EA1CA35},
+    // {&YAMAHA_SETMENU_PLUS        , IR_PROTOCOL_NEC, 0x5EA14AB5},
+    {&YAMAHA_POWER_OFF           , IR_PROTOCOL_NEC, 0x5EA17887},
+    {&YAMAHA_POWER_ON            , IR_PROTOCOL_NEC, 0x5EA1B847},
+  };
+  register_IRcommandTable(yamahaAmp_IRcommands, sizeof(yamahaAmp_IRcommands) / sizeof(yamahaAmp_IRcommands[0]));
 
   // GC seems not to work
   //register_command(&YAMAHA_POWER_TOGGLE       , makeCommandData(IR, {std::to_string(IR_PROTOCOL_GLOBALCACHE), "38000,1,69,341,170,21,21,21,64,21,64,21,64,21,64,21,64,21,64,21,21,21,64,21,21,21,21,21,21,21,21,21,21,21,21,21,64,21,21,21,64,21,21,21,64,21,21,21,64,21,21,21,21,21,64,21,21,21,64,21,21,21,64,21,21,21,64,21,64,21,1517,341,85,21,3655"}));
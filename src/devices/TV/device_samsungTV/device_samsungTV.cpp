@@ -3,7 +3,7 @@
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "device_samsungTV.h"
 
-// Only activate the commands that are used. Every command takes 100 bytes, wether used or not.
+// Only activate the commands that are used. Every registered command takes some RAM in the command list, wether used or not.
 // uint16_t SAMSUNG_POWER_TOGGLE    ; //"Samsung_power_toggle";
 // uint16_t SAMSUNG_SOURCE          ; //"Samsung_source";
 // uint16_t SAMSUNG_HDMI            ; //"Samsung_hdmi";
@@ -67,67 +67,70 @@ void register_device_samsungTV() {
   // both GC and SAMSUNG work well
 
   // https://github.com/natcl/studioimaginaire/blob/master/arduino_remote/ircodes.py
-  // Only activate the commands that are used. Every command takes 100 bytes, wether used or not.
-  // register_command(&SAMSUNG_POWER_TOGGLE      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E040BF"}));
-  // register_command(&SAMSUNG_SOURCE            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0807F"}));
-  // register_command(&SAMSUNG_HDMI              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0D12E"}));
-  register_command(&SAMSUNG_NUM_1             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E020DF"}));
-  register_command(&SAMSUNG_NUM_2             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0A05F"}));
-  register_command(&SAMSUNG_NUM_3             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0609F"}));
-  register_command(&SAMSUNG_NUM_4             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E010EF"}));
-  register_command(&SAMSUNG_NUM_5             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0906F"}));
-  register_command(&SAMSUNG_NUM_6             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E050AF"}));
-  register_command(&SAMSUNG_NUM_7             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E030CF"}));
-  register_command(&SAMSUNG_NUM_8             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0B04F"}));
-  register_command(&SAMSUNG_NUM_9             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0708F"}));
-  register_command(&SAMSUNG_NUM_0             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E08877"}));
-  // register_command(&SAMSUNG_TTXMIX            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E034CB"}));
-  // register_command(&SAMSUNG_PRECH             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0C837"}));
-  // register_command(&SAMSUNG_VOL_MINUS         , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0D02F"}));
-  // register_command(&SAMSUNG_VOL_PLUS          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0E01F"}));
-  // register_command(&SAMSUNG_MUTE_TOGGLE       , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0F00F"}));
-  // register_command(&SAMSUNG_CHLIST            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0D629"}));
-  register_command(&SAMSUNG_CHANNEL_UP        , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E048B7"}));
-  register_command(&SAMSUNG_CHANNEL_DOWN      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E008F7"}));
-  register_command(&SAMSUNG_MENU              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E058A7"}));
-  // register_command(&SAMSUNG_APPS              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E09E61"}));
-  register_command(&SAMSUNG_GUIDE             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0F20D"}));
-  // register_command(&SAMSUNG_TOOLS             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0D22D"}));
-  // register_command(&SAMSUNG_INFO              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0F807"}));
-  register_command(&SAMSUNG_UP                , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E006F9"}));
-  register_command(&SAMSUNG_DOWN              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E08679"}));
-  register_command(&SAMSUNG_LEFT              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0A659"}));
-  register_command(&SAMSUNG_RIGHT             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E046B9"}));
-  register_command(&SAMSUNG_SELECT            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E016E9"}));
-  // register_command(&SAMSUNG_RETURN            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E01AE5"}));
-  register_command(&SAMSUNG_EXIT              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0B44B"}));
-  // register_command(&SAMSUNG_KEY_A             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E036C9"}));
-  // register_command(&SAMSUNG_KEY_B             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E028D7"}));
-  // register_command(&SAMSUNG_KEY_C             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0A857"}));
-  // register_command(&SAMSUNG_KEY_D             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E06897"}));
-  // register_command(&SAMSUNG_FAMILYSTORY       , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0639C"}));
-  // register_command(&SAMSUNG_SEARCH            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0CE31"}));
-  // register_command(&SAMSUNG_DUALI_II          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E000FF"}));
-  // register_command(&SAMSUNG_SUPPORT           , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0FC03"}));
-  // register_command(&SAMSUNG_PSIZE             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E07C83"}));
-  // register_command(&SAMSUNG_ADSUBT            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0A45B"}));
-  register_command(&SAMSUNG_REWIND            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0A25D"}));
-  register_command(&SAMSUNG_PAUSE             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E052AD"}));
-  register_command(&SAMSUNG_FASTFORWARD       , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E012ED"}));
-  // register_command(&SAMSUNG_RECORD            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0926D"}));
-  register_command(&SAMSUNG_PLAY              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0E21D"}));
-  // register_command(&SAMSUNG_STOP              , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0629D"}));
-  register_command(&SAMSUNG_POWER_OFF         , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E019E6"}));
-  register_command(&SAMSUNG_POWER_ON          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E09966"}));
-  register_command(&SAMSUNG_INPUT_HDMI_1      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E09768"}));
-  register_command(&SAMSUNG_INPUT_HDMI_2      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E07D82"}));
-  register_command(&SAMSUNG_INPUT_HDMI_3      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E043BC"}));
-  // register_command(&SAMSUNG_INPUT_HDMI_4      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0A35C"}));
-  // register_command(&SAMSUNG_INPUT_COMPONENT   , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0619E"}));
-  register_command(&SAMSUNG_INPUT_TV          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0D827"}));
-  // unknown commands. Not on my remote
-  // register_command(&-                         , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E0C43B"}));
-  // register_command(&favorite_channel          , makeCommandData(IR, {std::to_string(IR_PROTOCOL_SAMSUNG), "0xE0E022DD"}));
+  // Only activate the commands that are used. The table itself is in flash, but every registered command still takes some RAM in the command list.
+  static const IRcommandTableEntry samsungTV_IRcommands[] = {
+    // {&SAMSUNG_POWER_TOGGLE      , IR_PROTOCOL_SAMSUNG, 0xE0E040BF},
+    // {&SAMSUNG_SOURCE            , IR_PROTOCOL_SAMSUNG, 0xE0E0807F},
+    // {&SAMSUNG_HDMI              , IR_PROTOCOL_SAMSUNG, 0xE0E0D12E},
+    {&SAMSUNG_NUM_1             , IR_PROTOCOL_SAMSUNG, 0xE0E020DF},
+    {&SAMSUNG_NUM_2             , IR_PROTOCOL_SAMSUNG, 0xE0E0A05F},
+    {&SAMSUNG_NUM_3             , IR_PROTOCOL_SAMSUNG, 0xE0E0609F},
+    {&SAMSUNG_NUM_4             , IR_PROTOCOL_SAMSUNG, 0xE0E010EF},
+    {&SAMSUNG_NUM_5             , IR_PROTOCOL_SAMSUNG, 0xE0E0906F},
+    {&SAMSUNG_NUM_6             , IR_PROTOCOL_SAMSUNG, 0xE0E050AF},
+    {&SAMSUNG_NUM_7             , IR_PROTOCOL_SAMSUNG, 0xE0E030CF},
+    {&SAMSUNG_NUM_8             , IR_PROTOCOL_SAMSUNG, 0xE0E0B04F},
+    {&SAMSUNG_NUM_9             , IR_PROTOCOL_SAMSUNG, 0xE0E0708F},
+    {&SAMSUNG_NUM_0             , IR_PROTOCOL_SAMSUNG, 0xE0E08877},
+    // {&SAMSUNG_TTXMIX            , IR_PROTOCOL_SAMSUNG, 0xE0E034CB},
+    // {&SAMSUNG_PRECH             , IR_PROTOCOL_SAMSUNG, 0xE0E0C837},
+    // {&SAMSUNG_VOL_MINUS         , IR_PROTOCOL_SAMSUNG, 0xE0E0D02F},
+    // {&SAMSUNG_VOL_PLUS          , IR_PROTOCOL_SAMSUNG, 0xE0E0E01F},
+    // {&SAMSUNG_MUTE_TOGGLE       , IR_PROTOCOL_SAMSUNG, 0xE0E0F00F},
+    // {&SAMSUNG_CHLIST            , IR_PROTOCOL_SAMSUNG, 0xE0E0D629},
+    {&SAMSUNG_CHANNEL_UP        , IR_PROTOCOL_SAMSUNG, 0xE0E048B7},
+    {&SAMSUNG_CHANNEL_DOWN      , IR_PROTOCOL_SAMSUNG, 0xE0E008F7},
+    {&SAMSUNG_MENU              , IR_PROTOCOL_SAMSUNG, 0xE0E058A7},
+    // {&SAMSUNG_APPS              , IR_PROTOCOL_SAMSUNG, 0xE0E09E61},
+    {&SAMSUNG_GUIDE             , IR_PROTOCOL_SAMSUNG, 0xE0E0F20D},
+    // {&SAMSUNG_TOOLS             , IR_PROTOCOL_SAMSUNG, 0xE0E0D22D},
+    // {&SAMSUNG_INFO              , IR_PROTOCOL_SAMSUNG, 0xE0E0F807},
+    {&SAMSUNG_UP                , IR_PROTOCOL_SAMSUNG, 0xE0E006F9},
+    {&SAMSUNG_DOWN              , IR_PROTOCOL_SAMSUNG, 0xE0E08679},
+    {&SAMSUNG_LEFT              , IR_PROTOCOL_SAMSUNG, 0xE0E0A659},
+    {&SAMSUNG_RIGHT             , IR_PROTOCOL_SAMSUNG, 0xE0E046B9},
+    {&SAMSUNG_SELECT            , IR_PROTOCOL_SAMSUNG, 0xE0E016E9},
+    // {&SAMSUNG_RETURN            , IR_PROTOCOL_SAMSUNG, 0xE0E01AE5},
+    {&SAMSUNG_EXIT              , IR_PROTOCOL_SAMSUNG, 0xE0E0B44B},
+    // {&SAMSUNG_KEY_A             , IR_PROTOCOL_SAMSUNG, 0xE0E036C9},
+    // {&SAMSUNG_KEY_B             , IR_PROTOCOL_SAMSUNG, 0xE0E028D7},
+    // {&SAMSUNG_KEY_C             , IR_PROTOCOL_SAMSUNG, 0xE0E0A857},
+    // {&SAMSUNG_KEY_D             , IR_PROTOCOL_SAMSUNG, 0xE0E06897},
+    // {&SAMSUNG_FAMILYSTORY       , IR_PROTOCOL_SAMSUNG, 0xE0E0639C},
+    // {&SAMSUNG_SEARCH            , IR_PROTOCOL_SAMSUNG, 0xE0E0CE31},
+    // {&SAMSUNG_DUALI_II          , IR_PROTOCOL_SAMSUNG, 0xE0E000FF},
+    // {&SAMSUNG_SUPPORT           , IR_PROTOCOL_SAMSUNG, 0xE0E0FC03},
+    // {&SAMSUNG_PSIZE             , IR_PROTOCOL_SAMSUNG, 0xE0E07C83},
+    // {&SAMSUNG_ADSUBT            , IR_PROTOCOL_SAMSUNG, 0xE0E0A45B},
+    {&SAMSUNG_REWIND            , IR_PROTOCOL_SAMSUNG, 0xE0E0A25D},
+    {&SAMSUNG_PAUSE             , IR_PROTOCOL_SAMSUNG, 0xE0E052AD},
+    {&SAMSUNG_FASTFORWARD       , IR_PROTOCOL_SAMSUNG, 0xE0E012ED},
+    // {&SAMSUNG_RECORD            , IR_PROTOCOL_SAMSUNG, 0xE0E0926D},
+    {&SAMSUNG_PLAY              , IR_PROTOCOL_SAMSUNG, 0xE0E0E21D},
+    // {&SAMSUNG_STOP              , IR_PROTOCOL_SAMSUNG, 0xE0E0629D},
+    {&SAMSUNG_POWER_OFF         , IR_PROTOCOL_SAMSUNG, 0xE0E019E6},
+    {&SAMSUNG_POWER_ON          , IR_PROTOCOL_SAMSUNG, 0xE0E09966},
+    {&SAMSUNG_INPUT_HDMI_1      , IR_PROTOCOL_SAMSUNG, 0xE0E09768},
+    {&SAMSUNG_INPUT_HDMI_2      , IR_PROTOCOL_SAMSUNG, 0xE0E07D82},
+    {&SAMSUNG_INPUT_HDMI_3      , IR_PROTOCOL_SAMSUNG, 0xE0E043BC},
+    // {&SAMSUNG_INPUT_HDMI_4      , IR_PROTOCOL_SAMSUNG, 0xE0E0A35C},
+    // {&SAMSUNG_INPUT_COMPONENT   , IR_PROTOCOL_SAMSUNG, 0xE0E0619E},
+    {&SAMSUNG_INPUT_TV          , IR_PROTOCOL_SAMSUNG, 0xE0E0D827},
+    // unknown commands. Not on my remote
+    // {&-                         , IR_PROTOCOL_SAMSUNG, 0xE0E0C43B},
+    // {&favorite_channel          , IR_PROTOCOL_SAMSUNG, 0xE0E022DD},
+  };
+  register_IRcommandTable(samsungTV_IRcommands, sizeof(samsungTV_IRcommands) / sizeof(samsungTV_IRcommands[0]));
 
   // GC also works well
   //register_command(&SAMSUNG_POWER_TOGGLE      , makeCommandData(IR, {std::to_string(IR_PROTOCOL_GLOBALCACHE), "38000,1,1,170,170,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,20,20,63,20,63,20,63,20,20,20,20,20,20,20,20,20,20,20,20,20,63,20,20,20,20,20,20,20,20,20,20,20,20,20,63,20,20,20,63,20,63,20,63,20,63,20,63,20,63,20,1798"}));
@@ -1,6 +1,6 @@
 #pragma once
 
-// Only activate the commands that are used. Every command takes 100 bytes, wether used or not.
+// Only activate the commands that are used. Every registered command takes some RAM in the command list, wether used or not.
 // extern uint16_t SAMSUNG_POWER_TOGGLE;
 // extern uint16_t SAMSUNG_SOURCE;
 // extern uint16_t SAMSUNG_HDMI;
@@ -61,7 +61,7 @@ void register_device_keyboard_ble() {
   //register_command(&KEYBOARD_BLE_LEFT_NVIDIASHIELD   , makeCommandData(BLE_KEYBOARD, {"77:88:99:aa:bb:cc", std::to_string(KEYBOARD_BLE_LEFT)}));
 }
 
-void keyboard_ble_executeCommand(uint16_t command, std::list<std::string> commandPayloads, std::string additionalPayload) {
+void keyboard_ble_executeCommand(uint16_t command, const std::list<std::string> &commandPayloads, const std::string &additionalPayload) {
   bool doLog = false;
 
   // in the commandPayloads, we either have
@@ -69,21 +69,22 @@ void keyboard_ble_executeCommand(uint16_t command, std::list<std::string> comman
   // b) or the address of the device this command has to be sent to, and the command that shall be sent
 
   // look if an explicit address was provided
-  std::string address = "";
+  static const std::string noAddress = "";
+  const std::string *address = &noAddress;
   uint16_t commandToBeSent;
   if (commandPayloads.size() == 2) {
-    address = commandPayloads.front();
+    address = &commandPayloads.front();
     commandToBeSent = std::stoi(commandPayloads.back());
   } else {
     commandToBeSent = command;
   }
   omote_log_v("  command          : %d\r\n", command);
   omote_log_v("  commandToBeSent  : %d\r\n", commandToBeSent);
-  omote_log_v("  address          : %s\r\n", address.c_str());
+  omote_log_v("  address          : %s\r\n", address->c_str());
   omote_log_v("  additionalPayload: %s\r\n", additionalPayload.c_str());
 
   // connect to a specific address, and ensure that there is a connection
-  if (!keyboardBLE_forceConnectionToAddress(address)) {
+  if (!keyboardBLE_forceConnectionToAddress(*address)) {
     omote_log_w("BLE keyboard could not be connected, cannot send key\r\n");
     return;
   }
@@ -111,7 +112,7 @@ void keyboard_ble_executeCommand(uint16_t command, std::list<std::string> comman
   } else if (commandToBeSent == KEYBOARD_BLE_SENDSTRING) {
     if (doLog) {omote_log_d("SENDSTRING received\r\n");}
     if (additionalPayload != "") {
-      keyboardBLE_sendString(additionalPayload.c_str());
+      keyboardBLE_sendString(additionalPayload);
     }
 
 
@@ -36,6 +36,6 @@ extern uint16_t KEYBOARD_BLE_RIGHT_FIRETV;
 extern uint16_t KEYBOARD_BLE_LEFT_NVIDIASHIELD;
 
 void register_device_keyboard_ble();
-void keyboard_ble_executeCommand(uint16_t command, std::list<std::string> commandPayloads, std::string additionalPayload = "");
+void keyboard_ble_executeCommand(uint16_t command, const std::list<std::string> &commandPayloads, const std::string &additionalPayload = "");
 
 #endif
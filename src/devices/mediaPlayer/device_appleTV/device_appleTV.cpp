@@ -24,25 +24,31 @@ uint16_t APPLETV_HOME;
 uint16_t APPLETV_POWER_ON;
 uint16_t APPLETV_POWER_OFF;
 
+static const uint16_t appleTV_powerOn_GC[]  = {38380,1,69,347,173,22,65,22,22,22,65,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,22,22,22,22,22,22,22,22,65,22,22,22,22,22,65,22,65,22,22,22,65,22,22,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,65,22,1397,347,87,22,3692};
+static const uint16_t appleTV_powerOff_GC[] = {38380,1,69,347,173,22,65,22,22,22,65,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,22,22,22,22,22,22,22,22,65,22,22,22,65,22,22,22,65,22,22,22,65,22,22,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,65,22,1397,347,87,22,3692};
+
 void register_device_appleTV() {
-  register_command(&APPLETV_UP                   , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E15080"}));
-  register_command(&APPLETV_DOWN                 , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E13080"}));
-  register_command(&APPLETV_LEFT                 , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E19080"}));
-  register_command(&APPLETV_RIGHT                , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E16080"}));
-  register_command(&APPLETV_OK                   , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E13A80"}));
+  static const IRcommandTableEntry appleTV_IRcommands[] = {
+    {&APPLETV_UP                   , IR_PROTOCOL_NEC, 0x77E15080},
+    {&APPLETV_DOWN                 , IR_PROTOCOL_NEC, 0x77E13080},
+    {&APPLETV_LEFT                 , IR_PROTOCOL_NEC, 0x77E19080},
+    {&APPLETV_RIGHT                , IR_PROTOCOL_NEC, 0x77E16080},
+    {&APPLETV_OK                   , IR_PROTOCOL_NEC, 0x77E13A80},
 
-  register_command(&APPLETV_PLAY                 , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E1FA80"})); 
-  register_command(&APPLETV_PAUSE                , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0xA7E14C80:32:1"})); // Code + kNECBits + 1 repeat
+    {&APPLETV_PLAY                 , IR_PROTOCOL_NEC, 0x77E1FA80},
+    {&APPLETV_PAUSE                , IR_PROTOCOL_NEC, 0xA7E14C80, kNECBits, 1}, // Code + kNECBits + 1 repeat
 
-  register_command(&APPLETV_10_SECOND_BACK       , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0xA7E16480:32:1"})); // Code + kNECBits + 1 repeat
-  register_command(&APPLETV_10_SECOND_FOREWARD   , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0xA7E11080:32:1"})); // Code + kNECBits + 1 repeat
+    {&APPLETV_10_SECOND_BACK       , IR_PROTOCOL_NEC, 0xA7E16480, kNECBits, 1}, // Code + kNECBits + 1 repeat
+    {&APPLETV_10_SECOND_FOREWARD   , IR_PROTOCOL_NEC, 0xA7E11080, kNECBits, 1}, // Code + kNECBits + 1 repeat
 
-  register_command(&APPLETV_NEXT                 , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0xA7E1C480:32:1"})); // Code + kNECBits + 1 repeat
-  register_command(&APPLETV_PREVIOUS             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0xA7E1A480:32:1"})); // Code + kNECBits + 1 repeat
+    {&APPLETV_NEXT                 , IR_PROTOCOL_NEC, 0xA7E1C480, kNECBits, 1}, // Code + kNECBits + 1 repeat
+    {&APPLETV_PREVIOUS             , IR_PROTOCOL_NEC, 0xA7E1A480, kNECBits, 1}, // Code + kNECBits + 1 repeat
   
-  register_command(&APPLETV_MENU                 , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0x77E1C080"}));
-  register_command(&APPLETV_HOME                 , makeCommandData(IR, {std::to_string(IR_PROTOCOL_NEC), "0xA7E10280:32:1"})); // Code + kNECBits + 1 repeat
+    {&APPLETV_MENU                 , IR_PROTOCOL_NEC, 0x77E1C080},
+    {&APPLETV_HOME                 , IR_PROTOCOL_NEC, 0xA7E10280, kNECBits, 1}, // Code + kNECBits + 1 repeat
 
-  register_command(&APPLETV_POWER_ON             , makeCommandData(IR, {std::to_string(IR_PROTOCOL_GLOBALCACHE), "38380,1,69,347,173,22,65,22,22,22,65,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,22,22,22,22,22,22,22,22,65,22,22,22,22,22,65,22,65,22,22,22,65,22,22,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,65,22,1397,347,87,22,3692"}));
-  register_command(&APPLETV_POWER_OFF            , makeCommandData(IR, {std::to_string(IR_PROTOCOL_GLOBALCACHE), "38380,1,69,347,173,22,65,22,22,22,65,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,22,22,22,22,22,22,22,22,65,22,22,22,65,22,22,22,65,22,22,22,65,22,22,22,22,22,22,22,65,22,65,22,65,22,65,22,65,22,65,22,65,22,1397,347,87,22,3692"}));
+    {&APPLETV_POWER_ON             , IR_PROTOCOL_GLOBALCACHE, 0, 0, 0, appleTV_powerOn_GC,  sizeof(appleTV_powerOn_GC)  / sizeof(uint16_t)},
+    {&APPLETV_POWER_OFF            , IR_PROTOCOL_GLOBALCACHE, 0, 0, 0, appleTV_powerOff_GC, sizeof(appleTV_powerOff_GC) / sizeof(uint16_t)},
+  };
+  register_IRcommandTable(appleTV_IRcommands, sizeof(appleTV_IRcommands) / sizeof(appleTV_IRcommands[0]));
 }
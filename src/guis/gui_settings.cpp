@@ -1,6 +1,7 @@
 #include <lvgl.h>
 #include "applicationInternal/hardware/hardwarePresenter.h"
 #include "applicationInternal/memoryUsage.h"
+#include "applicationInternal/frameStatistics.h"
 #include "applicationInternal/gui/guiBase.h"
 #include "applicationInternal/gui/guiRegistry.h"
 #include "applicationInternal/omote_log.h"
@@ -76,6 +77,11 @@ static void showMemoryUsage_event_cb(lv_event_t* e) {
   setShowMemoryUsage(lv_obj_has_state(lv_event_get_target(e), LV_STATE_CHECKED));
 }
 
+// show frame statistics event handler
+static void showFrameStatistics_event_cb(lv_event_t* e) {
+  setShowFrameStatistics(lv_obj_has_state(lv_event_get_target(e), LV_STATE_CHECKED));
+}
+
 void create_tab_content_settings(lv_obj_t* tab) {
 
   // Add content to the settings tab
@@ -257,7 +263,7 @@ void create_tab_content_settings(lv_obj_t* tab) {
   menuLabel = lv_label_create(tab);
   lv_label_set_text(menuLabel, "Memory usage");
   menuBox = lv_obj_create(tab);
-  lv_obj_set_size(menuBox, lv_pct(100), 48);
+  lv_obj_set_size(menuBox, lv_pct(100), 80);
   lv_obj_set_style_bg_color(menuBox, color_primary, LV_PART_MAIN);
   lv_obj_set_style_border_width(menuBox, 0, LV_PART_MAIN);
   
@@ -274,6 +280,18 @@ void create_tab_content_settings(lv_obj_t* tab) {
   } else {
     // lv_obj_clear_state(memoryUsageToggle, LV_STATE_CHECKED);
   }
+
+  menuLabel = lv_label_create(menuBox);
+  lv_label_set_text(menuLabel, "Show frame stats");
+  lv_obj_align(menuLabel, LV_ALIGN_TOP_LEFT, 0, 32 +3);
+  lv_obj_t* frameStatisticsToggle = lv_switch_create(menuBox);
+  lv_obj_set_size(frameStatisticsToggle, 40, 22);
+  lv_obj_align(frameStatisticsToggle, LV_ALIGN_TOP_RIGHT, 0, 32);
+  lv_obj_set_style_bg_color(frameStatisticsToggle, lv_color_hex(0x505050), LV_PART_MAIN);
+  lv_obj_add_event_cb(frameStatisticsToggle, showFrameStatistics_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+  if (getShowFrameStatistics()) {
+    lv_obj_add_state(frameStatisticsToggle, LV_STATE_CHECKED);
+  }
 }
 
 void notify_tab_before_delete_settings(void) {
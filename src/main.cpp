@@ -54,27 +54,47 @@
 #include "scenes/scene_chromecast.h"
 #include "scenes/scene_appleTV.h"
 #include "applicationInternal/scenes/sceneHandler.h"
+#include "applicationInternal/scenes/sceneSequencer.h"
+// schedule the tasks of the main loop
+#include "applicationInternal/scheduler.h"
+// fast wakeup from deep sleep
+#include "applicationInternal/wakeSnapshot.h"
+// how long each phase of the startup takes
+#include "applicationInternal/bootProfile.h"
+// optional split of the main loop into tasks
+#include "applicationInternal/taskSplit.h"
+// self tests, only in the headless simulator
+#include "applicationInternal/selfTests/selfTests.h"
 
 #if defined(ARDUINO)
 // in case of Arduino we have a setup() and a loop()
+void register_loopTasks();
 void setup() {
 
 #elif defined(WIN32) || defined(__linux__) || defined(__APPLE__)
 // in case of Windows/Linux, we have only a main() function, no setup() and loop(), so we have to simulate them
-// forward declaration of loop()
-void loop(unsigned long *pIMUTaskTimer, unsigned long *pUpdateStatusTimer);
+// forward declarations
+void register_loopTasks();
+void loop();
 // main function as usual in C
 int main(int argc, char *argv[]) {
 #endif
 
   // --- Startup ---
+  // Only what the first frame and the first key press need is done here. BLE keyboard and WiFi follow in the deferredInit task, see register_loopTasks().
+  bootProfile_start();
   Serial.begin(115200);
   // do some general hardware setup, like powering the TFT, I2C, ...
   init_hardware_general();
+  bootProfile_phaseDone("hardware general");
   // get wakeup reason
   init_sleep();
-  // Restore settings from internal flash memory
-  init_preferences();
+  bootProfile_phaseDone("sleep, wakeup key");
+  // Restore settings. After wakeup from deep sleep from the snapshot in RTC memory, otherwise from internal flash memory
+  if (!wakeSnapshot_restore()) {
+    init_preferences();
+  }
+  bootProfile_phaseDone("preferences");
   // blinking led
   init_userled();
   // startup SD card
@@ -85,6 +105,7 @@ int main(int argc, char *argv[]) {
 
   // setup IR sender
   init_infraredSender();
+  bootProfile_phaseDone("user led, IR sender");
 
   // register commands for the devices
   register_specialCommands();
@@ -113,6 +134,7 @@ int main(int argc, char *argv[]) {
   register_device_keyboard_ble();
   #endif
   register_keyboardCommands();
+  bootProfile_phaseDone("register devices");
 
   // Register the GUIs. They will be displayed in the order they have been registered.
   register_gui_sceneSelection();
@@ -135,6 +157,7 @@ int main(int argc, char *argv[]) {
     #endif
     };
   #endif
+  bootProfile_phaseDone("register GUIs");
 
   // register the scenes and their key_commands_*
   register_scene_defaultKeys();
@@ -145,89 +168,144 @@ int main(int argc, char *argv[]) {
   register_scene_allOff();
   // Only show these scenes on the sceneSelection gui. If you don't set this explicitely, by default all registered scenes are shown.
   set_scenes_on_sceneSelectionGUI({scene_name_TV, scene_name_fireTV, scene_name_chromecast, scene_name_appleTV});
+  bootProfile_phaseDone("register scenes");
 
   // init GUI - will initialize tft, touch and lvgl
   init_gui(); // This has to come before any other i2c devices are initialized, otherwise the i2c bus will not be powered
   setLabelActiveScene();
+  bootProfile_phaseDone("init GUI");
   gui_loop(); // Run the LVGL UI once before the loop takes over
-  
-  // Power Pin and battery monitor definition
-  init_battery();
+  bootProfile_phaseDone("first frame");
 
-  // init BLE keyboard. Has to be after init_gui (because of powered I2C) and after init_battery (because of fuel gauge init)
-  #if (ENABLE_KEYBOARD_BLE == 1)
-  init_keyboardBLE();
-  #endif
-
-  // setup keyboard matrix driver
+  // setup keyboard matrix driver. Has to be after init_gui(), otherwise I2C will not work (OMOTE_HARDWARE_REV >= 5)
   init_keys();
+  bootProfile_phaseDone("keys");
+
+  // Power Pin and battery monitor definition
+  init_battery();
 
   // setup the Inertial Measurement Unit (IMU) for motion detection. Has to be after init_gui(), otherwise I2C will not work
   init_IMU();
+  bootProfile_phaseDone("battery, IMU");
 
-  // init WiFi - needs to be after init_gui() because WifiLabel must be available
-  #if (ENABLE_WIFI_AND_MQTT == 1)
-  init_mqtt();
+  #if (ENABLE_SELFTESTS == 1)
+  // the tests register commands of their own
+  register_selfTests();
   #endif
 
+  // From now on, IR and BLE keyboard commands are executed by a separate worker. Has to be the last step, because no commands must be registered after this.
+  // BLE keyboard and WiFi are initialized later by the deferredInit task, but they don't register commands.
+  init_commandQueue();
+
+  // register what has to be done in the main loop, and how often
+  register_loopTasks();
+  bootProfile_phaseDone("command queue, loop tasks");
+
   omote_log_i("Setup finished in %lu ms.\r\n", millis());
 
   #if defined(WIN32) || defined(__linux__) || defined(__APPLE__)
   // In Windows/Linux there is no loop function that is automatically being called. So we have to do this on our own infinitely here in main()
-  unsigned long IMUTaskTimer = 0;
-  unsigned long updateStatusTimer = 0;
-  while (1)
-    loop(&IMUTaskTimer, &updateStatusTimer);
+  while (1) {
+    // advances the virtual clock, if it is used
+    clock_loop();
+    loop();
+  }
   #endif
 
 }
 
 // Loop ------------------------------------------------------------------------------------------------------------------------------------
-#if defined(ARDUINO)
-unsigned long IMUTaskTimer = 0;
-unsigned long updateStatusTimer = 0;
-unsigned long *pIMUTaskTimer = &IMUTaskTimer;
-unsigned long *pUpdateStatusTimer = &updateStatusTimer;
-void loop() {
-#elif defined(WIN32) || defined(__linux__) || defined(__APPLE__)
-void loop(unsigned long *pIMUTaskTimer, unsigned long *pUpdateStatusTimer) {
-#endif
+// process IR receiver, if activated
+unsigned long infraredReceiverLastRun = 0;
+void infraredReceiver_task() {
+  infraredReceiverLastRun = millis();
+  infraredReceiver_loop();
+}
+// Every 10 ms while the IR receiver is activated. Otherwise it doesn't keep the loop from sleeping.
+uint32_t infraredReceiver_timeTillNextRun() {
+  if (!get_irReceiverEnabled()) {
+    return SCHEDULER_NO_DEADLINE;
+  }
+  unsigned long elapsed = millis() - infraredReceiverLastRun;
+  return (elapsed >= 10) ? 0 : 10 - elapsed;
+}
 
-  // --- do as often as possible --------------------------------------------------------
-  // update backlight and keyboard brightness. Fade in on startup, dim before going to sleep
+// Refresh IMU data (motion detection)
+// If no action (key, TFT or motion), then go to sleep
+void activity_task() {
+  check_activity();
+  // update the target of backlight and keyboard brightness. Fade in on startup, dim before going to sleep.
+  // The fades themselves run in hardware, so this is only needed when the target could have changed.
   update_backlightBrightness();
   #if(OMOTE_HARDWARE_REV >= 5)
     update_keyboardBrightness();
   #endif
-  // keypad handling: get key states from hardware and process them
-  keypad_loop();
-  // process IR receiver, if activated
-  if (get_irReceiverEnabled()) {
-    infraredReceiver_loop();
-  }
-  // update LVGL UI
-  gui_loop();
-  // call mqtt loop to receive mqtt messages, if you are subscribed to some topics
+}
+
+// Everything that is not needed for the first frame and the first key press. One phase per pass of the scheduler, so that keys and GUI already work in between.
+// The boot profile is logged when all phases are done.
+struct deferredInitPhase {
+  const char *name;
+  void (*init)(void);
+};
+const deferredInitPhase deferredInitPhases[] = {
+  // init BLE keyboard. Has to be after init_gui (because of powered I2C) and after init_battery (because of fuel gauge init)
+  #if (ENABLE_KEYBOARD_BLE == 1)
+  {"BLE keyboard", &init_keyboardBLE},
+  #endif
+  // init WiFi - needs to be after init_gui() because WifiLabel must be available
   #if (ENABLE_WIFI_AND_MQTT == 1)
-  mqtt_loop();
+  {"WiFi, mqtt", &init_mqtt},
   #endif
-
-  // --- every 100 ms -------------------------------------------------------------------
-  // Refresh IMU data (motion detection) every 100 ms
-  // If no action (key, TFT or motion), then go to sleep
-  if(millis() - *pIMUTaskTimer >= 100){
-    *pIMUTaskTimer = millis();
-
-    check_activity();
-
+  {NULL, NULL}
+};
+uint8_t nextDeferredInitPhase = 0;
+bool deferredInitDone = false;
+void deferredInit_task() {
+  const deferredInitPhase &phase = deferredInitPhases[nextDeferredInitPhase];
+  if (phase.init != NULL) {
+    unsigned long start = micros();
+    phase.init();
+    bootProfile_deferredPhaseDone(phase.name, start);
+    nextDeferredInitPhase++;
   }
-
-  // --- every 1000 ms ------------------------------------------------------------------
-  if(millis() - *pUpdateStatusTimer >= 1000) {
-    *pUpdateStatusTimer = millis();
-
-    // update user_led, battery, BLE, memoryUsage on GUI
-    updateHardwareStatusAndShowOnGUI();
+  if (deferredInitPhases[nextDeferredInitPhase].init == NULL) {
+    deferredInitDone = true;
+    bootProfile_print();
   }
+}
+uint32_t deferredInit_timeTillNextPhase() {
+  return deferredInitDone ? SCHEDULER_NO_DEADLINE : 0;
+}
 
+void register_loopTasks() {
+  // keypad handling: get key states from hardware and process them. Only polled while a key is pressed, if the keypad signals new events.
+  uint8_t keypadTaskId =
+  scheduler_addTask("keypad",     &keypad_loop,               SCHEDULER_NO_PERIOD, &keypad_timeTillNextPoll);
+  // execute the next step of a scene start or end sequence, when it is due
+  scheduler_addTask("sequencer",  &sceneSequencer_loop,       SCHEDULER_NO_PERIOD, &sceneSequencer_timeTillNextStep);
+  scheduler_addTask("irReceiver", &infraredReceiver_task,     SCHEDULER_NO_PERIOD, &infraredReceiver_timeTillNextRun);
+  // update LVGL UI, when the next lvgl timer is due
+  scheduler_addTask("gui",        &gui_loop,                  SCHEDULER_NO_PERIOD, &gui_getTimeTillNextTimer);
+  // call mqtt loop to receive mqtt messages, if you are subscribed to some topics. With ENABLE_TASK_SPLIT=1 done by the connectivity task.
+  #if (ENABLE_WIFI_AND_MQTT == 1) && (ENABLE_TASK_SPLIT != 1)
+  scheduler_addTask("mqtt",       &mqtt_loop,                 10);
+  #endif
+  scheduler_addTask("activity",   &activity_task,             100);
+  // update user_led, battery, BLE, memoryUsage, frameStatistics on GUI, log the energy model
+  scheduler_addTask("status",     &updateHardwareStatusAndShowOnGUI, 1000);
+  #if (ENABLE_TASK_SPLIT == 1)
+  // input and connectivity get tasks of their own. The rest of the startup is done by the connectivity task.
+  start_taskSplit(keypadTaskId, &deferredInit_task, &deferredInit_timeTillNextPhase);
+  #else
+  (void)keypadTaskId;
+  // the rest of the startup, after all other tasks had their first run
+  scheduler_addTask("deferredInit", &deferredInit_task,       SCHEDULER_NO_PERIOD, &deferredInit_timeTillNextPhase);
+  #endif
+}
+
+void loop() {
+  uint32_t timeTillNextDeadline = scheduler_loop();
+  // Don't spin when there is nothing to do. ESP32: light sleep, if possible. Simulator: saves the CPU of the host.
+  idle(timeTillNextDeadline);
 }